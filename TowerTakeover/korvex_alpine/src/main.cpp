@@ -1,5 +1,6 @@
 #include "main.h"
 #include "korvexlib.h"
+#include "loopTimer.hpp"
 #include "okapi/api.hpp"
 
 /**
@@ -216,6 +217,8 @@ void driveP(int voltageMax) {
   int same0ErrCycles = 0;
   pros::delay(20); // dunno
 
+  LoopTimer timer(20, "driveP"); // runs the loop every 20ms on the dot
+
   while(autonomous){
     errorLeft = targetLeft - chassisLeftBack.get_position(); // error is target minus actual value
     errorRight = targetRight - chassisRightBack.get_position();
@@ -272,6 +275,7 @@ void driveP(int voltageMax) {
 		chassisRightFront.move_velocity(0);
 		chassisRightBack.move_velocity(0);
 		std::cout << "task complete with error " << errorCurrent << std::endl;
+		timer.report();
 		return;
 	}
 	
@@ -283,7 +287,7 @@ void driveP(int voltageMax) {
 
 	// nothing goes after this
 	errorLast = errorCurrent;
-    pros::delay(20);
+    timer.wait();
   }
 }
 
@@ -317,6 +321,8 @@ void turnP(int voltageMax) {
   double error;
   pros::delay(20); // dunno
 
+  LoopTimer timer(10, "turnP"); // runs the loop every 10ms on the dot
+
   while(autonomous){
     error = targetTurn - imu.get_rotation();
 	errorCurrent = abs(error);
@@ -325,10 +331,10 @@ void turnP(int voltageMax) {
 
 	p = (error * kp);
 	if (abs(error) < 10) // if we are in range for I to be desireable
-        i = ((i + error) * ki);
+        i = ((i + error * timer.ticks()) * ki);
       else
         i = 0;
-	d = (error - errorLast) * kd;
+	d = (error - errorLast) / timer.ticks() * kd;
 	
 	voltage = p + i + d;
 	voltageCap = voltageCap + acc;  // slew rate
@@ -366,6 +372,7 @@ void turnP(int voltageMax) {
 		chassisRightFront.move_velocity(0);
 		chassisRightBack.move_velocity(0);
 		std::cout << "task complete with error " << errorCurrent << std::endl;
+		timer.report();
 		return;
 	}
 	
@@ -378,7 +385,7 @@ void turnP(int voltageMax) {
 	// nothing goes after this
 	errorLast = errorCurrent;
 	errorLastInt = errorLast;
-    pros::delay(10);
+    timer.wait();
   }
 }
 
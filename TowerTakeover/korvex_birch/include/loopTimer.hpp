@@ -0,0 +1,61 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include "api.h"
+
+// keeps a motion loop on an exact period, call wait() where the pros::delay() used to be
+// pros::delay(20) after a loop that took 3ms is really a 23ms loop, delay_until counts from the last wake up instead
+// ticks() is how many periods really went by since the last wait, 1 when on time, so the d and i terms can use
+// (error - errorLast) / ticks and error * ticks and keep the gains they were tuned with
+
+class LoopTimer {
+	public:
+	explicit LoopTimer(std::uint32_t iperiod, const char *iname = "loop")
+		: period(iperiod), name(iname), wake(pros::millis()), last(wake) {
+	}
+
+	// sleep until the next period starts, if we're already past it count an overrun and go right away
+	void wait() {
+		std::uint32_t now = pros::millis();
+		if (now - wake >= period) {
+			overruns++;
+			worst = std::max(worst, now - last);
+			wake = now; // start counting again from here instead of rushing to catch up
+		}
+		else pros::Task::delay_until(&wake, period);
+		now = pros::millis();
+		dtMs = now - last;
+		last = now;
+		loops++;
+	}
+
+	// periods since the last wait, exactly 1 unless a loop ran long
+	double ticks() const {
+		return double(dtMs) / period;
+	}
+
+	// seconds since the last wait
+	double dt() const {
+		return dtMs / 1000.0;
+	}
+
+	std::uint32_t getOverruns() const {
+		return overruns;
+	}
+
+	// only says something when there's something to say
+	void report() const {
+		if (overruns) std::cout << pros::millis() << ": " << name << " overran " << overruns << " of " << loops << " loops, worst " << worst << "ms" << std::endl;
+	}
+
+	private:
+	const std::uint32_t period; // ms
+	const char *name;
+	std::uint32_t wake; // when the current period started
+	std::uint32_t last; // when the last wait returned
+	std::uint32_t dtMs = period; // the first loop counts as on time
+	std::uint32_t loops = 0;
+	std::uint32_t overruns = 0;
+	std::uint32_t worst = 0; // ms, longest loop that overran
+};
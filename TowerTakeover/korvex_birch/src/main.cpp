@@ -1,6 +1,7 @@
 #include <fstream>
 #include "main.h"
 #include "korvexlib.h"
+#include "loopTimer.hpp"
 
 // chassis
 auto chassis = ChassisControllerBuilder()
@@ -103,6 +104,8 @@ void driveP(int voltageMax, bool debugLog=false) {
 	targetLeft = targetLeft + chassis->getModel()->getSensorVals()[0];
 	targetRight = targetRight + chassis->getModel()->getSensorVals()[1];
 
+	LoopTimer timer(20, "driveP"); // runs the loop every 20ms on the dot
+
 	while(autonomous){
 		errorLeft = targetLeft - chassis->getModel()->getSensorVals()[0]; // error is target minus actual value
 		errorRight = targetRight - chassis->getModel()->getSensorVals()[1];
@@ -153,6 +156,7 @@ void driveP(int voltageMax, bool debugLog=false) {
 		if ((errorLast < 5 and errorCurrent < 5) or sameErrCycles >= 10) { // allowing for smol error or exit if we stay the same err for .2 second
 			chassis->stop();
 			std::cout << "task complete with error " << errorCurrent << " in " << (pros::millis() - startTime) << "ms" << std::endl;
+			timer.report();
 			return;
 		}
 		
@@ -167,7 +171,7 @@ void driveP(int voltageMax, bool debugLog=false) {
 
 		// nothing goes after this
 		errorLast = errorCurrent;
-		pros::delay(20);
+		timer.wait();
 	}
 }
 
@@ -200,6 +204,8 @@ void turnP(int voltageMax, bool csvOut=false) {
 	float error;
 	int startTime = pros::millis();
 
+	LoopTimer timer(10, "turnP"); // runs the loop every 10ms on the dot
+
 	while(autonomous) {
 		error = targetTurn - imu.get_rotation();
 		errorCurrent = abs(error);
@@ -208,11 +214,11 @@ void turnP(int voltageMax, bool csvOut=false) {
 
 		p = (error * kp);
 		if (abs(error) < 10) { // if we are in range for I to be desireable
-			i = ((i + error) * ki);
+			i = ((i + error * timer.ticks()) * ki);
 		}
 		else
 			i = 0;
-		d = (error - errorLast) * kd;
+		d = (error - errorLast) / timer.ticks() * kd;
 		
 		voltage = p + i + d;
 
@@ -237,6 +243,7 @@ void turnP(int voltageMax, bool csvOut=false) {
 		if (same0ErrCycles >= 5 or sameErrCycles >= 60) { // allowing for smol error or exit if we stay the same err for .6 second
 			chassis->stop();
 			std::cout << "task complete with error " << errorCurrent << " in " << (pros::millis() - startTime) << "ms" << std::endl;
+			timer.report();
 			return;
 		}
 		
@@ -250,7 +257,7 @@ void turnP(int voltageMax, bool csvOut=false) {
 		// nothing goes after this
 		errorLast = errorCurrent;
 		errorLastInt = errorLast;
-		pros::delay(10);
+		timer.wait();
 	}
 }
 
@@ -0,0 +1,63 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include "api.h"
+#include "okapi/api.hpp"
+
+// running a motion function in its own task so the auton can run the intake/lift/tray while the robot drives
+// auto move = driveQAsync(42_in, 24_in);
+// move.waitUntilProgress(0.7);
+// trayMotor.moveAbsolute(3000, 80);
+// move.waitUntilSettled();
+
+// how far along a move is, every motion function keeps one of these up to date
+struct MotionStatus {
+	std::atomic<float> travelled{0}; // cm driven or deg turned since this part of the move started
+	std::atomic<float> total{0}; // cm or deg this part of the move covers
+	std::atomic<bool> driving{false}; // false while turning on the spot
+	std::atomic<bool> settled{false};
+	std::atomic<bool> cancelled{false};
+
+	// called by a motion function before its loop, driveTo is a turn then a drive so it starts twice
+	void begin(float itotal, bool idriving);
+};
+
+// the status the calling motion function should report to
+// an async move's task gets its handle's status, a plain blocking call gets one nobody is looking at
+MotionStatus &motionStatus();
+
+class AsyncMotion {
+	public:
+	// starts imove in its own task, a move still running from before gets cancelled first since there's one chassis
+	// idriving says which part of the move the progress/distance waits look at, the drive or the turn
+	// if there are already as many unfinished moves as it can keep track of it doesn't start, and comes back settled and cancelled
+	explicit AsyncMotion(std::function<void()> imove, bool idriving = true);
+
+	bool isSettled() const;
+
+	// 0 to 1 through the part of the move idriving picked, 1 once it's settled
+	float getProgress() const;
+
+	void waitUntilSettled() const;
+
+	// returns once the move is ifraction of the way there, or settled
+	void waitUntilProgress(float ifraction) const;
+
+	// returns once the robot has driven idistance since the drive started, or the move settled
+	void waitUntilDistance(okapi::QLength idistance) const;
+
+	// stop the move where it is, the motion function exits on its next loop
+	void cancel() const;
+
+	private:
+	std::shared_ptr<MotionStatus> status;
+	bool driving;
+};
+
+// cancels every async move still running and returns once their tasks are done with the chassis
+// autonomous ending doesn't stop an async move's task, so opcontrol and disabled call this first
+void cancelAsyncMotion();
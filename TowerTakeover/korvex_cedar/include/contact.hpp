@@ -0,0 +1,49 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "poseEkf.hpp"
+
+// notices when the drive and the ground stop agreeing, the odom task runs it on every reading
+// slip:      a side's drive motors turning faster or slower than the tracking wheels say the ground under them is going,
+//            for slipTime. wheelspin pushing on a stack or a wall, or getting shoved
+// collision: the robot lost more speed in one update than the tires can brake, by the imu's accelerometer or the
+//            tracking wheels, whichever saw more
+// stopped:   the tracking wheels haven't moved for stopTime, after a collision that means we're up against whatever we hit
+// like PoseEkf nothing in here touches pros
+
+struct ContactConfig {
+	float slipSpeed = 20; // cm/s between a side's motors and the ground under it
+	int slipTime = 50; // ms
+	float collisionAccel = 1.5; // g, the tires only grip to about 1
+	float stopSpeed = 3; // cm/s at each tracking wheel
+	int stopTime = 60; // ms
+};
+
+struct ContactState {
+	bool slipLeft = false;
+	bool slipRight = false;
+	bool stopped = false;
+	std::uint32_t collisions = 0; // one more every hit, so a move can tell if there's been one since it started
+	std::uint32_t collisionTime = 0; // ms of the last one
+	float impact = 0; // g of the last one
+};
+
+class ContactDetector {
+	public:
+	ContactDetector(const EkfConfig &iodom, const ContactConfig &iconfig);
+
+	void update(const OdomReading &ireading);
+
+	ContactState getState() const;
+
+	private:
+	EkfConfig odom; // for where the wheels are and how far a tick is
+	ContactConfig config;
+	ContactState state;
+	OdomReading last{};
+	bool primed = false;
+	float lastForward = 0; // cm/s from the tracking wheels
+	bool hitting = false; // still over collisionAccel from the last hit, it only counts once
+	std::array<std::uint32_t, 2> slipSince{}; // ms each side started disagreeing, 0 while they agree
+	std::uint32_t stoppedSince = 0; // ms, 0 while moving
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "api.h"
+#include "okapi/api.hpp"
+
+// the line sensor on the tray in its own task, every 5ms through a median of 3 and a hysteresis band around 46000
+// instead of 20 odd while loops each polling it every 20ms (some every 200) against their own copy of 46000
+// a task that needs a cube somewhere blocks in waitUntilCovered/waitUntilUncovered and gets woken by a task
+// notification on the edge, so it reacts within one 5ms sample instead of whenever its next delay(20) ends
+// the ADI itself only refreshes every 10ms on the brain, so 5ms is catching every new value as soon as it's there
+// covered means a cube is over the sensor, the reading drops
+
+class CubeSensor {
+	public:
+	// ithreshold is where covered and uncovered meet, the reading has to get ihysteresis/2 past it either way to change
+	CubeSensor(pros::ADIAnalogIn &iline, std::int32_t ithreshold = 46000, std::int32_t ihysteresis = 2000);
+
+	// starts the task, call after line.calibrate()
+	void start(std::uint32_t iperiod = 5);
+
+	bool isCovered() const;
+	double getValue() const; // the filtered reading, calibrated hr
+	std::uint32_t getEdgeTime() const; // ms of the last time it flipped
+
+	// block till a cube is (or isn't) over the sensor, right away if it already is
+	// true if it got there, false if itimeout ms went by first
+	bool waitUntilCovered(std::uint32_t itimeout);
+	bool waitUntilUncovered(std::uint32_t itimeout);
+
+	private:
+	static void loop(void *isensor);
+	void step();
+	bool waitUntil(bool icovered, std::uint32_t itimeout);
+
+	pros::ADIAnalogIn &line;
+	std::int32_t threshold;
+	std::int32_t hysteresis;
+	std::uint32_t period = 5;
+	bool started = false;
+	okapi::MedianFilter<3> filter; // only the task touches it
+
+	std::atomic<bool> covered{false};
+	std::atomic<double> value{0};
+	std::atomic<std::uint32_t> edgeTime{0};
+	// tasks blocked in waitUntil, the sensor task notifies all of them on every edge and they check if it's theirs
+	std::array<std::atomic<pros::task_t>, 4> waiters{};
+};
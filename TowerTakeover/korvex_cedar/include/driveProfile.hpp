@@ -0,0 +1,43 @@
+#pragma once
+#include <cmath>
+
+// velocity planning for the drive: a trapezoid (or s-curve) per move and the voltage it takes to follow it
+// units are cm, s and volts, the feedforward numbers come from the characterize auton, see sim/README.md
+
+// volts = kS * sign(v) + kV * v + kA * a, kS gets the drive moving, kV holds a speed, kA pushes the mass around
+struct Feedforward {
+	float kS; // V
+	float kV; // V per cm/s
+	float kA; // V per cm/s^2
+
+	float calculate(float ivelocity, float iacceleration) const {
+		if (ivelocity == 0 && iacceleration == 0) return 0;
+		const float direction = ivelocity != 0 ? ivelocity : iacceleration;
+		return std::copysign(kS, direction) + kV * ivelocity + kA * iacceleration;
+	}
+};
+
+// speed up at maxAccel, cruise at maxVelocity, slow down at maxAccel, ending stopped on idistance
+// a non zero maxJerk rounds the corners of the acceleration into an s-curve so the robot doesn't jolt (or wheelie)
+// short moves that can't reach maxVelocity just peak lower
+class TrapezoidProfile {
+	public:
+	TrapezoidProfile(float idistance, float imaxVelocity, float imaxAccel, float imaxJerk = 0);
+
+	struct State {
+		float position; // cm from the start
+		float velocity; // cm/s
+		float acceleration; // cm/s^2
+	};
+
+	// where the profile is at it s, clamped to the end after duration()
+	State sample(float it) const;
+
+	float duration() const; // s
+
+	private:
+	float sign; // the profile is worked out forwards and flipped for negative moves
+	float distance, velocity, accel; // magnitudes, velocity is the peak actually reached
+	float jerkTime; // s, how long the acceleration takes to ramp on or off, 0 for a plain trapezoid
+	float accelTime, cruiseTime; // s
+};
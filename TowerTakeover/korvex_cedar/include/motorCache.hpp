@@ -0,0 +1,94 @@
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include "api.h"
+#include "okapi/api.hpp"
+
+// sits in front of a motor (or group, or the chassis) and only sends what changed, once a loop
+// opcontrol used to set every brake mode and re-send the tray's moveAbsolute(600) every 20ms whether or not anything
+// was different, each of those is a packet on the smart port that the commands that matter wait behind
+// commands queue up till flush(), so if the loop asks for two things the motor only gets the last one, and one that's
+// the same as what the motor already has doesn't get sent at all
+// anything that drives the motor without going through here (flipout, an auton move) has to invalidate() after,
+// or we'll think the motor's still doing the last thing we sent it
+// what the motor has gets sent again every refresh ms regardless, so one that drops off and reconnects (and comes
+// back stopped) picks it up again without waiting for the driver to change something
+
+// how many commands got asked for and how many really went out
+struct WriteCount {
+	std::uint32_t asked = 0;
+	std::uint32_t sent = 0;
+
+	std::uint32_t saved() const {
+		return asked - sent;
+	}
+};
+
+class MotorCache {
+	public:
+	static constexpr std::uint32_t refresh = 100; // ms
+
+	MotorCache(okapi::AbstractMotor &imotor, const char *iname);
+
+	void moveVelocity(std::int16_t ivelocity);
+	void moveVoltage(std::int16_t ivoltage);
+	void moveAbsolute(double iposition, std::int32_t ivelocity);
+	void moveRelative(double iposition, std::int32_t ivelocity); // always goes out, it's a new move every time
+	void setBrakeMode(okapi::AbstractMotor::brakeMode imode);
+
+	// sends whatever's queued that the motor doesn't already have, once at the end of the loop
+	void flush();
+
+	// something else moved the motor, send the next command no matter what
+	void invalidate();
+
+	WriteCount getCount() const;
+	void print() const; // <ms>: writes <name> sent n saved n
+
+	private:
+	enum class Mode { none, velocity, voltage, absolute, relative };
+	struct Command {
+		Mode mode = Mode::none;
+		double target = 0; // rpm, mV or counts
+		std::int32_t velocity = 0; // for the position moves
+	};
+	static bool same(const Command &ia, const Command &ib);
+	void queue(const Command &icommand);
+	void send(const Command &icommand);
+
+	okapi::AbstractMotor &motor;
+	const char *name;
+	Command pending, sent;
+	bool movePending = false;
+	okapi::AbstractMotor::brakeMode pendingBrake = okapi::AbstractMotor::brakeMode::invalid;
+	okapi::AbstractMotor::brakeMode sentBrake = okapi::AbstractMotor::brakeMode::invalid;
+	std::uint32_t sentTime = 0; // ms of the last refresh
+	WriteCount count;
+};
+
+// the same for the drive, tank and brake mode are all opcontrol sends it
+class ChassisCache {
+	public:
+	ChassisCache(std::shared_ptr<okapi::ChassisModel> imodel, const char *iname);
+
+	void tank(double ileft, double iright);
+	void setBrakeMode(okapi::AbstractMotor::brakeMode imode);
+	void flush();
+	void invalidate();
+
+	WriteCount getCount() const;
+	void print() const;
+
+	private:
+	std::shared_ptr<okapi::ChassisModel> model;
+	const char *name;
+	double pendingLeft = 0, pendingRight = 0;
+	double sentLeft = 0, sentRight = 0;
+	bool tankPending = false;
+	bool tankSent = false; // false till the first tank, or after invalidate
+	okapi::AbstractMotor::brakeMode pendingBrake = okapi::AbstractMotor::brakeMode::invalid;
+	okapi::AbstractMotor::brakeMode sentBrake = okapi::AbstractMotor::brakeMode::invalid;
+	std::uint32_t sentTime = 0;
+	WriteCount count;
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+// extended kalman filter for where the robot is, fusing everything on cedar that knows anything about it
+// state is x y theta on the field (cm, cm, radians clockwise) and forward, sideways (cm/s) and angular (radians/s) velocity on the robot
+// predict: the imu's accelerometer pushes the velocities along, then the pose moves by them
+// update:  the three tracking wheels, both sides' drive motor encoders, the imu's rotation and its gyro
+// every measurement is one number with its own noise, fused one at a time, so there's no matrix to invert
+// nothing in here touches pros, so sim/tools/ekfreplay runs the exact same filter over a log on the computer
+
+// standard deviations, a noise of 0 leaves that sensor out
+// the two accelerations aren't sensors, they're how much the robot can do that the accelerometer doesn't see
+struct EkfNoise {
+	float acceleration = 400; // cm/s^2 the accelerometer misses, bumps and wheels grabbing
+	float angularAcceleration = 20; // radians/s^2
+	float trackingWheel = 0.03; // cm per update, a tick is 0.06cm
+	float driveWheel = 0.5; // cm per update, the drive wheels slip and scrub so they only really count if a tracking wheel stops making sense
+	float imuHeading = 0.005; // radians
+	float gyro = 0.5; // radians/s, loose, it reads the spin right now and the filter wants it averaged over the update
+	float gate = 4; // a drive motor reading this many standard deviations off is thrown out instead of fused, that's slip
+};
+
+// where the sensors are, cm from the middle of the robot, and how far a tick is
+struct EkfConfig {
+	float cmPerTick; // all three tracking wheels
+	float leftOffset; // cm right of the middle, so the left wheel is negative
+	float rightOffset;
+	float strafeOffset; // cm ahead of the middle, so behind is negative
+	float driveCmPerTick; // in whatever encoder units the drive motors are set to
+	float driveOffset; // cm from the middle to each side's drive wheels
+	EkfNoise noise;
+};
+
+// one update's worth of sensors, raw off the devices so a log of these replays exactly
+// the imu is mounted flat with x forward and y right, PROS_ERR_F (or anything not finite) means it didn't read
+struct OdomReading {
+	std::uint32_t time; // ms
+	std::int32_t left; // ticks
+	std::int32_t right;
+	std::int32_t strafe; // counts up going left
+	double driveLeft; // encoder units
+	double driveRight;
+	double rotation; // degrees clockwise
+	double gyro; // degrees/s clockwise
+	double accelX; // g forward
+	double accelY; // g right
+};
+
+struct EkfState {
+	float x; // cm
+	float y;
+	float theta; // radians
+	float velocityForward; // cm/s on the robot
+	float velocitySideways; // cm/s, + right
+	float angularVelocity; // radians/s
+};
+
+class PoseEkf {
+	public:
+	// each bit says that side's drive motors got thrown out by the gate last update
+	enum Rejected : std::uint8_t {
+		leftDrive = 1 << 0,
+		rightDrive = 1 << 1
+	};
+
+	explicit PoseEkf(const EkfConfig &iconfig);
+
+	// the first reading only sets where the sensors start, after that each one moves the filter along
+	void update(const OdomReading &ireading);
+
+	// put the robot at x, y, theta (cm, cm, radians) exactly, the imu gets lined up with theta from here on
+	void setPose(float ix, float iy, float itheta);
+
+	EkfState getState() const;
+	float getPositionError() const; // cm, one standard deviation of how far off x and y might be
+	std::uint8_t getRejected() const; // from the last update
+
+	private:
+	static constexpr int size = 6;
+	enum Index { x, y, theta, forward, sideways, spin };
+	using Matrix = std::array<std::array<float, size>, size>;
+
+	static Matrix identity();
+	void predict(float idt, float iaccelForward, float iaccelSideways);
+	void transform(const Matrix &ijacobian); // covariance = J covariance J^T
+	// fuses z = h[i]*state[i] + h[j]*state[j], returns false if the gate threw it out
+	bool fuse(float imeasurement, int i, float hi, int j, float hj, float inoise, bool igated);
+
+	EkfConfig config;
+	std::array<float, size> state{};
+	Matrix covariance{};
+	OdomReading last{};
+	bool primed = false; // false until the first reading
+	float imuOffset = 0; // radians, theta minus imu rotation
+	bool imuLined = false; // false till the imu's read once since setPose
+	std::uint8_t rejected = 0;
+};
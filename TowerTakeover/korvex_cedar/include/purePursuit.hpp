@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "okapi/api.hpp"
+
+// adaptive pure pursuit, the closed loop version of profileController's paths
+// PursuitPath takes the same waypoints as profileController->generatePath, PurePursuit says where to steer each loop
+// and followPath in main.cpp drives it off odom x/y and the imu heading, so a cube knocking us sideways gets corrected
+// everything in here is cm, cm/s and radians, theta clockwise from x like okapi's odom
+
+// how fast a path gets driven, followPath's defaults are a bit under cedar's top speed
+struct PursuitLimits {
+	float maxVelocity = 90; // cm/s
+	float minVelocity = 12; // cm/s, the slowest we plan for so the end of the path still gets reached
+	float maxAccel = 120; // cm/s^2
+	float turnK = 2; // how much corners slow us, cm/s per cm of turn radius
+	float spacing = 2.5; // cm between the path's points
+};
+
+class PursuitPath {
+	public:
+	struct Sample {
+		float x, y; // cm
+		float distance; // cm along the path
+		float curvature; // 1/cm, unsigned
+		float velocity; // cm/s planned
+	};
+
+	// a hermite spline through iwaypoints like pathfinder does, each waypoint's theta is the direction the path leaves it in
+	// then points every spacing, each with a speed that slows for corners and ramps down into the end
+	PursuitPath(const std::vector<okapi::OdomState> &iwaypoints, const PursuitLimits &ilimits = PursuitLimits());
+
+	const std::vector<Sample> &samples() const;
+	const PursuitLimits &limits() const;
+	float length() const; // cm
+
+	private:
+	std::vector<Sample> points;
+	PursuitLimits pathLimits;
+};
+
+class PurePursuit {
+	public:
+	// the lookahead grows from iminLookahead when the path is slow (corners, the end) to imaxLookahead at full speed
+	PurePursuit(const PursuitPath &ipath, float iminLookahead = 10, float imaxLookahead = 25);
+
+	struct Output {
+		float curvature; // 1/cm, positive turns right (clockwise)
+		float velocity; // cm/s the path wants where we are
+		float travelled; // cm along the path to the closest point
+		float endError; // cm to the last point
+		bool done; // at the end or past it
+	};
+
+	// one control loop's worth, x y in cm, theta in radians
+	// the closest point and the lookahead point only ever move forward and only look a few points ahead,
+	// so a tick costs the same at the start of a long path as anywhere else
+	Output step(float x, float y, float theta);
+
+	void reset();
+
+	private:
+	// where the circle of iradius round x, y leaves the path, searching forward from lookahead, false if it doesn't
+	bool findLookahead(float x, float y, float iradius, float &ox, float &oy);
+
+	const PursuitPath &path;
+	float minLookahead, maxLookahead;
+	std::size_t closest = 0; // index of the closest sample
+	float lookahead = 0; // fractional index of the last lookahead point
+};
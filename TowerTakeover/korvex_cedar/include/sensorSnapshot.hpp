@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include "api.h"
+#include "okapi/api.hpp"
+
+// every device opcontrol decides off, read once at the top of the loop into a plain struct
+// before this the loop asked the lift for its position up to 7 times and the tray 4, each one a trip to the device, and a
+// value could change between two ifs that were meant to agree. now every branch in one loop sees the same numbers
+// the tracking wheels and imu already get read once a tick by the odom task, use odometry.getPose() for those, and the
+// line sensor by its own task, use cube
+
+struct SensorSnapshot {
+	std::uint32_t time = 0; // ms when it was read
+	double liftPosition = 0; // counts
+	double liftEfficiency = 0; // %
+	double trayPosition = 0; // counts
+	double trayVelocity = 0; // rpm
+	double intakePositionError = 0; // counts, from the last moveRelative/moveAbsolute
+	float leftY = 0; // controller, -1 to 1
+	float rightY = 0;
+
+	// ms since it was read
+	std::uint32_t age() const {
+		return pros::millis() - time;
+	}
+};
+
+class SensorSampler {
+	public:
+	SensorSampler(okapi::Motor &ilift, okapi::Motor &itray, okapi::MotorGroup &iintake, okapi::Controller &icontroller);
+
+	// reads everything, once per loop at the top
+	const SensorSnapshot &sample();
+
+	// the last sample, check age() if it matters how old
+	const SensorSnapshot &get() const;
+
+	private:
+	okapi::Motor &lift;
+	okapi::Motor &tray;
+	okapi::MotorGroup &intake;
+	okapi::Controller &controller;
+	SensorSnapshot snapshot;
+};
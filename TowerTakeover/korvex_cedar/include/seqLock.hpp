@@ -0,0 +1,58 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// one task writes, any number read, nobody waits on a mutex
+// the writer bumps sequence to odd, writes, bumps it back to even, a reader that saw it odd or saw it change
+// halfway through its copy just copies again, so every read is one whole write and never half of two
+// on the brain the odom task runs above everything that reads it, so it can preempt a reader halfway through its copy
+// and write a new pose under it, the retry is what makes that read safe. don't take it out
+// T has to be plain data (no pointers to itself, no virtuals), it's copied a word at a time
+
+template <typename T> class SeqLock {
+	static_assert(std::is_trivially_copyable<T>::value, "SeqLock copies T word by word");
+
+	public:
+	SeqLock() {
+		write(T{});
+	}
+
+	// only ever from the one writer
+	void write(const T &ivalue) {
+		std::array<std::uint32_t, words> in{};
+		std::memcpy(in.data(), &ivalue, sizeof(T));
+		const std::uint32_t start = sequence.load(std::memory_order_relaxed);
+		sequence.store(start + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for (std::size_t i = 0; i < words; i++) data[i].store(in[i], std::memory_order_relaxed);
+		sequence.store(start + 2, std::memory_order_release);
+	}
+
+	T read() const {
+		std::array<std::uint32_t, words> out;
+		std::uint32_t before, after;
+		do {
+			before = sequence.load(std::memory_order_acquire);
+			for (std::size_t i = 0; i < words; i++) out[i] = data[i].load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			after = sequence.load(std::memory_order_relaxed);
+		} while ((before & 1) or before != after);
+		T value;
+		// as bytes, T can still have default member initializers, trivially copyable is all the copy needs
+		std::memcpy(reinterpret_cast<unsigned char *>(&value), out.data(), sizeof(T));
+		return value;
+	}
+
+	// goes up by 2 every write, for telling whether anything's new since last time
+	std::uint32_t version() const {
+		return sequence.load(std::memory_order_acquire);
+	}
+
+	private:
+	static constexpr std::size_t words = (sizeof(T) + 3) / 4;
+	std::atomic<std::uint32_t> sequence{0};
+	std::array<std::atomic<std::uint32_t>, words> data{};
+};
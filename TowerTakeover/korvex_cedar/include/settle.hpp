@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include "okapi/api.hpp"
+
+// when a motion function is done, one set of rules for all of them instead of each counting sameErrCycles its own way
+// settled:   inside the error band and slower than the velocity band, held for dwell
+// stalled:   over the last stall ms the error closed slower than progress, ie pushing on a wall, creeping, or rocking short of the
+//            target. only inside stallError, or with the output maxed out, further off it's the timeout's call, and only
+//            slower than the velocity band so swinging back through an overshoot isn't a stall
+// timedOut:  timeout ran out first
+// cancelled: the move's AsyncMotion got cancelled
+// the velocity is measured (tracking wheels or imu rate), not the change in error, so coasting through the band doesn't count
+
+enum class SettleReason {
+	running,
+	settled,
+	stalled,
+	timedOut,
+	cancelled
+};
+
+const char *settleReasonName(SettleReason ireason);
+
+struct SettleBands {
+	float error; // cm or deg, whatever the move's error is in
+	float velocity; // cm/s or deg/s
+	int dwell; // ms inside both bands
+	int stall; // ms to check progress over
+	float progress; // cm/s or deg/s the error has to keep closing at outside the error band
+	float stallError; // cm or deg, a loose band past the error band, outside it a stall doesn't end the move
+	int timeout = 0; // ms, 0 never times out
+};
+
+class SettleDetector {
+	public:
+	explicit SettleDetector(const SettleBands &ibands);
+
+	// one loop's worth, returns true once the move should stop and reason() says why
+	// isaturated is the output being at its max, so not getting anywhere is something in the way and not a weak controller
+	bool update(float ierror, float ivelocity, bool icancelled = false, bool isaturated = false);
+
+	SettleReason reason() const;
+	const char *reasonName() const;
+
+	private:
+	SettleBands bands;
+	std::unique_ptr<okapi::SettledUtil> settled; // the error band and dwell, the velocity band gates what it sees
+	static constexpr float velocitySmoothing = 50; // ms
+	float velocity = 0; // smoothed
+	std::deque<std::pair<std::uint32_t, float>> history; // ms and error, back to stall ms ago
+	std::uint32_t startTime;
+	std::uint32_t lastTime;
+	SettleReason exitReason = SettleReason::running;
+};
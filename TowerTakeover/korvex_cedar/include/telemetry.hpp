@@ -0,0 +1,116 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include "api.h"
+
+// debug logging that's cheap enough to leave on, instead of std::cout << ... << std::endl in the middle of a loop
+// a log() copies a time, a channel and up to 10 floats into a fixed ring and that's it, no formatting, no serial, no lock,
+// so any task can call it every loop without the loop's timing changing the moment it's turned on
+// a low priority task drains the ring every 20ms, prints it as "<ms>: <channel> <values...>" and flushes once for
+// the lot, to the terminal or a file on the sd card
+// the first time a channel shows up it prints "<ms>: <channel> fields <names...>" so the columns are labelled
+// if the ring fills up (nothing's drained it for a while) new records get dropped and counted, a control loop never waits
+//
+// with openLog the drain writes everything to a binary file on the sd card instead, so there's data from real matches
+// and not just off the tether. sim/bin/logdecode turns one into a csv per channel. little endian, format version 1:
+//   header  "KVXT", u8 version, u8 channel count, then per channel its name and its fields, each a 0 terminated string
+//   record  u32 ms, u8 channel, u8 value count, that many f32
+//           channel 255 is the ring dropping records, one value of how many
+// once a log's open the records only go to the card, printing every one to the terminal as well would cost the
+// formatting and serial time the ring is there to save. setEcho(true) prints them too, for a tethered run
+// records only ever get added to the end, a record cut off by the power going is the end of the file
+// the drain saves them up and writes 4kB at a time, or whatever it's got once a second or when flushLog asks, the card can take 10s of ms
+// to write and only the drain task ever waits on it
+
+struct TelemetryRecord {
+	static constexpr int maxValues = 10;
+	std::uint32_t time; // ms
+	std::uint8_t channel;
+	std::uint8_t count; // how many of values are used
+	float values[maxValues];
+};
+
+class Telemetry {
+	public:
+	// everything that logs, add one here and to channels in telemetry.cpp
+	enum Channel : std::uint8_t {
+		driveP,
+		driveQ,
+		turnP,
+		waypoint, // driveChain
+		passedWaypoint,
+		driveToPose,
+		followPath,
+		ramWall,
+		odom, // sim/tools/ekfreplay reads these two
+		odomPose,
+		contact, // the odom task too, when something gets hit or a side starts slipping
+		charQuasistatic, // and sim/tools/drivefit these three
+		charDynamic,
+		charSpin,
+		channelCount
+	};
+
+	Telemetry();
+
+	// a few hundred ns, false if the ring was full and it got dropped. anything past maxValues is cut off
+	bool log(Channel ichannel, std::initializer_list<float> ivalues, std::uint32_t itime = pros::millis());
+
+	// starts the drain task, every iperiod ms into iout (stdout is the terminal, or fopen a file on /usd/)
+	void start(std::FILE *iout = stdout, std::uint32_t iperiod = 20);
+
+	// also write to the next free <idirectory>cedarNNN.tlm, before start(). false if it couldn't make one
+	// ie if (pros::usd::is_installed()) telemetry().openLog("/usd/");
+	bool openLog(const char *idirectory);
+
+	// with a log open, print to iout as well
+	void setEcho(bool iecho);
+
+	// prints everything in the ring now, only from one task at a time, the drain task calls it
+	void drain();
+
+	// has the drain write out what the log has saved up on its next pass instead of waiting for the second to be up,
+	// any task can call it. the end of autonomous and disabled do, the robot tends to get turned off right after
+	void flushLog();
+
+	std::uint32_t getDropped() const;
+
+	private:
+	static constexpr std::uint32_t size = 512; // a power of 2, 24kB, 2.5s of the odom log on its own
+	static void loop(void *itelemetry);
+
+	// each slot's sequence says whose turn it is: == the write position when it's free to write,
+	// one past it once it's written and ready to drain
+	struct Slot {
+		std::atomic<std::uint32_t> sequence;
+		TelemetryRecord record;
+	};
+	std::array<Slot, size> slots;
+	std::atomic<std::uint32_t> writePosition{0};
+	std::uint32_t readPosition = 0; // only the drain touches it
+	std::atomic<std::uint32_t> dropped{0};
+	std::uint32_t droppedPrinted = 0;
+	std::array<bool, channelCount> labelled{};
+
+	std::FILE *out = stdout;
+	std::uint32_t period = 20;
+	bool started = false;
+	bool echo = false;
+
+	static constexpr std::uint8_t logVersion = 1;
+	static constexpr std::uint8_t droppedChannel = 255;
+	static constexpr std::size_t blockSize = 4096;
+	void logRecord(const TelemetryRecord &irecord);
+	void writeBlock(); // only from the drain
+	std::atomic<bool> flushWanted{false};
+	std::FILE *logFile = nullptr;
+	std::array<std::uint8_t, blockSize> block;
+	std::size_t blockUsed = 0;
+	std::uint32_t blockTime = 0; // ms the last block went out
+};
+
+// the one everything logs to
+Telemetry &telemetry();
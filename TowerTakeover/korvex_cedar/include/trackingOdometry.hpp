@@ -0,0 +1,83 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include "api.h"
+#include "contact.hpp"
+#include "poseEkf.hpp"
+#include "seqLock.hpp"
+
+// three tracking wheel odometry in its own task, every 10ms instead of okapi's two wheel odom at 20ms with
+// odomImuSupplement stomping on theta in between
+// the sensors all go through PoseEkf, so the strafe wheel catches us getting shoved sideways, the imu keeps the heading
+// honest and the drive motors cover for a tracking wheel that bounces
+// ContactDetector watches the same readings for slip and collisions
+// x forward, y right, theta clockwise in radians like okapi's odom, everything else in cm
+
+// one update's worth, time is pros::millis() when the encoders were read
+struct OdomPose {
+	float x; // cm
+	float y;
+	float theta; // radians
+	float velocityX; // cm/s on the field
+	float velocityY;
+	float angularVelocity; // radians/s
+	std::uint32_t time; // ms
+};
+
+class TrackingOdometry {
+	public:
+	// idriveLeft and idriveRight are a motor port on each side of the drive, negative if it's reversed like okapi's,
+	// read in whatever units okapi set them to
+	TrackingOdometry(pros::ADIEncoder &ileft, pros::ADIEncoder &iright, pros::ADIEncoder &istrafe, pros::Imu &iimu, std::int8_t idriveLeft,
+	                 std::int8_t idriveRight, const EkfConfig &iconfig, const ContactConfig &icontact = ContactConfig());
+
+	// starts the task, every iperiod ms. the ADI only gets read every 10ms so going faster than that just sees the same ticks
+	void start(std::uint32_t iperiod = 10);
+
+	// one update, the task calls this but it's here for running the odom by hand (not while the task's going too)
+	void step();
+
+	// the latest update, x y theta and the velocities always all from the same one
+	// no mutex so it's cheap, grab it once a loop rather than once per coordinate
+	OdomPose getPose() const;
+
+	// move the robot to x, y, theta (cm, cm, radians), theta lines the imu up with it from here on
+	// the odom task is the only one that writes the pose, so this hands it over and waits the one update for it to happen
+	void setPose(float ix, float iy, float itheta);
+
+	// slip, collisions and whether we've stopped, as of the latest update. the odom prints each hit and slip as it starts too
+	ContactState getContact() const;
+
+	// prints every reading as "<ms>: odom <left> <right> <strafe> <drive left> <drive right> <rotation> <gyro> <accel x> <accel y>"
+	// for sim/tools/ekfreplay, with "<ms>: odom config ..." first and "<ms>: odom pose x y theta" wherever setPose lands
+	// it's 100 lines a second so only while tuning
+	void setLogging(bool ilogging);
+
+	// runs the filter iupdates times on made up readings and gives back the microseconds each took
+	// millis() is all we've got on the brain so it needs a few thousand to be worth anything
+	float benchmark(int iupdates = 5000) const;
+
+	private:
+	static void loop(void *iodometry);
+	OdomReading read() const;
+	void update(const OdomReading &ireading); // logs it if we're logging, runs the filter and the contact detector
+	void publish(std::uint32_t itime);
+
+	pros::ADIEncoder &left;
+	pros::ADIEncoder &right;
+	pros::ADIEncoder &strafe;
+	pros::Imu &imu;
+	std::int8_t driveLeft;
+	std::int8_t driveRight;
+	EkfConfig config;
+	std::uint32_t period = 10;
+
+	PoseEkf ekf; // only step() touches it
+	ContactDetector contact; // same
+	SeqLock<OdomPose> published; // what everyone else reads
+	SeqLock<ContactState> contactPublished;
+	SeqLock<OdomPose> reset; // setPose's x y theta for the task to pick up
+	std::atomic<bool> resetPending{false};
+	std::atomic<bool> logging{false};
+	bool started = false;
+};
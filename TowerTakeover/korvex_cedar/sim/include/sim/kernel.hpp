@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include "api.h"
+
+// the host stand in for the pros kernel
+// every pros task is a host thread, but only the one holding the cpu runs, like the single core brain
+// a task keeps the cpu until it blocks (delay, notify_take, mutex_take...), then the highest priority ready
+// task gets it, ties go to whoever has waited longest and then to whoever was created first
+// millis() is simulated time, when every task is blocked the clock jumps to the next wake up and the physics
+// steps once per simulated millisecond on the way, so runs are as fast as the cpu allows and always the same
+
+namespace sim {
+
+// thrown out of a blocking call in a task that has been deleted, the task trampoline catches it
+struct TaskDeleted {};
+
+// let the tasks created so far (and any made later) start running
+// the host thread counts as a task too, it has the cpu whenever it isn't in waitFor or sleep
+void start();
+
+// block the host thread until itask is done or itimeout ms of simulated time pass
+// returns true if the task finished
+bool waitFor(pros::task_t itask, std::uint32_t itimeout);
+
+// block the host thread for ims of simulated time
+void sleep(std::uint32_t ims);
+
+} // namespace sim
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdio>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// reading back what cedarsim prints, for the tools that run it
+// header only so the host tools don't have to link the sim
+
+namespace sim {
+
+// one motion call, from the robot's "task complete" log and the "sim: step" line cedarsim adds after it
+struct Step {
+	int ms = 0; // how long the call took
+	double error = 0; // what it said it was still off by when it returned, cm or deg depending on the call, 0 for ramWall
+	std::string reason; // why it stopped (settled, stalled...), empty if it didn't say
+	double pose[3] = {}; // in, in, deg where the robot really was when it returned
+};
+
+struct Result {
+	std::string auton;
+	bool finished = false;
+	double time = 0; // s
+	double pose[3] = {}; // in, in, deg where the robot really ended up
+	double odom[3] = {}; // where odom thinks it ended up
+	std::vector<Step> steps; // every motion call, in order
+	std::vector<Step> trace; // with --move, the pose every 10ms and how long into the move it was
+};
+
+// run a shell command and collect its stdout a line at a time
+inline std::vector<std::string> lines(const std::string &icommand) {
+	std::vector<std::string> out;
+	FILE *pipe = popen(icommand.c_str(), "r");
+	if (!pipe) return out;
+	char buffer[512];
+	while (std::fgets(buffer, sizeof(buffer), pipe)) {
+		std::string line(buffer);
+		if (!line.empty() && line.back() == '\n') line.pop_back();
+		out.push_back(line);
+	}
+	pclose(pipe);
+	return out;
+}
+
+// the robot logs "<ms>task complete with error <err>..., in <ms>ms, <reason>" at the end of every motion function
+inline Result parse(const std::string &iauton, const std::vector<std::string> &ilines) {
+	static const std::regex motion("task complete with error (-?[0-9.e+-]+)([a-z]*).* in ([0-9]+)ms(, (.*))?");
+	Result result;
+	result.auton = iauton;
+	for (auto &line : ilines) {
+		std::smatch match;
+		if (std::regex_search(line, match, motion)) {
+			result.steps.emplace_back();
+			result.steps.back().ms = std::stoi(match[3]);
+			result.steps.back().error = match[2] == "g" ? 0 : std::stod(match[1]); // ramWall's is how hard it hit, it has no target to be off
+			result.steps.back().reason = match[5];
+			continue;
+		}
+		if (line.compare(0, 5, "sim: ")) continue;
+		std::istringstream in(line.substr(5));
+		std::string key;
+		in >> key;
+		if (key == "pose") in >> result.pose[0] >> result.pose[1] >> result.pose[2];
+		else if (key == "odom") in >> result.odom[0] >> result.odom[1] >> result.odom[2];
+		else if (key == "trace") {
+			Step sample;
+			in >> sample.ms >> sample.pose[0] >> sample.pose[1] >> sample.pose[2];
+			result.trace.push_back(sample);
+		}
+		else if (key == "step" && !result.steps.empty()) {
+			double *pose = result.steps.back().pose;
+			in >> pose[0] >> pose[1] >> pose[2];
+		}
+		else if (key == iauton) {
+			std::string state;
+			in >> state >> result.time;
+			result.finished = state == "done";
+		}
+	}
+	return result;
+}
+
+} // namespace sim
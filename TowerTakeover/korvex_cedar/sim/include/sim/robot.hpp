@@ -0,0 +1,208 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "api.h"
+
+// the simulated robot that sits behind the host implementation of the pros api
+// everything in here is in si units (m, rad, s) unless the name says otherwise
+
+namespace sim {
+
+// a v5 smart motor, position and velocity are at the output shaft
+struct SmartMotor {
+	bool plugged = false; // true once user code has touched the port
+	pros::motor_gearset_e_t gearset = pros::E_MOTOR_GEARSET_18;
+	pros::motor_encoder_units_e_t units = pros::E_MOTOR_ENCODER_DEGREES;
+	pros::motor_brake_mode_e_t brakeMode = pros::E_MOTOR_BRAKE_COAST;
+	bool reversed = false;
+
+	// what the internal controller is trying to do, all in the user (reversed) frame
+	enum class Mode { voltage, velocity, position } mode = Mode::voltage;
+	double targetVoltage = 0; // mV
+	double targetVelocity = 0; // rpm
+	double targetPosition = 0; // deg
+	double profileVelocity = 0; // rpm, the cap for position moves
+	double holdPosition = 0; // deg, physical frame, where hold brake mode parks
+	double integral = 0; // mV, the velocity controller's i term
+
+	// physical state, not reversed
+	double position = 0; // deg
+	double velocity = 0; // deg/s
+	double voltage = 0; // mV the h-bridge applied last tick
+	bool driven = true; // false while the h-bridge is off and the motor coasts
+	double torque = 0; // Nm at the output last tick
+	double current = 0; // mA
+	double zero = 0; // deg, physical position that reads as 0
+
+	// what the output drives when it isn't part of the drivetrain
+	double inertia = 0.002; // kg m^2
+	double friction = 0.05; // Nm
+
+	double maxRpm() const;
+	double stallTorque() const; // Nm at the output, where the 2.5 A current limit kicks in
+	double ticksPerRev() const; // encoder counts per output revolution
+	double sign() const { return reversed ? -1 : 1; }
+	double userPosition() const { return sign() * (position - zero); } // deg
+	double userVelocity() const { return sign() * velocity / 6; } // rpm
+	double toDegrees(double iunits) const; // encoder units to deg
+	double fromDegrees(double ideg) const; // deg to encoder units
+};
+
+// robot pose on the field, okapi's frame transformation convention
+// +x forward, +y right, theta clockwise
+struct Pose {
+	double x = 0;
+	double y = 0;
+	double theta = 0;
+};
+
+// a straight bit of field wall, anything past it is out of the field
+struct Wall {
+	double x = 0; // a point on it
+	double y = 0;
+	double normalX = 0; // unit, pointing into the field
+	double normalY = 0;
+};
+
+// an unpowered tracking wheel on an adi encoder
+struct TrackingWheel {
+	std::uint8_t port = 0; // top adi port, 1 indexed
+	double diameter = 0;
+	double offset = 0; // lateral offset (+ right) for forward wheels, forward offset for strafe wheels
+	bool strafe = false;
+	double sign = 1; // how the encoder is mounted
+	double travel = 0; // m the wheel has rolled
+};
+
+// a mechanism on a motor that isn't in the drivetrain
+struct MotorLoad {
+	std::uint8_t port = 0;
+	double inertia = 0; // kg m^2 at the output
+	double friction = 0; // Nm
+};
+
+// the mass and grip of the chassis, the drive motors push it through the wheels
+struct ChassisConfig {
+	double mass = 0; // kg
+	double inertia = 0; // kg m^2 about the center, yaw only
+	double wheelbase = 0; // m between the front and back wheels, sets the lever arm the wheels scrub on
+	double length = 0; // m bumper to bumper, for running into walls
+	double traction = 0; // forward friction coefficient of the drive wheels
+	double scrub = 0; // sideways friction coefficient, omnis slide easily
+	double sideInertia = 0; // kg m^2 of one side's wheels and gearing, seen at the wheel
+	double rollingResistance = 0; // N
+	double bumper = 0; // N/m the bumpers squash at against a wall
+};
+
+// the battery sags under load, which caps the voltage the motors get
+struct BatteryConfig {
+	double voltage = 12.8; // V open circuit
+	double resistance = 0.1; // ohm, cells and wiring
+};
+
+// how much one run can differ from the nominal robot, each is one standard deviation
+struct Variation {
+	double encoderScale = 0; // fraction a tracking wheel's diameter is off by
+	double encoderNoise = 0; // ticks per sqrt(m) rolled, random miscounts
+	double imuDrift = 0; // rad/s of gyro bias
+	double imuNoise = 0; // rad per sqrt(s), random walk on top of the bias
+	double intakeDelay = 0; // deg of intake travel before the first cube reaches the sensor
+	double intakeSpacing = 0; // fraction the gap between cubes is off by
+	double traction = 0; // fraction each side's tire grip is off by
+	double startPosition = 0; // m the robot is placed off its spot, per axis
+	double startHeading = 0; // rad
+};
+
+// about what cedar sees from run to run at an event
+Variation typicalVariation();
+
+// where everything is plugged in and how big it is
+struct RobotConfig {
+	std::array<std::uint8_t, 2> leftDrive{};
+	std::array<std::uint8_t, 2> rightDrive{};
+	double driveWheelDiameter = 0;
+	double driveTrack = 0;
+	ChassisConfig chassis;
+	BatteryConfig battery;
+	std::vector<MotorLoad> loads;
+	std::array<TrackingWheel, 3> tracking{};
+	std::uint8_t intakePort = 0;
+	std::uint8_t linePort = 0;
+	std::uint8_t imuPort = 0;
+};
+
+// the whole robot, stepped by the kernel every millisecond
+// motors make torque off a linear torque/speed curve capped at the current limit, the drive motors spin
+// their side's wheels which push the chassis through tire friction, so wheels can slip and turns scrub
+// nothing in here locks, the kernel only lets one task touch it at a time
+class Robot {
+	public:
+	explicit Robot(const RobotConfig &iconfig);
+
+	// advance the physics by idt seconds
+	void step(double idt);
+
+	// draw this run's robot from ivariation, the same iseed always gives the same run
+	// call before the kernel starts, a robot that's never varied is the nominal one
+	void vary(const Variation &ivariation, std::uint64_t iseed);
+
+	SmartMotor &motor(std::uint8_t iport);
+	const RobotConfig &getConfig() const { return config; }
+
+	// field state
+	Pose pose;
+	double velocity = 0; // m/s forward
+	double acceleration = 0; // m/s^2 forward, over the last step
+	double angularVelocity = 0; // rad/s clockwise
+	std::array<double, 2> wheelSpeed{}; // rad/s of the left and right drive wheels, + rolls forward
+	double batteryVoltage = 12800; // mV at the terminals
+	double batteryCurrent = 0; // mA
+	double imuTime = 0; // s since the last imu reset, the imu calibrates for 2 s
+	double imuOffset = 0; // rad, rotation at the last imu reset
+	double imuError = 0; // rad the gyro has drifted from the real heading
+	double imuHeading() const { return pose.theta + imuError; } // rad, what the imu thinks the rotation is
+	double imuRate() const { return angularVelocity + imuBias; } // rad/s, what the gyro reads
+	double intakeChain = 0; // deg the cubes in the intake have moved past the line sensor
+	std::vector<Wall> walls; // in the same frame as pose, none by default so the robot drives forever
+
+	// adi
+	std::int32_t encoderTicks(std::uint8_t iport) const;
+	void resetEncoder(std::uint8_t iport);
+	std::int32_t analogRead(std::uint8_t iport) const;
+
+	// controller, indexed by the pros enums
+	std::array<std::int32_t, 4> analog{};
+	std::array<bool, 18> digital{};
+	std::uint8_t competition = 0; // pros competition status bits
+
+	private:
+	RobotConfig config;
+	std::array<SmartMotor, 22> motors{}; // indexed by port, 0 is unused
+	std::array<double, 3> encoderZero{};
+
+	// this run's draw, see vary()
+	Variation variation;
+	std::mt19937_64 rng;
+	std::normal_distribution<double> gaussian;
+	std::array<double, 3> encoderScale{1, 1, 1};
+	std::array<double, 2> tractionScale{1, 1};
+	double imuBias = 0; // rad/s
+	double cubePhase = 0; // deg
+	double cubeSpacing = 1;
+
+	void control(SmartMotor &motor, double imaxVoltage, double idt);
+	void applyTorque(SmartMotor &motor) const;
+	void stepDrive(double idt);
+	void collide(double idt);
+	bool isDrive(std::uint8_t iport) const;
+};
+
+// the robot every device call talks to, cedar's by default
+Robot &robot();
+
+// turn a pros adi port ('A', 'a' or 1) into 1 indexed
+std::uint8_t adiPort(std::uint8_t iport);
+
+} // namespace sim
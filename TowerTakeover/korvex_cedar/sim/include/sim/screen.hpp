@@ -0,0 +1,14 @@
+#pragma once
+#include <string>
+
+// the brain screen, the lvgl calls build a tree of widgets that nothing draws
+// but the buttons can still be pressed so the auton selector works
+
+namespace sim {
+namespace screen {
+
+// tap the button labelled itext on the tab named itab, returns false if there isn't one
+bool press(const std::string &itab, const std::string &itext);
+
+} // namespace screen
+} // namespace sim
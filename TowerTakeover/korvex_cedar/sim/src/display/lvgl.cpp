@@ -0,0 +1,159 @@
+#include <list>
+#include <string>
+#include <vector>
+#include "api.h"
+#include "sim/screen.hpp"
+
+namespace {
+enum class Kind { screen, tabview, tab, btn, btnm, label, mbox };
+
+// what the sim keeps for each object, hung off ext_attr
+struct Widget {
+	Kind kind;
+	std::string text;
+	const char **map = nullptr;
+	lv_btnm_action_t btnmAction = nullptr;
+	lv_action_t btnActions[LV_BTN_ACTION_NUM] = {};
+	std::vector<lv_obj_t *> children;
+};
+
+std::list<lv_obj_t> objects;
+std::list<Widget> widgets;
+
+Widget &widget(const lv_obj_t *iobj) {
+	return *static_cast<Widget *>(iobj->ext_attr);
+}
+
+lv_obj_t *create(lv_obj_t *iparent, Kind ikind) {
+	objects.emplace_back();
+	widgets.push_back({ikind});
+	lv_obj_t *obj = &objects.back();
+	obj->par = iparent;
+	obj->ext_attr = &widgets.back();
+	if (iparent) widget(iparent).children.push_back(obj);
+	return obj;
+}
+
+lv_obj_t *find(lv_obj_t *iobj, Kind ikind, const std::string &itext) {
+	Widget &w = widget(iobj);
+	if (w.kind == ikind && w.text == itext) return iobj;
+	for (auto child : w.children) {
+		if (auto found = find(child, ikind, itext)) return found;
+	}
+	return nullptr;
+}
+
+bool tap(lv_obj_t *iobj, const std::string &itext) {
+	Widget &w = widget(iobj);
+	if (w.kind == Kind::btnm && w.map && w.btnmAction) {
+		// hand over the map's own string, user code is allowed to compare the pointer
+		for (const char **button = w.map; **button; button++) {
+			if (itext == *button) {
+				w.btnmAction(iobj, *button);
+				return true;
+			}
+		}
+	}
+	if (w.kind == Kind::btn && w.btnActions[LV_BTN_ACTION_CLICK]) {
+		for (auto child : w.children) {
+			if (widget(child).text == itext) {
+				w.btnActions[LV_BTN_ACTION_CLICK](iobj);
+				return true;
+			}
+		}
+	}
+	for (auto child : w.children) {
+		if (tap(child, itext)) return true;
+	}
+	return false;
+}
+} // namespace
+
+lv_obj_t *lv_scr_act() {
+	static lv_obj_t *screen = create(nullptr, Kind::screen);
+	return screen;
+}
+
+lv_theme_t *lv_theme_alien_init(uint16_t, lv_font_t *) {
+	static lv_theme_t theme{};
+	return &theme;
+}
+
+void lv_theme_set_current(lv_theme_t *) {}
+
+lv_obj_t *lv_tabview_create(lv_obj_t *par, const lv_obj_t *) {
+	return create(par, Kind::tabview);
+}
+
+lv_obj_t *lv_tabview_add_tab(lv_obj_t *tabview, const char *name) {
+	lv_obj_t *tab = create(tabview, Kind::tab);
+	widget(tab).text = name;
+	return tab;
+}
+
+lv_obj_t *lv_btnm_create(lv_obj_t *par, const lv_obj_t *) {
+	return create(par, Kind::btnm);
+}
+
+void lv_btnm_set_map(lv_obj_t *btnm, const char **map) {
+	widget(btnm).map = map;
+}
+
+void lv_btnm_set_action(lv_obj_t *btnm, lv_btnm_action_t action) {
+	widget(btnm).btnmAction = action;
+}
+
+void lv_btnm_set_toggle(lv_obj_t *, bool, uint16_t) {}
+
+lv_obj_t *lv_btn_create(lv_obj_t *par, const lv_obj_t *) {
+	return create(par, Kind::btn);
+}
+
+void lv_btn_set_action(lv_obj_t *btn, lv_btn_action_t type, lv_action_t action) {
+	widget(btn).btnActions[type] = action;
+}
+
+lv_obj_t *lv_label_create(lv_obj_t *par, const lv_obj_t *) {
+	return create(par, Kind::label);
+}
+
+void lv_label_set_text(lv_obj_t *label, const char *text) {
+	widget(label).text = text ? text : "";
+}
+
+lv_obj_t *lv_mbox_create(lv_obj_t *par, const lv_obj_t *) {
+	return create(par, Kind::mbox);
+}
+
+void lv_mbox_set_text(lv_obj_t *mbox, const char *txt) {
+	widget(mbox).text = txt ? txt : "";
+}
+
+void lv_mbox_set_anim_time(lv_obj_t *, uint16_t) {}
+
+void lv_mbox_start_auto_close(lv_obj_t *, uint16_t) {}
+
+void lv_obj_set_pos(lv_obj_t *, lv_coord_t, lv_coord_t) {}
+
+void lv_obj_set_size(lv_obj_t *, lv_coord_t, lv_coord_t) {}
+
+void lv_obj_align(lv_obj_t *, const lv_obj_t *, lv_align_t, lv_coord_t, lv_coord_t) {}
+
+void lv_obj_set_free_num(lv_obj_t *obj, LV_OBJ_FREE_NUM_TYPE free_num) {
+	obj->free_num = free_num;
+}
+
+LV_OBJ_FREE_NUM_TYPE lv_obj_get_free_num(const lv_obj_t *obj) {
+	return obj->free_num;
+}
+
+namespace sim {
+namespace screen {
+
+bool press(const std::string &itab, const std::string &itext) {
+	lv_obj_t *tab = find(lv_scr_act(), Kind::tab, itab);
+	return tab && tap(tab, itext);
+}
+
+} // namespace screen
+} // namespace sim
@@ -0,0 +1,850 @@
+#include <iomanip>
+#include <sstream>
+#include "okapi/api.hpp"
+
+// host builds of the okapi chassis, odometry and chassis builder
+// the math follows okapi 4.0.2 so odometry on the host drifts the same way it does on the robot
+
+namespace okapi {
+
+namespace {
+// stands in for ChassisControllerIntegrated, which needs the whole async controller stack,
+// by giving the smart motors relative targets the same way the integrated controllers do
+class IntegratedChassis : public ChassisController {
+	public:
+	IntegratedChassis(const TimeUtil &itimeUtil,
+	                  std::shared_ptr<ChassisModel> imodel,
+	                  std::shared_ptr<AbstractMotor> ileft,
+	                  std::shared_ptr<AbstractMotor> iright,
+	                  const AbstractMotor::GearsetRatioPair &igearset,
+	                  const ChassisScales &iscales)
+	  : timeUtil(itimeUtil),
+	    chassisModel(std::move(imodel)),
+	    left(std::move(ileft)),
+	    right(std::move(iright)),
+	    gearsetRatioPair(igearset),
+	    scales(iscales),
+	    leftSettled(timeUtil.getSettledUtil()),
+	    rightSettled(timeUtil.getSettledUtil()) {
+		chassisModel->setGearing(gearsetRatioPair.internalGearset);
+		chassisModel->setEncoderUnits(AbstractMotor::encoderUnits::counts);
+		maxVelocity = toUnderlyingType(gearsetRatioPair.internalGearset);
+	}
+
+	void moveDistance(QLength itarget) override {
+		moveDistanceAsync(itarget);
+		waitUntilSettled();
+	}
+
+	void moveRaw(double itarget) override {
+		moveRawAsync(itarget);
+		waitUntilSettled();
+	}
+
+	void moveDistanceAsync(QLength itarget) override {
+		moveRawAsync(itarget.convert(meter) * scales.straight * gearsetRatioPair.ratio);
+	}
+
+	void moveRawAsync(double itarget) override {
+		start(itarget, itarget);
+	}
+
+	void turnAngle(QAngle idegTarget) override {
+		turnAngleAsync(idegTarget);
+		waitUntilSettled();
+	}
+
+	void turnRaw(double idegTarget) override {
+		turnRawAsync(idegTarget);
+		waitUntilSettled();
+	}
+
+	void turnAngleAsync(QAngle idegTarget) override {
+		turnRawAsync(idegTarget.convert(degree) * scales.turn * scales.tpr / 360 * gearsetRatioPair.ratio);
+	}
+
+	void turnRawAsync(double idegTarget) override {
+		const double target = mirrored ? -idegTarget : idegTarget;
+		start(target, -target);
+	}
+
+	void setTurnsMirrored(bool ishouldMirror) override {
+		mirrored = ishouldMirror;
+	}
+
+	bool isSettled() override {
+		if (!running) return true;
+		const bool leftDone = leftSettled->isSettled(left->getPositionError());
+		const bool rightDone = rightSettled->isSettled(right->getPositionError());
+		return leftDone && rightDone;
+	}
+
+	void waitUntilSettled() override {
+		auto rate = timeUtil.getRate();
+		while (!isSettled()) rate->delayUntil(10_ms);
+		stop();
+	}
+
+	void stop() override {
+		running = false;
+		chassisModel->stop();
+	}
+
+	void setMaxVelocity(double imaxVelocity) override {
+		maxVelocity = imaxVelocity;
+		chassisModel->setMaxVelocity(imaxVelocity);
+	}
+
+	double getMaxVelocity() const override {
+		return maxVelocity;
+	}
+
+	ChassisScales getChassisScales() const override {
+		return scales;
+	}
+
+	AbstractMotor::GearsetRatioPair getGearsetRatioPair() const override {
+		return gearsetRatioPair;
+	}
+
+	std::shared_ptr<ChassisModel> getModel() override {
+		return chassisModel;
+	}
+
+	ChassisModel &model() override {
+		return *chassisModel;
+	}
+
+	private:
+	TimeUtil timeUtil;
+	std::shared_ptr<ChassisModel> chassisModel;
+	std::shared_ptr<AbstractMotor> left;
+	std::shared_ptr<AbstractMotor> right;
+	AbstractMotor::GearsetRatioPair gearsetRatioPair;
+	ChassisScales scales;
+	std::unique_ptr<SettledUtil> leftSettled;
+	std::unique_ptr<SettledUtil> rightSettled;
+	double maxVelocity;
+	bool mirrored{false};
+	bool running{false};
+
+	void start(double ileft, double iright) {
+		leftSettled->reset();
+		rightSettled->reset();
+		running = true;
+		left->moveRelative(ileft, maxVelocity);
+		right->moveRelative(iright, maxVelocity);
+	}
+};
+} // namespace
+
+std::string OdomState::str() const {
+	std::ostringstream os;
+	os << "OdomState(x=" << x.convert(meter) << "m, y=" << y.convert(meter)
+	   << "m, theta=" << theta.convert(degree) << "deg)";
+	return os.str();
+}
+
+bool OdomState::operator==(const OdomState &rhs) const {
+	return x == rhs.x && y == rhs.y && theta == rhs.theta;
+}
+
+bool OdomState::operator!=(const OdomState &rhs) const {
+	return !(rhs == *this);
+}
+
+ChassisScales::ChassisScales(const std::initializer_list<QLength> &idimensions,
+                             const std::int32_t itpr,
+                             const std::shared_ptr<Logger> &ilogger) {
+	validateInputSize(idimensions.size(), ilogger);
+	std::vector<QLength> vec(idimensions);
+	wheelDiameter = vec.at(0);
+	wheelTrack = vec.at(1);
+	middleWheelDistance = vec.size() >= 3 ? vec.at(2) : 0_m;
+	middleWheelDiameter = vec.size() >= 4 ? vec.at(3) : wheelDiameter;
+	tpr = itpr;
+	straight = static_cast<double>(tpr / (wheelDiameter.convert(meter) * pi));
+	turn = wheelTrack.convert(meter) / wheelDiameter.convert(meter);
+	middle = static_cast<double>(tpr / (middleWheelDiameter.convert(meter) * pi));
+}
+
+ChassisScales::ChassisScales(const std::initializer_list<double> &iscales,
+                             const std::int32_t itpr,
+                             const std::shared_ptr<Logger> &ilogger) {
+	validateInputSize(iscales.size(), ilogger);
+	std::vector<double> vec(iscales);
+	straight = vec.at(0);
+	turn = vec.at(1);
+	middle = vec.size() >= 4 ? vec.at(3) : straight;
+	tpr = itpr;
+	wheelDiameter = (tpr / (straight * pi)) * meter;
+	wheelTrack = turn * wheelDiameter;
+	middleWheelDistance = (vec.size() >= 3 ? vec.at(2) : 0) * meter;
+	middleWheelDiameter = (tpr / (middle * pi)) * meter;
+}
+
+void ChassisScales::validateInputSize(const std::size_t inputSize, const std::shared_ptr<Logger> &logger) {
+	if (inputSize < 2) {
+		std::string msg = "ChassisScales: The input list must have at least two elements.";
+		if (logger) logger->error([=]() { return msg; });
+		throw std::invalid_argument(msg);
+	}
+}
+
+SkidSteerModel::SkidSteerModel(std::shared_ptr<AbstractMotor> ileftSideMotor,
+                               std::shared_ptr<AbstractMotor> irightSideMotor,
+                               std::shared_ptr<ContinuousRotarySensor> ileftEnc,
+                               std::shared_ptr<ContinuousRotarySensor> irightEnc,
+                               const double imaxVelocity,
+                               const double imaxVoltage)
+  : maxVelocity(imaxVelocity),
+    maxVoltage(imaxVoltage),
+    leftSideMotor(std::move(ileftSideMotor)),
+    rightSideMotor(std::move(irightSideMotor)),
+    leftSensor(std::move(ileftEnc)),
+    rightSensor(std::move(irightEnc)) {}
+
+void SkidSteerModel::forward(const double ispeed) {
+	const double speed = std::clamp(ispeed, -1.0, 1.0);
+	leftSideMotor->moveVelocity(static_cast<std::int16_t>(speed * maxVelocity));
+	rightSideMotor->moveVelocity(static_cast<std::int16_t>(speed * maxVelocity));
+}
+
+void SkidSteerModel::driveVector(const double iforwardSpeed, const double iyaw) {
+	const double forwardSpeed = std::clamp(iforwardSpeed, -1.0, 1.0);
+	const double yaw = std::clamp(iyaw, -1.0, 1.0);
+	double leftOutput = forwardSpeed + yaw;
+	double rightOutput = forwardSpeed - yaw;
+	if (const double maxInputMag = std::max(std::abs(leftOutput), std::abs(rightOutput)); maxInputMag > 1) {
+		leftOutput /= maxInputMag;
+		rightOutput /= maxInputMag;
+	}
+	leftSideMotor->moveVelocity(static_cast<std::int16_t>(leftOutput * maxVelocity));
+	rightSideMotor->moveVelocity(static_cast<std::int16_t>(rightOutput * maxVelocity));
+}
+
+void SkidSteerModel::driveVectorVoltage(const double iforwardSpeed, const double iyaw) {
+	const double forwardSpeed = std::clamp(iforwardSpeed, -1.0, 1.0);
+	const double yaw = std::clamp(iyaw, -1.0, 1.0);
+	double leftOutput = forwardSpeed + yaw;
+	double rightOutput = forwardSpeed - yaw;
+	if (const double maxInputMag = std::max(std::abs(leftOutput), std::abs(rightOutput)); maxInputMag > 1) {
+		leftOutput /= maxInputMag;
+		rightOutput /= maxInputMag;
+	}
+	leftSideMotor->moveVoltage(static_cast<std::int16_t>(leftOutput * maxVoltage));
+	rightSideMotor->moveVoltage(static_cast<std::int16_t>(rightOutput * maxVoltage));
+}
+
+void SkidSteerModel::rotate(const double ispeed) {
+	const double speed = std::clamp(ispeed, -1.0, 1.0);
+	leftSideMotor->moveVelocity(static_cast<std::int16_t>(speed * maxVelocity));
+	rightSideMotor->moveVelocity(static_cast<std::int16_t>(-1 * speed * maxVelocity));
+}
+
+void SkidSteerModel::stop() {
+	leftSideMotor->moveVelocity(0);
+	rightSideMotor->moveVelocity(0);
+}
+
+void SkidSteerModel::tank(const double ileftSpeed, const double irightSpeed, const double ithreshold) {
+	double leftSpeed = std::clamp(ileftSpeed, -1.0, 1.0);
+	if (std::abs(leftSpeed) < ithreshold) leftSpeed = 0;
+	double rightSpeed = std::clamp(irightSpeed, -1.0, 1.0);
+	if (std::abs(rightSpeed) < ithreshold) rightSpeed = 0;
+	leftSideMotor->moveVoltage(static_cast<std::int16_t>(leftSpeed * maxVoltage));
+	rightSideMotor->moveVoltage(static_cast<std::int16_t>(rightSpeed * maxVoltage));
+}
+
+void SkidSteerModel::arcade(const double iforwardSpeed, const double iyaw, const double ithreshold) {
+	double forwardSpeed = std::clamp(iforwardSpeed, -1.0, 1.0);
+	if (std::abs(forwardSpeed) <= ithreshold) forwardSpeed = 0;
+	double yaw = std::clamp(iyaw, -1.0, 1.0);
+	if (std::abs(yaw) <= ithreshold) yaw = 0;
+	double leftOutput = forwardSpeed + yaw;
+	double rightOutput = forwardSpeed - yaw;
+	if (const double maxInputMag = std::max(std::abs(leftOutput), std::abs(rightOutput)); maxInputMag > 1) {
+		leftOutput /= maxInputMag;
+		rightOutput /= maxInputMag;
+	}
+	leftSideMotor->moveVoltage(static_cast<std::int16_t>(leftOutput * maxVoltage));
+	rightSideMotor->moveVoltage(static_cast<std::int16_t>(rightOutput * maxVoltage));
+}
+
+void SkidSteerModel::left(const double ispeed) {
+	leftSideMotor->moveVelocity(static_cast<std::int16_t>(std::clamp(ispeed, -1.0, 1.0) * maxVelocity));
+}
+
+void SkidSteerModel::right(const double ispeed) {
+	rightSideMotor->moveVelocity(static_cast<std::int16_t>(std::clamp(ispeed, -1.0, 1.0) * maxVelocity));
+}
+
+std::valarray<std::int32_t> SkidSteerModel::getSensorVals() const {
+	return std::valarray<std::int32_t>{static_cast<std::int32_t>(leftSensor->get()),
+	                                   static_cast<std::int32_t>(rightSensor->get())};
+}
+
+void SkidSteerModel::resetSensors() {
+	leftSensor->reset();
+	rightSensor->reset();
+}
+
+void SkidSteerModel::setBrakeMode(const AbstractMotor::brakeMode mode) {
+	leftSideMotor->setBrakeMode(mode);
+	rightSideMotor->setBrakeMode(mode);
+}
+
+void SkidSteerModel::setEncoderUnits(const AbstractMotor::encoderUnits units) {
+	leftSideMotor->setEncoderUnits(units);
+	rightSideMotor->setEncoderUnits(units);
+}
+
+void SkidSteerModel::setGearing(const AbstractMotor::gearset gearset) {
+	leftSideMotor->setGearing(gearset);
+	rightSideMotor->setGearing(gearset);
+}
+
+void SkidSteerModel::setMaxVelocity(const double imaxVelocity) {
+	maxVelocity = std::max(imaxVelocity, 0.0);
+}
+
+double SkidSteerModel::getMaxVelocity() const {
+	return maxVelocity;
+}
+
+void SkidSteerModel::setMaxVoltage(const double imaxVoltage) {
+	maxVoltage = std::clamp(imaxVoltage, 0.0, 12000.0);
+}
+
+double SkidSteerModel::getMaxVoltage() const {
+	return maxVoltage;
+}
+
+std::shared_ptr<AbstractMotor> SkidSteerModel::getLeftSideMotor() const {
+	return leftSideMotor;
+}
+
+std::shared_ptr<AbstractMotor> SkidSteerModel::getRightSideMotor() const {
+	return rightSideMotor;
+}
+
+ThreeEncoderSkidSteerModel::ThreeEncoderSkidSteerModel(std::shared_ptr<AbstractMotor> ileftSideMotor,
+                                                       std::shared_ptr<AbstractMotor> irightSideMotor,
+                                                       std::shared_ptr<ContinuousRotarySensor> ileftEnc,
+                                                       std::shared_ptr<ContinuousRotarySensor> irightEnc,
+                                                       std::shared_ptr<ContinuousRotarySensor> imiddleEnc,
+                                                       const double imaxVelocity,
+                                                       const double imaxVoltage)
+  : SkidSteerModel(std::move(ileftSideMotor),
+                   std::move(irightSideMotor),
+                   std::move(ileftEnc),
+                   std::move(irightEnc),
+                   imaxVelocity,
+                   imaxVoltage),
+    middleSensor(std::move(imiddleEnc)) {}
+
+std::valarray<std::int32_t> ThreeEncoderSkidSteerModel::getSensorVals() const {
+	return std::valarray<std::int32_t>{static_cast<std::int32_t>(leftSensor->get()),
+	                                   static_cast<std::int32_t>(rightSensor->get()),
+	                                   static_cast<std::int32_t>(middleSensor->get())};
+}
+
+void ThreeEncoderSkidSteerModel::resetSensors() {
+	SkidSteerModel::resetSensors();
+	middleSensor->reset();
+}
+
+TwoEncoderOdometry::TwoEncoderOdometry(const TimeUtil &itimeUtil,
+                                       const std::shared_ptr<ReadOnlyChassisModel> &imodel,
+                                       const ChassisScales &ichassisScales,
+                                       const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger),
+    rate(itimeUtil.getRate()),
+    timer(itimeUtil.getTimer()),
+    model(imodel),
+    chassisScales(ichassisScales) {}
+
+void TwoEncoderOdometry::setScales(const ChassisScales &ichassisScales) {
+	chassisScales = ichassisScales;
+}
+
+void TwoEncoderOdometry::step() {
+	const auto deltaT = timer->getDt();
+	if (deltaT.getValue() != 0) {
+		newTicks = model->getSensorVals();
+		tickDiff = newTicks - lastTicks;
+		lastTicks = newTicks;
+		const auto newState = odomMathStep(tickDiff, deltaT);
+		state.x += newState.x;
+		state.y += newState.y;
+		state.theta += newState.theta;
+	}
+}
+
+OdomState TwoEncoderOdometry::odomMathStep(const std::valarray<std::int32_t> &itickDiff, const QTime &) {
+	if (itickDiff.size() < 2) {
+		LOG_ERROR_S("TwoEncoderOdometry: itickDiff did not have at least two elements.");
+		return OdomState{};
+	}
+	for (auto &&elem : itickDiff) {
+		if (std::abs(elem) > maximumTickDiff) {
+			LOG_ERROR("TwoEncoderOdometry: A tick diff (" + std::to_string(elem) + ") was greater than the maximum allowable diff (" + std::to_string(maximumTickDiff) + "). Skipping this odometry step.");
+			return OdomState{};
+		}
+	}
+
+	const double deltaL = itickDiff[0] / chassisScales.straight;
+	const double deltaR = itickDiff[1] / chassisScales.straight;
+	const double deltaTheta = (deltaL - deltaR) / chassisScales.wheelTrack.convert(meter);
+	double localOffX, localOffY;
+	if (deltaTheta != 0) {
+		localOffX = 2 * std::sin(deltaTheta / 2) * chassisScales.middleWheelDistance.convert(meter);
+		localOffY = 2 * std::sin(deltaTheta / 2) * (deltaR / deltaTheta + chassisScales.wheelTrack.convert(meter) / 2);
+	} else {
+		localOffX = 0;
+		localOffY = deltaR;
+	}
+
+	const double avgA = state.theta.convert(radian) + (deltaTheta / 2);
+	const double polarR = std::sqrt((localOffX * localOffX) + (localOffY * localOffY));
+	const double polarA = std::atan2(localOffY, localOffX) - avgA;
+	double dX = std::sin(polarA) * polarR;
+	double dY = std::cos(polarA) * polarR;
+	if (std::isnan(dX)) dX = 0;
+	if (std::isnan(dY)) dY = 0;
+	return OdomState{dX * meter, dY * meter, deltaTheta * radian};
+}
+
+OdomState TwoEncoderOdometry::getState(const StateMode &imode) const {
+	if (imode == StateMode::FRAME_TRANSFORMATION) return state;
+	return OdomState{state.y, state.x, state.theta};
+}
+
+void TwoEncoderOdometry::setState(const OdomState &istate, const StateMode &imode) {
+	if (imode == StateMode::FRAME_TRANSFORMATION) state = istate;
+	else state = OdomState{istate.y, istate.x, istate.theta};
+}
+
+std::shared_ptr<ReadOnlyChassisModel> TwoEncoderOdometry::getModel() {
+	return model;
+}
+
+ChassisScales TwoEncoderOdometry::getScales() {
+	return chassisScales;
+}
+
+std::pair<double, double> OdomMath::computeDiffs(const Point &ipoint, const OdomState &istate) {
+	return {ipoint.x.convert(meter) - istate.x.convert(meter), ipoint.y.convert(meter) - istate.y.convert(meter)};
+}
+
+double OdomMath::computeDistance(const double xDiff, const double yDiff) {
+	return std::sqrt(xDiff * xDiff + yDiff * yDiff);
+}
+
+double OdomMath::computeAngle(const double xDiff, const double yDiff, const double theta) {
+	return std::remainder(std::atan2(yDiff, xDiff) - theta, 2 * pi);
+}
+
+QLength OdomMath::computeDistanceToPoint(const Point &ipoint, const OdomState &istate) {
+	const auto [xDiff, yDiff] = computeDiffs(ipoint, istate);
+	return computeDistance(xDiff, yDiff) * meter;
+}
+
+QAngle OdomMath::computeAngleToPoint(const Point &ipoint, const OdomState &istate) {
+	const auto [xDiff, yDiff] = computeDiffs(ipoint, istate);
+	return computeAngle(xDiff, yDiff, istate.theta.convert(radian)) * radian;
+}
+
+std::pair<QLength, QAngle> OdomMath::computeDistanceAndAngleToPoint(const Point &ipoint, const OdomState &istate) {
+	const auto [xDiff, yDiff] = computeDiffs(ipoint, istate);
+	return {computeDistance(xDiff, yDiff) * meter, computeAngle(xDiff, yDiff, istate.theta.convert(radian)) * radian};
+}
+
+OdomChassisController::OdomChassisController(TimeUtil itimeUtil,
+                                             std::unique_ptr<Odometry> iodometry,
+                                             const StateMode &imode,
+                                             const QLength &imoveThreshold,
+                                             const QAngle &iturnThreshold,
+                                             std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    timeUtil(std::move(itimeUtil)),
+    moveThreshold(imoveThreshold),
+    turnThreshold(iturnThreshold),
+    odom(std::move(iodometry)),
+    defaultStateMode(imode) {}
+
+OdomChassisController::~OdomChassisController() {
+	dtorCalled.store(true, std::memory_order_release);
+	delete odomTask;
+}
+
+void OdomChassisController::startOdomThread() {
+	if (!odomTask) odomTask = new CrossplatformThread(trampoline, this, "OdomChassisController");
+}
+
+CrossplatformThread *OdomChassisController::getOdomThread() const {
+	return odomTask;
+}
+
+void OdomChassisController::trampoline(void *context) {
+	if (context) static_cast<OdomChassisController *>(context)->loop();
+}
+
+void OdomChassisController::loop() {
+	auto rate = timeUtil.getRate();
+	odomTaskRunning = true;
+	while (!dtorCalled.load(std::memory_order_acquire) && !odomTask->notifyTake(0)) {
+		odom->step();
+		rate->delayUntil(10_ms);
+	}
+	odomTaskRunning = false;
+}
+
+OdomState OdomChassisController::getState() const {
+	return odom->getState(defaultStateMode);
+}
+
+void OdomChassisController::setState(const OdomState &istate) {
+	odom->setState(istate, defaultStateMode);
+}
+
+void OdomChassisController::setDefaultStateMode(const StateMode &imode) {
+	defaultStateMode = imode;
+}
+
+void OdomChassisController::setMoveThreshold(const QLength &imoveThreshold) {
+	moveThreshold = imoveThreshold;
+}
+
+void OdomChassisController::setTurnThreshold(const QAngle &iturnTreshold) {
+	turnThreshold = iturnTreshold;
+}
+
+QLength OdomChassisController::getMoveThreshold() const {
+	return moveThreshold;
+}
+
+QAngle OdomChassisController::getTurnThreshold() const {
+	return turnThreshold;
+}
+
+DefaultOdomChassisController::DefaultOdomChassisController(const TimeUtil &itimeUtil,
+                                                           std::unique_ptr<Odometry> iodometry,
+                                                           std::shared_ptr<ChassisController> icontroller,
+                                                           const StateMode &imode,
+                                                           const QLength imoveThreshold,
+                                                           const QAngle iturnThreshold,
+                                                           std::shared_ptr<Logger> ilogger)
+  : OdomChassisController(itimeUtil, std::move(iodometry), imode, imoveThreshold, iturnThreshold, ilogger),
+    logger(std::move(ilogger)),
+    controller(std::move(icontroller)) {}
+
+void DefaultOdomChassisController::driveToPoint(const Point &ipoint, const bool ibackwards, const QLength &ioffset) {
+	waitForOdomTask();
+	auto [length, angle] = OdomMath::computeDistanceAndAngleToPoint(
+	  ipoint.inFT(defaultStateMode), odom->getState(StateMode::FRAME_TRANSFORMATION));
+	if (ibackwards) {
+		length *= -1;
+		angle += 180_deg;
+	}
+	length -= ioffset;
+	if (angle.abs() > turnThreshold) controller->turnAngle(angle);
+	if (length.abs() > moveThreshold) controller->moveDistance(length);
+}
+
+void DefaultOdomChassisController::turnToPoint(const Point &ipoint) {
+	waitForOdomTask();
+	const auto angle = OdomMath::computeAngleToPoint(ipoint.inFT(defaultStateMode), odom->getState(StateMode::FRAME_TRANSFORMATION));
+	if (angle.abs() > turnThreshold) controller->turnAngle(angle);
+}
+
+void DefaultOdomChassisController::turnToAngle(const QAngle &iangle) {
+	waitForOdomTask();
+	const auto angle = iangle - odom->getState(StateMode::FRAME_TRANSFORMATION).theta;
+	if (angle.abs() > turnThreshold) controller->turnAngle(angle);
+}
+
+void DefaultOdomChassisController::moveDistance(const QLength itarget) {
+	controller->moveDistance(itarget);
+}
+
+void DefaultOdomChassisController::moveRaw(const double itarget) {
+	controller->moveRaw(itarget);
+}
+
+void DefaultOdomChassisController::moveDistanceAsync(const QLength itarget) {
+	controller->moveDistanceAsync(itarget);
+}
+
+void DefaultOdomChassisController::moveRawAsync(const double itarget) {
+	controller->moveRawAsync(itarget);
+}
+
+void DefaultOdomChassisController::turnAngle(const QAngle idegTarget) {
+	controller->turnAngle(idegTarget);
+}
+
+void DefaultOdomChassisController::turnRaw(const double idegTarget) {
+	controller->turnRaw(idegTarget);
+}
+
+void DefaultOdomChassisController::turnAngleAsync(const QAngle idegTarget) {
+	controller->turnAngleAsync(idegTarget);
+}
+
+void DefaultOdomChassisController::turnRawAsync(const double idegTarget) {
+	controller->turnRawAsync(idegTarget);
+}
+
+void DefaultOdomChassisController::setTurnsMirrored(const bool ishouldMirror) {
+	controller->setTurnsMirrored(ishouldMirror);
+}
+
+bool DefaultOdomChassisController::isSettled() {
+	return controller->isSettled();
+}
+
+void DefaultOdomChassisController::waitUntilSettled() {
+	controller->waitUntilSettled();
+}
+
+void DefaultOdomChassisController::stop() {
+	controller->stop();
+}
+
+void DefaultOdomChassisController::setMaxVelocity(const double imaxVelocity) {
+	controller->setMaxVelocity(imaxVelocity);
+}
+
+double DefaultOdomChassisController::getMaxVelocity() const {
+	return controller->getMaxVelocity();
+}
+
+ChassisScales DefaultOdomChassisController::getChassisScales() const {
+	return controller->getChassisScales();
+}
+
+AbstractMotor::GearsetRatioPair DefaultOdomChassisController::getGearsetRatioPair() const {
+	return controller->getGearsetRatioPair();
+}
+
+std::shared_ptr<ChassisModel> DefaultOdomChassisController::getModel() {
+	return controller->getModel();
+}
+
+ChassisModel &DefaultOdomChassisController::model() {
+	return controller->model();
+}
+
+std::shared_ptr<ChassisController> DefaultOdomChassisController::getChassisController() {
+	return controller;
+}
+
+ChassisController &DefaultOdomChassisController::chassisController() {
+	return *controller;
+}
+
+void DefaultOdomChassisController::waitForOdomTask() {
+	auto rate = timeUtil.getRate();
+	while (!odomTaskRunning) rate->delayUntil(10_ms);
+}
+
+ChassisControllerBuilder::ChassisControllerBuilder(const std::shared_ptr<Logger> &ilogger) : logger(ilogger) {}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withMotors(const Motor &ileft, const Motor &iright) {
+	return withMotors(std::make_shared<Motor>(ileft), std::make_shared<Motor>(iright));
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withMotors(const MotorGroup &ileft, const MotorGroup &iright) {
+	return withMotors(std::make_shared<MotorGroup>(ileft), std::make_shared<MotorGroup>(iright));
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withMotors(const std::shared_ptr<AbstractMotor> &ileft,
+                                                               const std::shared_ptr<AbstractMotor> &iright) {
+	hasMotors = true;
+	driveMode = DriveMode::SkidSteer;
+	skidSteerMotors = {ileft, iright};
+	if (!sensorsSetByUser) {
+		leftSensor = ileft->getEncoder();
+		rightSensor = iright->getEncoder();
+	}
+	if (!maxVelSetByUser) maxVelocity = toUnderlyingType(ileft->getGearing());
+	return *this;
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withSensors(const ADIEncoder &ileft, const ADIEncoder &iright) {
+	return withSensors(std::make_shared<ADIEncoder>(ileft), std::make_shared<ADIEncoder>(iright));
+}
+
+ChassisControllerBuilder &
+ChassisControllerBuilder::withSensors(const ADIEncoder &ileft, const ADIEncoder &iright, const ADIEncoder &imiddle) {
+	return withSensors(std::make_shared<ADIEncoder>(ileft), std::make_shared<ADIEncoder>(iright), std::make_shared<ADIEncoder>(imiddle));
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withSensors(const IntegratedEncoder &ileft,
+                                                                const IntegratedEncoder &iright) {
+	return withSensors(std::make_shared<IntegratedEncoder>(ileft), std::make_shared<IntegratedEncoder>(iright));
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withSensors(const IntegratedEncoder &ileft,
+                                                                const IntegratedEncoder &iright,
+                                                                const ADIEncoder &imiddle) {
+	return withSensors(std::make_shared<IntegratedEncoder>(ileft), std::make_shared<IntegratedEncoder>(iright), std::make_shared<ADIEncoder>(imiddle));
+}
+
+ChassisControllerBuilder &
+ChassisControllerBuilder::withSensors(const std::shared_ptr<ContinuousRotarySensor> &ileft,
+                                      const std::shared_ptr<ContinuousRotarySensor> &iright) {
+	sensorsSetByUser = true;
+	leftSensor = ileft;
+	rightSensor = iright;
+	return *this;
+}
+
+ChassisControllerBuilder &
+ChassisControllerBuilder::withSensors(const std::shared_ptr<ContinuousRotarySensor> &ileft,
+                                      const std::shared_ptr<ContinuousRotarySensor> &iright,
+                                      const std::shared_ptr<ContinuousRotarySensor> &imiddle) {
+	withSensors(ileft, iright);
+	middleSensor = imiddle;
+	return *this;
+}
+
+ChassisControllerBuilder &
+ChassisControllerBuilder::withOdometry(const StateMode &imode, const QLength &imoveThreshold, const QAngle &iturnThreshold) {
+	hasOdom = true;
+	odometry = nullptr;
+	stateMode = imode;
+	moveThreshold = imoveThreshold;
+	turnThreshold = iturnThreshold;
+	return *this;
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withOdometry(const ChassisScales &iodomScales,
+                                                                 const StateMode &imode,
+                                                                 const QLength &imoveThreshold,
+                                                                 const QAngle &iturnThreshold) {
+	withOdometry(imode, imoveThreshold, iturnThreshold);
+	differentOdomScales = true;
+	odomScales = iodomScales;
+	return *this;
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withOdometry(std::unique_ptr<Odometry> iodometry,
+                                                                 const StateMode &imode,
+                                                                 const QLength &imoveThreshold,
+                                                                 const QAngle &iturnThreshold) {
+	withOdometry(imode, imoveThreshold, iturnThreshold);
+	odometry = std::move(iodometry);
+	return *this;
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withDimensions(const AbstractMotor::gearset &igearset,
+                                                                   const ChassisScales &iscales) {
+	gearset = igearset;
+	if (!maxVelSetByUser) maxVelocity = toUnderlyingType(igearset);
+	driveScales = iscales;
+	return *this;
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withMaxVelocity(const double imaxVelocity) {
+	maxVelSetByUser = true;
+	maxVelocity = imaxVelocity;
+	return *this;
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withMaxVoltage(const double imaxVoltage) {
+	maxVoltage = imaxVoltage;
+	return *this;
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withOdometryTimeUtilFactory(const TimeUtilFactory &itimeUtilFactory) {
+	odometryTimeUtilFactory = itimeUtilFactory;
+	return *this;
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withLogger(const std::shared_ptr<Logger> &ilogger) {
+	controllerLogger = ilogger;
+	return *this;
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::parentedToCurrentTask() {
+	isParentedToCurrentTask = true;
+	return *this;
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::notParentedToCurrentTask() {
+	isParentedToCurrentTask = false;
+	return *this;
+}
+
+std::shared_ptr<ChassisController> ChassisControllerBuilder::build() {
+	if (!hasMotors) {
+		std::string msg("ChassisControllerBuilder: No motors given.");
+		LOG_ERROR(msg);
+		throw std::runtime_error(msg);
+	}
+	if (hasGains) {
+		std::string msg("ChassisControllerBuilder: The PID chassis controller is not simulated, leave out withGains.");
+		LOG_ERROR(msg);
+		throw std::runtime_error(msg);
+	}
+	auto model = makeChassisModel();
+	return std::make_shared<IntegratedChassis>(chassisControllerTimeUtilFactory.create(),
+	                                           model,
+	                                           skidSteerMotors.left,
+	                                           skidSteerMotors.right,
+	                                           gearset,
+	                                           driveScales);
+}
+
+std::shared_ptr<OdomChassisController> ChassisControllerBuilder::buildOdometry() {
+	if (!hasOdom) {
+		std::string msg("ChassisControllerBuilder: No odometry information given.");
+		LOG_ERROR(msg);
+		throw std::runtime_error(msg);
+	}
+	return buildDOCC(build());
+}
+
+std::shared_ptr<DefaultOdomChassisController>
+ChassisControllerBuilder::buildDOCC(std::shared_ptr<ChassisController> chassisController) {
+	if (!differentOdomScales) odomScales = driveScales;
+	if (!odometry) {
+		if (middleSensor) {
+			std::string msg("ChassisControllerBuilder: Three encoder odometry is not simulated yet.");
+			LOG_ERROR(msg);
+			throw std::runtime_error(msg);
+		}
+		odometry = std::make_unique<TwoEncoderOdometry>(
+		  odometryTimeUtilFactory.create(), chassisController->getModel(), odomScales, controllerLogger);
+	}
+
+	auto out = std::make_shared<DefaultOdomChassisController>(chassisControllerTimeUtilFactory.create(),
+	                                                          std::move(odometry),
+	                                                          chassisController,
+	                                                          stateMode,
+	                                                          moveThreshold,
+	                                                          turnThreshold,
+	                                                          controllerLogger);
+	out->startOdomThread();
+	if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
+		out->getOdomThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+	}
+	return out;
+}
+
+std::shared_ptr<ChassisModel> ChassisControllerBuilder::makeChassisModel() {
+	return makeSkidSteerModel();
+}
+
+std::shared_ptr<SkidSteerModel> ChassisControllerBuilder::makeSkidSteerModel() {
+	if (middleSensor) {
+		return std::make_shared<ThreeEncoderSkidSteerModel>(
+		  skidSteerMotors.left, skidSteerMotors.right, leftSensor, rightSensor, middleSensor, maxVelocity, maxVoltage);
+	}
+	return std::make_shared<SkidSteerModel>(
+	  skidSteerMotors.left, skidSteerMotors.right, leftSensor, rightSensor, maxVelocity, maxVoltage);
+}
+
+} // namespace okapi
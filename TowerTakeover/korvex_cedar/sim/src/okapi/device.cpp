@@ -0,0 +1,565 @@
+#include "okapi/api.hpp"
+
+// host builds of the okapi device wrappers, they sit on the pros c api just like the real ones
+// so everything they do ends up at the simulated robot
+
+namespace okapi {
+
+namespace {
+pros::motor_gearset_e_t toPros(AbstractMotor::gearset igearset) {
+	switch (igearset) {
+	case AbstractMotor::gearset::red: return pros::E_MOTOR_GEARSET_36;
+	case AbstractMotor::gearset::blue: return pros::E_MOTOR_GEARSET_06;
+	default: return pros::E_MOTOR_GEARSET_18;
+	}
+}
+
+AbstractMotor::gearset fromPros(pros::motor_gearset_e_t igearset) {
+	switch (igearset) {
+	case pros::E_MOTOR_GEARSET_36: return AbstractMotor::gearset::red;
+	case pros::E_MOTOR_GEARSET_06: return AbstractMotor::gearset::blue;
+	case pros::E_MOTOR_GEARSET_18: return AbstractMotor::gearset::green;
+	default: return AbstractMotor::gearset::invalid;
+	}
+}
+
+// the first failure in a group wins, like okapi
+std::int32_t firstError(std::int32_t iout, std::int32_t inext) {
+	return iout == PROS_ERR ? iout : inext;
+}
+} // namespace
+
+AbstractMotor::~AbstractMotor() = default;
+
+double AbstractMotor::getPositionError() {
+	return getTargetPosition() - getPosition();
+}
+
+double AbstractMotor::getVelocityError() {
+	return getTargetVelocity() - getActualVelocity();
+}
+
+AbstractMotor::GearsetRatioPair operator*(const AbstractMotor::gearset gearset, const double ratio) {
+	return AbstractMotor::GearsetRatioPair(gearset, ratio);
+}
+
+RotarySensor::~RotarySensor() = default;
+
+Motor::Motor(const std::int8_t iport)
+  : Motor(std::abs(iport), iport < 0, AbstractMotor::gearset::green, AbstractMotor::encoderUnits::degrees) {}
+
+Motor::Motor(const std::uint8_t iport,
+             const bool ireverse,
+             const AbstractMotor::gearset igearset,
+             const AbstractMotor::encoderUnits iencoderUnits,
+             const std::shared_ptr<Logger> &)
+  : port(iport), reversed(ireverse ? -1 : 1) {
+	setGearing(igearset);
+	setEncoderUnits(iencoderUnits);
+}
+
+std::int32_t Motor::moveAbsolute(const double iposition, const std::int32_t ivelocity) {
+	return pros::c::motor_move_absolute(port, iposition * reversed, ivelocity);
+}
+
+std::int32_t Motor::moveRelative(const double iposition, const std::int32_t ivelocity) {
+	return pros::c::motor_move_relative(port, iposition * reversed, ivelocity);
+}
+
+std::int32_t Motor::moveVelocity(const std::int16_t ivelocity) {
+	return pros::c::motor_move_velocity(port, ivelocity * reversed);
+}
+
+std::int32_t Motor::moveVoltage(const std::int16_t ivoltage) {
+	return pros::c::motor_move_voltage(port, ivoltage * reversed);
+}
+
+std::int32_t Motor::modifyProfiledVelocity(std::int32_t ivelocity) {
+	return pros::c::motor_modify_profiled_velocity(port, ivelocity);
+}
+
+double Motor::getTargetPosition() {
+	return pros::c::motor_get_target_position(port) * reversed;
+}
+
+double Motor::getPosition() {
+	return pros::c::motor_get_position(port) * reversed;
+}
+
+std::int32_t Motor::tarePosition() {
+	return pros::c::motor_tare_position(port);
+}
+
+std::int32_t Motor::getTargetVelocity() {
+	return pros::c::motor_get_target_velocity(port) * reversed;
+}
+
+double Motor::getActualVelocity() {
+	return pros::c::motor_get_actual_velocity(port) * reversed;
+}
+
+std::int32_t Motor::getCurrentDraw() {
+	return pros::c::motor_get_current_draw(port);
+}
+
+std::int32_t Motor::getDirection() {
+	return pros::c::motor_get_direction(port) * reversed;
+}
+
+double Motor::getEfficiency() {
+	return pros::c::motor_get_efficiency(port);
+}
+
+std::int32_t Motor::isOverCurrent() {
+	return pros::c::motor_is_over_current(port);
+}
+
+std::int32_t Motor::isOverTemp() {
+	return pros::c::motor_is_over_temp(port);
+}
+
+std::int32_t Motor::isStopped() {
+	return pros::c::motor_is_stopped(port);
+}
+
+std::int32_t Motor::getZeroPositionFlag() {
+	return pros::c::motor_get_zero_position_flag(port);
+}
+
+uint32_t Motor::getFaults() {
+	return pros::c::motor_get_faults(port);
+}
+
+uint32_t Motor::getFlags() {
+	return pros::c::motor_get_flags(port);
+}
+
+std::int32_t Motor::getRawPosition(std::uint32_t *timestamp) {
+	return pros::c::motor_get_raw_position(port, timestamp) * reversed;
+}
+
+double Motor::getPower() {
+	return pros::c::motor_get_power(port);
+}
+
+double Motor::getTemperature() {
+	return pros::c::motor_get_temperature(port);
+}
+
+double Motor::getTorque() {
+	return pros::c::motor_get_torque(port);
+}
+
+std::int32_t Motor::getVoltage() {
+	return pros::c::motor_get_voltage(port) * reversed;
+}
+
+std::int32_t Motor::setBrakeMode(const AbstractMotor::brakeMode imode) {
+	return pros::c::motor_set_brake_mode(port, static_cast<pros::motor_brake_mode_e_t>(imode));
+}
+
+AbstractMotor::brakeMode Motor::getBrakeMode() {
+	return static_cast<brakeMode>(pros::c::motor_get_brake_mode(port));
+}
+
+std::int32_t Motor::setCurrentLimit(const std::int32_t ilimit) {
+	return pros::c::motor_set_current_limit(port, ilimit);
+}
+
+std::int32_t Motor::getCurrentLimit() {
+	return pros::c::motor_get_current_limit(port);
+}
+
+std::int32_t Motor::setEncoderUnits(const AbstractMotor::encoderUnits iunits) {
+	return pros::c::motor_set_encoder_units(port, static_cast<pros::motor_encoder_units_e_t>(iunits));
+}
+
+AbstractMotor::encoderUnits Motor::getEncoderUnits() {
+	return static_cast<encoderUnits>(pros::c::motor_get_encoder_units(port));
+}
+
+std::int32_t Motor::setGearing(const AbstractMotor::gearset igearset) {
+	return pros::c::motor_set_gearing(port, toPros(igearset));
+}
+
+AbstractMotor::gearset Motor::getGearing() {
+	return fromPros(pros::c::motor_get_gearing(port));
+}
+
+std::int32_t Motor::setReversed(const bool ireverse) {
+	reversed = ireverse ? -1 : 1;
+	return 1;
+}
+
+std::int32_t Motor::setVoltageLimit(const std::int32_t ilimit) {
+	return pros::c::motor_set_voltage_limit(port, ilimit);
+}
+
+std::int32_t Motor::setPosPID(const double ikF, const double ikP, const double ikI, const double ikD) {
+	return pros::c::motor_set_pos_pid(port, pros::c::motor_convert_pid(ikF, ikP, ikI, ikD));
+}
+
+std::int32_t Motor::setPosPIDFull(const double ikF,
+                                  const double ikP,
+                                  const double ikI,
+                                  const double ikD,
+                                  const double ifilter,
+                                  const double ilimit,
+                                  const double ithreshold,
+                                  const double iloopSpeed) {
+	return pros::c::motor_set_pos_pid_full(
+	  port, pros::c::motor_convert_pid_full(ikF, ikP, ikI, ikD, ifilter, ilimit, ithreshold, iloopSpeed));
+}
+
+std::int32_t Motor::setVelPID(const double ikF, const double ikP, const double ikI, const double ikD) {
+	return pros::c::motor_set_vel_pid(port, pros::c::motor_convert_pid(ikF, ikP, ikI, ikD));
+}
+
+std::int32_t Motor::setVelPIDFull(const double ikF,
+                                  const double ikP,
+                                  const double ikI,
+                                  const double ikD,
+                                  const double ifilter,
+                                  const double ilimit,
+                                  const double ithreshold,
+                                  const double iloopSpeed) {
+	return pros::c::motor_set_vel_pid_full(
+	  port, pros::c::motor_convert_pid_full(ikF, ikP, ikI, ikD, ifilter, ilimit, ithreshold, iloopSpeed));
+}
+
+std::shared_ptr<ContinuousRotarySensor> Motor::getEncoder() {
+	return std::make_shared<IntegratedEncoder>(*this);
+}
+
+void Motor::controllerSet(const double ivalue) {
+	moveVelocity(ivalue * toUnderlyingType(getGearing()));
+}
+
+std::uint8_t Motor::getPort() const {
+	return port;
+}
+
+bool Motor::isReversed() const {
+	return reversed < 0;
+}
+
+MotorGroup::MotorGroup(const std::initializer_list<Motor> &imotors, const std::shared_ptr<Logger> &) {
+	for (auto &motor : imotors) motors.push_back(std::make_shared<Motor>(motor));
+}
+
+MotorGroup::MotorGroup(const std::initializer_list<std::shared_ptr<AbstractMotor>> &imotors,
+                       const std::shared_ptr<Logger> &)
+  : motors(imotors) {}
+
+std::int32_t MotorGroup::moveAbsolute(const double iposition, const std::int32_t ivelocity) {
+	std::int32_t out = 1;
+	for (auto &motor : motors) out = firstError(out, motor->moveAbsolute(iposition, ivelocity));
+	return out;
+}
+
+std::int32_t MotorGroup::moveRelative(const double iposition, const std::int32_t ivelocity) {
+	std::int32_t out = 1;
+	for (auto &motor : motors) out = firstError(out, motor->moveRelative(iposition, ivelocity));
+	return out;
+}
+
+std::int32_t MotorGroup::moveVelocity(const std::int16_t ivelocity) {
+	std::int32_t out = 1;
+	for (auto &motor : motors) out = firstError(out, motor->moveVelocity(ivelocity));
+	return out;
+}
+
+std::int32_t MotorGroup::moveVoltage(const std::int16_t ivoltage) {
+	std::int32_t out = 1;
+	for (auto &motor : motors) out = firstError(out, motor->moveVoltage(ivoltage));
+	return out;
+}
+
+std::int32_t MotorGroup::modifyProfiledVelocity(const std::int32_t ivelocity) {
+	std::int32_t out = 1;
+	for (auto &motor : motors) out = firstError(out, motor->modifyProfiledVelocity(ivelocity));
+	return out;
+}
+
+double MotorGroup::getTargetPosition() {
+	return motors[0]->getTargetPosition();
+}
+
+double MotorGroup::getPosition() {
+	return motors[0]->getPosition();
+}
+
+std::int32_t MotorGroup::tarePosition() {
+	std::int32_t out = 1;
+	for (auto &motor : motors) out = firstError(out, motor->tarePosition());
+	return out;
+}
+
+std::int32_t MotorGroup::getTargetVelocity() {
+	return motors[0]->getTargetVelocity();
+}
+
+double MotorGroup::getActualVelocity() {
+	return motors[0]->getActualVelocity();
+}
+
+std::int32_t MotorGroup::getCurrentDraw() {
+	return motors[0]->getCurrentDraw();
+}
+
+std::int32_t MotorGroup::getDirection() {
+	return motors[0]->getDirection();
+}
+
+double MotorGroup::getEfficiency() {
+	return motors[0]->getEfficiency();
+}
+
+std::int32_t MotorGroup::isOverCurrent() {
+	return motors[0]->isOverCurrent();
+}
+
+std::int32_t MotorGroup::isOverTemp() {
+	return motors[0]->isOverTemp();
+}
+
+std::int32_t MotorGroup::isStopped() {
+	return motors[0]->isStopped();
+}
+
+std::int32_t MotorGroup::getZeroPositionFlag() {
+	return motors[0]->getZeroPositionFlag();
+}
+
+uint32_t MotorGroup::getFaults() {
+	return motors[0]->getFaults();
+}
+
+uint32_t MotorGroup::getFlags() {
+	return motors[0]->getFlags();
+}
+
+std::int32_t MotorGroup::getRawPosition(std::uint32_t *timestamp) {
+	return motors[0]->getRawPosition(timestamp);
+}
+
+double MotorGroup::getPower() {
+	return motors[0]->getPower();
+}
+
+double MotorGroup::getTemperature() {
+	return motors[0]->getTemperature();
+}
+
+double MotorGroup::getTorque() {
+	return motors[0]->getTorque();
+}
+
+std::int32_t MotorGroup::getVoltage() {
+	return motors[0]->getVoltage();
+}
+
+std::int32_t MotorGroup::setBrakeMode(const AbstractMotor::brakeMode imode) {
+	std::int32_t out = 1;
+	for (auto &motor : motors) out = firstError(out, motor->setBrakeMode(imode));
+	return out;
+}
+
+AbstractMotor::brakeMode MotorGroup::getBrakeMode() {
+	return motors[0]->getBrakeMode();
+}
+
+std::int32_t MotorGroup::setCurrentLimit(const std::int32_t ilimit) {
+	std::int32_t out = 1;
+	for (auto &motor : motors) out = firstError(out, motor->setCurrentLimit(ilimit));
+	return out;
+}
+
+std::int32_t MotorGroup::getCurrentLimit() {
+	return motors[0]->getCurrentLimit();
+}
+
+std::int32_t MotorGroup::setEncoderUnits(const AbstractMotor::encoderUnits iunits) {
+	std::int32_t out = 1;
+	for (auto &motor : motors) out = firstError(out, motor->setEncoderUnits(iunits));
+	return out;
+}
+
+AbstractMotor::encoderUnits MotorGroup::getEncoderUnits() {
+	return motors[0]->getEncoderUnits();
+}
+
+std::int32_t MotorGroup::setGearing(const AbstractMotor::gearset igearset) {
+	std::int32_t out = 1;
+	for (auto &motor : motors) out = firstError(out, motor->setGearing(igearset));
+	return out;
+}
+
+AbstractMotor::gearset MotorGroup::getGearing() {
+	return motors[0]->getGearing();
+}
+
+std::int32_t MotorGroup::setReversed(const bool ireverse) {
+	std::int32_t out = 1;
+	for (auto &motor : motors) out = firstError(out, motor->setReversed(ireverse));
+	return out;
+}
+
+std::int32_t MotorGroup::setVoltageLimit(const std::int32_t ilimit) {
+	std::int32_t out = 1;
+	for (auto &motor : motors) out = firstError(out, motor->setVoltageLimit(ilimit));
+	return out;
+}
+
+void MotorGroup::controllerSet(const double ivalue) {
+	for (auto &motor : motors) motor->controllerSet(ivalue);
+}
+
+std::shared_ptr<ContinuousRotarySensor> MotorGroup::getEncoder() {
+	return getEncoder(0);
+}
+
+std::shared_ptr<ContinuousRotarySensor> MotorGroup::getEncoder(const std::size_t index) {
+	return motors.at(index)->getEncoder();
+}
+
+IntegratedEncoder::IntegratedEncoder(const okapi::Motor &imotor)
+  : IntegratedEncoder(imotor.getPort(), imotor.isReversed()) {}
+
+IntegratedEncoder::IntegratedEncoder(const std::int8_t iport, const bool ireversed)
+  : port(std::abs(iport)), reversed(ireversed ? -1 : 1) {}
+
+double IntegratedEncoder::get() const {
+	return pros::c::motor_get_position(port) * reversed;
+}
+
+std::int32_t IntegratedEncoder::reset() {
+	return pros::c::motor_tare_position(port);
+}
+
+double IntegratedEncoder::controllerGet() {
+	return get();
+}
+
+ADIEncoder::ADIEncoder(const std::uint8_t iportTop, const std::uint8_t iportBottom, const bool ireversed)
+  : enc(pros::c::adi_encoder_init(iportTop, iportBottom, ireversed)) {}
+
+double ADIEncoder::get() const {
+	return pros::c::adi_encoder_get(enc);
+}
+
+std::int32_t ADIEncoder::reset() {
+	return pros::c::adi_encoder_reset(enc);
+}
+
+double ADIEncoder::controllerGet() {
+	return get();
+}
+
+AbstractButton::~AbstractButton() = default;
+
+bool AbstractButton::controllerGet() {
+	return isPressed();
+}
+
+ButtonBase::ButtonBase(const bool iinverted) : inverted(iinverted) {}
+
+bool ButtonBase::isPressed() {
+	return currentlyPressed() != inverted;
+}
+
+bool ButtonBase::changed() {
+	return changedImpl(wasPressedLast_c);
+}
+
+bool ButtonBase::changedToPressed() {
+	return changedImpl(wasPressedLast_ctp) && wasPressedLast_ctp;
+}
+
+bool ButtonBase::changedToReleased() {
+	return changedImpl(wasPressedLast_ctr) && !wasPressedLast_ctr;
+}
+
+bool ButtonBase::changedImpl(bool &prevState) {
+	const bool pressed = isPressed();
+	const bool out = pressed != prevState;
+	prevState = pressed;
+	return out;
+}
+
+ControllerButton::ControllerButton(const ControllerDigital ibtn, const bool iinverted)
+  : ControllerButton(ControllerId::master, ibtn, iinverted) {}
+
+ControllerButton::ControllerButton(const ControllerId icontroller, const ControllerDigital ibtn, const bool iinverted)
+  : ButtonBase(iinverted),
+    id(ControllerUtil::idToProsEnum(icontroller)),
+    btn(ControllerUtil::digitalToProsEnum(ibtn)) {}
+
+bool ControllerButton::currentlyPressed() {
+	return pros::c::controller_get_digital(id, btn) != 0;
+}
+
+pros::controller_id_e_t ControllerUtil::idToProsEnum(const ControllerId in) {
+	return static_cast<pros::controller_id_e_t>(in);
+}
+
+pros::controller_analog_e_t ControllerUtil::analogToProsEnum(const ControllerAnalog in) {
+	return static_cast<pros::controller_analog_e_t>(in);
+}
+
+pros::controller_digital_e_t ControllerUtil::digitalToProsEnum(const ControllerDigital in) {
+	return static_cast<pros::controller_digital_e_t>(in);
+}
+
+Controller::Controller(const ControllerId iid)
+  : okapiId(iid), prosId(ControllerUtil::idToProsEnum(iid)), buttonArray{} {}
+
+Controller::~Controller() {
+	for (auto button : buttonArray) delete button;
+}
+
+bool Controller::isConnected() {
+	return pros::c::controller_is_connected(prosId) == 1;
+}
+
+float Controller::getAnalog(const ControllerAnalog ichannel) {
+	const auto val = pros::c::controller_get_analog(prosId, ControllerUtil::analogToProsEnum(ichannel));
+	if (val == PROS_ERR) return 0;
+	return static_cast<float>(val) / 127;
+}
+
+bool Controller::getDigital(const ControllerDigital ibutton) {
+	return pros::c::controller_get_digital(prosId, ControllerUtil::digitalToProsEnum(ibutton)) == 1;
+}
+
+ControllerButton &Controller::operator[](const ControllerDigital ibtn) {
+	const auto index = toUnderlyingType(ibtn) - toUnderlyingType(ControllerDigital::L1);
+	if (!buttonArray[index]) buttonArray[index] = new ControllerButton(okapiId, ibtn);
+	return *buttonArray[index];
+}
+
+std::int32_t Controller::setText(const std::uint8_t iline, const std::uint8_t icol, std::string itext) {
+	return pros::c::controller_set_text(prosId, iline, icol, itext.c_str());
+}
+
+std::int32_t Controller::clear() {
+	return pros::c::controller_clear(prosId);
+}
+
+std::int32_t Controller::clearLine(const std::uint8_t iline) {
+	return pros::c::controller_clear_line(prosId, iline);
+}
+
+std::int32_t Controller::rumble(std::string irumblePattern) {
+	return pros::c::controller_rumble(prosId, irumblePattern.c_str());
+}
+
+std::int32_t Controller::getBatteryCapacity() {
+	return pros::c::controller_get_battery_capacity(prosId);
+}
+
+std::int32_t Controller::getBatteryLevel() {
+	return pros::c::controller_get_battery_level(prosId);
+}
+
+} // namespace okapi
@@ -0,0 +1,405 @@
+#include <cstdlib>
+#include <vector>
+#include "okapi/api.hpp"
+
+// host build of the okapi motion profile controller
+// pathfinder's sources aren't in the tree, so paths come from a cubic hermite spline per waypoint pair
+// with a trapezoid velocity profile (jerk is ignored), split into tank sides like pathfinder_modify_tank
+
+namespace okapi {
+
+namespace {
+constexpr double profileDt = 0.010; // s, same sample period okapi hands pathfinder
+constexpr int samplesPerSpline = 1000;
+
+struct PathSample {
+	double s; // m along the path
+	double x, y, heading, curvature;
+};
+
+// a waypoint pair as a cubic hermite curve, the tangents scale with the gap between the points
+void sampleSpline(const Waypoint &a, const Waypoint &b, std::vector<PathSample> &out) {
+	const double gap = std::hypot(b.x - a.x, b.y - a.y) * 1.2;
+	const double t0x = gap * std::cos(a.angle), t0y = gap * std::sin(a.angle);
+	const double t1x = gap * std::cos(b.angle), t1y = gap * std::sin(b.angle);
+	for (int i = out.empty() ? 0 : 1; i <= samplesPerSpline; i++) {
+		const double t = static_cast<double>(i) / samplesPerSpline;
+		const double h00 = 2 * t * t * t - 3 * t * t + 1, h10 = t * t * t - 2 * t * t + t;
+		const double h01 = -2 * t * t * t + 3 * t * t, h11 = t * t * t - t * t;
+		const double d00 = 6 * t * t - 6 * t, d10 = 3 * t * t - 4 * t + 1;
+		const double d01 = -6 * t * t + 6 * t, d11 = 3 * t * t - 2 * t;
+		const double e00 = 12 * t - 6, e10 = 6 * t - 4, e01 = -12 * t + 6, e11 = 6 * t - 2;
+		const double dx = d00 * a.x + d10 * t0x + d01 * b.x + d11 * t1x;
+		const double dy = d00 * a.y + d10 * t0y + d01 * b.y + d11 * t1y;
+		const double ddx = e00 * a.x + e10 * t0x + e01 * b.x + e11 * t1x;
+		const double ddy = e00 * a.y + e10 * t0y + e01 * b.y + e11 * t1y;
+		PathSample sample;
+		sample.x = h00 * a.x + h10 * t0x + h01 * b.x + h11 * t1x;
+		sample.y = h00 * a.y + h10 * t0y + h01 * b.y + h11 * t1y;
+		sample.heading = std::atan2(dy, dx);
+		const double speed = std::hypot(dx, dy);
+		sample.curvature = speed > 1e-9 ? (dx * ddy - dy * ddx) / (speed * speed * speed) : 0;
+		sample.s = out.empty() ? 0 : out.back().s + std::hypot(sample.x - out.back().x, sample.y - out.back().y);
+		out.push_back(sample);
+	}
+}
+
+// trapezoid velocity over the path length, one entry per profileDt
+std::vector<std::pair<double, double>> trapezoid(double ilength, double imaxVel, double imaxAccel) {
+	std::vector<std::pair<double, double>> out; // position, velocity
+	const double cruise = std::min(imaxVel, std::sqrt(imaxAccel * ilength));
+	const double rampTime = cruise / imaxAccel;
+	const double rampDist = cruise * rampTime / 2;
+	const double total = 2 * rampTime + (ilength - 2 * rampDist) / cruise;
+	for (double t = 0; t < total + profileDt / 2; t += profileDt) {
+		double pos, vel;
+		if (t < rampTime) {
+			vel = imaxAccel * t;
+			pos = imaxAccel * t * t / 2;
+		} else if (t < total - rampTime) {
+			vel = cruise;
+			pos = rampDist + cruise * (t - rampTime);
+		} else {
+			const double left = std::max(0.0, total - t);
+			vel = imaxAccel * left;
+			pos = ilength - imaxAccel * left * left / 2;
+		}
+		out.emplace_back(pos, vel);
+	}
+	return out;
+}
+
+Segment *makeSegments(int ilength) {
+	return static_cast<Segment *>(std::calloc(ilength, sizeof(Segment)));
+}
+} // namespace
+
+AsyncMotionProfileController::AsyncMotionProfileController(const TimeUtil &itimeUtil,
+                                                           const PathfinderLimits &ilimits,
+                                                           const std::shared_ptr<ChassisModel> &imodel,
+                                                           const ChassisScales &iscales,
+                                                           const AbstractMotor::GearsetRatioPair &ipair,
+                                                           const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger), limits(ilimits), model(imodel), scales(iscales), pair(ipair), timeUtil(itimeUtil) {
+	if (ipair.ratio == 0) {
+		std::string msg("AsyncMotionProfileController: The gear ratio cannot be zero! Check if you are using integer division.");
+		LOG_ERROR(msg);
+		throw std::invalid_argument(msg);
+	}
+}
+
+AsyncMotionProfileController::~AsyncMotionProfileController() {
+	dtorCalled.store(true, std::memory_order_release);
+	delete task;
+}
+
+void AsyncMotionProfileController::generatePath(std::initializer_list<PathfinderPoint> iwaypoints,
+                                                const std::string &ipathId) {
+	generatePath(iwaypoints, ipathId, limits);
+}
+
+void AsyncMotionProfileController::generatePath(std::initializer_list<PathfinderPoint> iwaypoints,
+                                                const std::string &ipathId,
+                                                const PathfinderLimits &ilimits) {
+	if (iwaypoints.size() == 0) {
+		LOG_WARN_S("AsyncMotionProfileController: Not generating a path because no waypoints were given.");
+		return;
+	}
+
+	std::vector<Waypoint> points;
+	points.reserve(iwaypoints.size());
+	for (auto &point : iwaypoints) {
+		points.push_back(Waypoint{point.x.convert(meter), point.y.convert(meter), point.theta.convert(radian)});
+	}
+
+	std::vector<PathSample> samples;
+	if (points.size() == 1) samples.push_back({0, points[0].x, points[0].y, points[0].angle, 0});
+	for (std::size_t i = 1; i < points.size(); i++) sampleSpline(points[i - 1], points[i], samples);
+
+	const auto profile = trapezoid(samples.back().s, ilimits.maxVel, ilimits.maxAccel);
+	const int length = static_cast<int>(profile.size());
+	if (length <= 1) {
+		std::string msg = getPathErrorMessage(points, ipathId, length);
+		LOG_ERROR(msg);
+		throw std::runtime_error(msg);
+	}
+
+	SegmentPtr leftTrajectory(makeSegments(length), std::free);
+	SegmentPtr rightTrajectory(makeSegments(length), std::free);
+	const double halfTrack = scales.wheelTrack.convert(meter) / 2;
+	std::size_t sample = 0;
+	double lastLeftVel = 0, lastRightVel = 0, leftPos = 0, rightPos = 0;
+	for (int i = 0; i < length; i++) {
+		const auto [pos, vel] = profile[i];
+		while (sample + 1 < samples.size() && samples[sample + 1].s <= pos) sample++;
+		const PathSample &here = samples[sample];
+
+		// the inside of the curve is on the left when the curvature is positive
+		const double leftVel = vel * (1 - here.curvature * halfTrack);
+		const double rightVel = vel * (1 + here.curvature * halfTrack);
+		leftPos += leftVel * profileDt;
+		rightPos += rightVel * profileDt;
+		const double sinH = std::sin(here.heading), cosH = std::cos(here.heading);
+		leftTrajectory.get()[i] = {profileDt, here.x - halfTrack * sinH, here.y + halfTrack * cosH, leftPos, leftVel,
+		                           (leftVel - lastLeftVel) / profileDt, 0, here.heading};
+		rightTrajectory.get()[i] = {profileDt, here.x + halfTrack * sinH, here.y - halfTrack * cosH, rightPos, rightVel,
+		                            (rightVel - lastRightVel) / profileDt, 0, here.heading};
+		lastLeftVel = leftVel;
+		lastRightVel = rightVel;
+	}
+
+	// free the old path before overwriting it
+	forceRemovePath(ipathId);
+	paths.emplace(ipathId, TrajectoryPair{std::move(leftTrajectory), std::move(rightTrajectory), length});
+	LOG_INFO("AsyncMotionProfileController: Completely done generating path " + ipathId);
+}
+
+std::string AsyncMotionProfileController::getPathErrorMessage(const std::vector<Waypoint> &points,
+                                                              const std::string &ipathId,
+                                                              int length) {
+	std::string pointsString = "{";
+	for (auto &point : points) {
+		pointsString += "{" + std::to_string(point.x) + ", " + std::to_string(point.y) + ", " + std::to_string(point.angle) + "}";
+	}
+	return "AsyncMotionProfileController: Path generation failed for path " + ipathId + " with " + std::to_string(length) + " segments and points " + pointsString + "}";
+}
+
+bool AsyncMotionProfileController::removePath(const std::string &ipathId) {
+	if (!isDisabled() && isRunning.load(std::memory_order_acquire) && getTarget() == ipathId) {
+		LOG_WARN("AsyncMotionProfileController: Attempted to remove currently running path " + ipathId);
+		return false;
+	}
+	forceRemovePath(ipathId);
+	return true;
+}
+
+void AsyncMotionProfileController::forceRemovePath(const std::string &ipathId) {
+	paths.erase(ipathId);
+}
+
+std::vector<std::string> AsyncMotionProfileController::getPaths() {
+	std::vector<std::string> keys;
+	for (const auto &path : paths) keys.push_back(path.first);
+	return keys;
+}
+
+void AsyncMotionProfileController::setTarget(std::string ipathId) {
+	setTarget(ipathId, false);
+}
+
+void AsyncMotionProfileController::setTarget(std::string ipathId, const bool ibackwards, const bool imirrored) {
+	LOG_INFO("AsyncMotionProfileController: Set target to: " + ipathId);
+	currentPathMutex.lock();
+	currentPath = ipathId;
+	direction.store(ibackwards ? -1 : 1, std::memory_order_release);
+	mirrored.store(imirrored, std::memory_order_release);
+	isRunning.store(true, std::memory_order_release);
+	currentPathMutex.unlock();
+}
+
+void AsyncMotionProfileController::controllerSet(std::string ivalue) {
+	setTarget(ivalue);
+}
+
+std::string AsyncMotionProfileController::getTarget() {
+	return currentPath;
+}
+
+std::string AsyncMotionProfileController::getProcessValue() const {
+	return currentPath;
+}
+
+void AsyncMotionProfileController::loop() {
+	LOG_INFO_S("Started AsyncMotionProfileController task.");
+	auto rate = timeUtil.getRate();
+	while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+		if (isRunning.load(std::memory_order_acquire) && !isDisabled()) {
+			currentPathMutex.lock();
+			const auto path = paths.find(currentPath);
+			currentPathMutex.unlock();
+			if (path == paths.end()) {
+				LOG_WARN("AsyncMotionProfileController: Target was set to non-existent path with name: " + currentPath);
+			} else {
+				executeSinglePath(path->second, timeUtil.getRate());
+				model->stop(); // stop the chassis because the path is done
+			}
+			isRunning.store(false, std::memory_order_release);
+		}
+		rate->delayUntil(10_ms);
+	}
+	LOG_INFO_S("Stopped AsyncMotionProfileController task.");
+}
+
+void AsyncMotionProfileController::executeSinglePath(const TrajectoryPair &path, std::unique_ptr<AbstractRate> rate) {
+	const int reversed = direction.load(std::memory_order_acquire);
+	const bool followMirrored = mirrored.load(std::memory_order_acquire);
+	const int pathLength = getPathLength(path);
+	for (int i = 0; i < pathLength && !isDisabled(); ++i) {
+		const double leftRPM = convertLinearToRotational(path.left.get()[i].velocity * mps).convert(rpm);
+		const double rightRPM = convertLinearToRotational(path.right.get()[i].velocity * mps).convert(rpm);
+		const double leftSpeed = leftRPM / toUnderlyingType(pair.internalGearset) * reversed;
+		const double rightSpeed = rightRPM / toUnderlyingType(pair.internalGearset) * reversed;
+		if (followMirrored) {
+			model->left(rightSpeed);
+			model->right(leftSpeed);
+		} else {
+			model->left(leftSpeed);
+			model->right(rightSpeed);
+		}
+		rate->delayUntil(path.left.get()[i].dt * second);
+	}
+}
+
+QAngularSpeed AsyncMotionProfileController::convertLinearToRotational(const QSpeed linear) const {
+	return (linear * (360_deg / (scales.wheelDiameter * 1_pi))) * pair.ratio;
+}
+
+int AsyncMotionProfileController::getPathLength(const TrajectoryPair &path) {
+	return path.length;
+}
+
+void AsyncMotionProfileController::waitUntilSettled() {
+	LOG_INFO_S("AsyncMotionProfileController: Waiting to settle");
+	auto rate = timeUtil.getRate();
+	while (!isSettled()) rate->delayUntil(10_ms);
+	LOG_INFO_S("AsyncMotionProfileController: Done waiting to settle");
+}
+
+void AsyncMotionProfileController::moveTo(std::initializer_list<PathfinderPoint> iwaypoints,
+                                          const bool ibackwards,
+                                          const bool imirrored) {
+	moveTo(iwaypoints, limits, ibackwards, imirrored);
+}
+
+void AsyncMotionProfileController::moveTo(std::initializer_list<PathfinderPoint> iwaypoints,
+                                          const PathfinderLimits &ilimits,
+                                          const bool ibackwards,
+                                          const bool imirrored) {
+	static int moveToCount = 0;
+	std::string name = "__moveToPath" + std::to_string(moveToCount++);
+	generatePath(iwaypoints, name, ilimits);
+	setTarget(name, ibackwards, imirrored);
+	waitUntilSettled();
+	forceRemovePath(name);
+}
+
+PathfinderPoint AsyncMotionProfileController::getError() const {
+	return PathfinderPoint{0_m, 0_m, 0_deg};
+}
+
+bool AsyncMotionProfileController::isSettled() {
+	return isDisabled() || !isRunning.load(std::memory_order_acquire);
+}
+
+void AsyncMotionProfileController::reset() {
+	// interrupt executeSinglePath() by disabling the controller
+	flipDisable(true);
+	auto rate = timeUtil.getRate();
+	while (isRunning.load(std::memory_order_acquire)) rate->delayUntil(1_ms);
+	flipDisable(false);
+}
+
+void AsyncMotionProfileController::flipDisable() {
+	flipDisable(!disabled.load(std::memory_order_acquire));
+}
+
+void AsyncMotionProfileController::flipDisable(const bool iisDisabled) {
+	LOG_INFO("AsyncMotionProfileController: flipDisable " + std::to_string(iisDisabled));
+	disabled.store(iisDisabled, std::memory_order_release);
+	// interrupt executeSinglePath() by disabling the controller
+	if (iisDisabled) model->stop();
+}
+
+bool AsyncMotionProfileController::isDisabled() const {
+	return disabled.load(std::memory_order_acquire);
+}
+
+void AsyncMotionProfileController::tarePosition() {}
+
+void AsyncMotionProfileController::setMaxVelocity(std::int32_t) {}
+
+void AsyncMotionProfileController::startThread() {
+	if (!task) task = new CrossplatformThread(trampoline, this, "AsyncMotionProfileController");
+}
+
+CrossplatformThread *AsyncMotionProfileController::getThread() const {
+	return task;
+}
+
+void AsyncMotionProfileController::trampoline(void *context) {
+	if (context) static_cast<AsyncMotionProfileController *>(context)->loop();
+}
+
+AsyncMotionProfileControllerBuilder::AsyncMotionProfileControllerBuilder(const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger) {}
+
+AsyncMotionProfileControllerBuilder &
+AsyncMotionProfileControllerBuilder::withOutput(ChassisController &icontroller) {
+	return withOutput(icontroller.getModel(), icontroller.getChassisScales(), icontroller.getGearsetRatioPair());
+}
+
+AsyncMotionProfileControllerBuilder &
+AsyncMotionProfileControllerBuilder::withOutput(const std::shared_ptr<ChassisController> &icontroller) {
+	return withOutput(*icontroller);
+}
+
+AsyncMotionProfileControllerBuilder &
+AsyncMotionProfileControllerBuilder::withOutput(const std::shared_ptr<ChassisModel> &imodel,
+                                                const ChassisScales &iscales,
+                                                const AbstractMotor::GearsetRatioPair &ipair) {
+	hasModel = true;
+	model = imodel;
+	scales = iscales;
+	pair = ipair;
+	return *this;
+}
+
+AsyncMotionProfileControllerBuilder &AsyncMotionProfileControllerBuilder::withLimits(const PathfinderLimits &ilimits) {
+	hasLimits = true;
+	limits = ilimits;
+	return *this;
+}
+
+AsyncMotionProfileControllerBuilder &
+AsyncMotionProfileControllerBuilder::withTimeUtilFactory(const TimeUtilFactory &itimeUtilFactory) {
+	timeUtilFactory = itimeUtilFactory;
+	return *this;
+}
+
+AsyncMotionProfileControllerBuilder &
+AsyncMotionProfileControllerBuilder::withLogger(const std::shared_ptr<Logger> &ilogger) {
+	controllerLogger = ilogger;
+	return *this;
+}
+
+AsyncMotionProfileControllerBuilder &AsyncMotionProfileControllerBuilder::parentedToCurrentTask() {
+	isParentedToCurrentTask = true;
+	return *this;
+}
+
+AsyncMotionProfileControllerBuilder &AsyncMotionProfileControllerBuilder::notParentedToCurrentTask() {
+	isParentedToCurrentTask = false;
+	return *this;
+}
+
+std::shared_ptr<AsyncMotionProfileController> AsyncMotionProfileControllerBuilder::buildMotionProfileController() {
+	if (!hasLimits) {
+		std::string msg("AsyncMotionProfileControllerBuilder: No limits given.");
+		LOG_ERROR(msg);
+		throw std::runtime_error(msg);
+	}
+	if (!hasModel) {
+		std::string msg("AsyncMotionProfileControllerBuilder: No output given.");
+		LOG_ERROR(msg);
+		throw std::runtime_error(msg);
+	}
+
+	auto out = std::make_shared<AsyncMotionProfileController>(timeUtilFactory.create(), limits, model, scales, pair, controllerLogger);
+	out->startThread();
+	if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
+		out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+	}
+	return out;
+}
+
+} // namespace okapi
@@ -0,0 +1,215 @@
+#include <cstring>
+#include "okapi/api.hpp"
+
+namespace okapi {
+
+std::shared_ptr<Logger> defaultLogger;
+int DefaultLoggerInitializer::count = 0;
+
+AbstractTimer::AbstractTimer(const QTime ifirstCalled)
+  : firstCalled(ifirstCalled), lastCalled(ifirstCalled), mark(ifirstCalled), hardMark(0_ms), repeatMark(-1_ms) {}
+
+AbstractTimer::~AbstractTimer() = default;
+
+QTime AbstractTimer::getDt() {
+	const QTime currTime = millis();
+	const QTime dt = currTime - lastCalled;
+	lastCalled = currTime;
+	return dt;
+}
+
+QTime AbstractTimer::readDt() const {
+	return millis() - lastCalled;
+}
+
+QTime AbstractTimer::getStartingTime() const {
+	return firstCalled;
+}
+
+QTime AbstractTimer::getDtFromStart() const {
+	return millis() - firstCalled;
+}
+
+void AbstractTimer::placeMark() {
+	mark = millis();
+}
+
+QTime AbstractTimer::clearMark() {
+	const QTime old = mark;
+	mark = 0_ms;
+	return old;
+}
+
+void AbstractTimer::placeHardMark() {
+	if (hardMark == 0_ms) hardMark = millis();
+}
+
+QTime AbstractTimer::clearHardMark() {
+	const QTime old = hardMark;
+	hardMark = 0_ms;
+	return old;
+}
+
+QTime AbstractTimer::getDtFromMark() const {
+	return mark != 0_ms ? millis() - mark : 0_ms;
+}
+
+QTime AbstractTimer::getDtFromHardMark() const {
+	return hardMark != 0_ms ? millis() - hardMark : 0_ms;
+}
+
+bool AbstractTimer::repeat(const QTime time) {
+	if (repeatMark == -1_ms) repeatMark = millis();
+	if (millis() - repeatMark >= time) {
+		repeatMark = -1_ms;
+		return true;
+	}
+	return false;
+}
+
+bool AbstractTimer::repeat(const QFrequency frequency) {
+	return repeat(QTime(1 / frequency.convert(Hz)));
+}
+
+Timer::Timer() : AbstractTimer(pros::millis() * millisecond) {}
+
+QTime Timer::millis() const {
+	return pros::millis() * millisecond;
+}
+
+AbstractRate::~AbstractRate() = default;
+
+Rate::Rate() = default;
+
+void Rate::delay(const QFrequency ihz) {
+	delayUntil(1000 / ihz.convert(Hz));
+}
+
+void Rate::delayUntil(const QTime itime) {
+	delayUntil(static_cast<uint32_t>(itime.convert(millisecond)));
+}
+
+void Rate::delayUntil(const uint32_t ims) {
+	if (lastTime == 0) lastTime = pros::millis();
+	pros::c::task_delay_until(&lastTime, ims);
+}
+
+SettledUtil::SettledUtil(std::unique_ptr<AbstractTimer> iatTargetTimer,
+                         const double iatTargetError,
+                         const double iatTargetDerivative,
+                         const QTime iatTargetTime)
+  : atTargetError(iatTargetError),
+    atTargetDerivative(iatTargetDerivative),
+    atTargetTime(iatTargetTime),
+    atTargetTimer(std::move(iatTargetTimer)) {}
+
+SettledUtil::~SettledUtil() = default;
+
+bool SettledUtil::isSettled(const double ierror) {
+	const double derivative = ierror - lastError;
+	lastError = ierror;
+	if (std::abs(ierror) <= atTargetError && std::abs(derivative) <= atTargetDerivative) {
+		atTargetTimer->placeHardMark();
+	} else {
+		atTargetTimer->clearHardMark();
+	}
+	return atTargetTimer->getDtFromHardMark() > atTargetTime;
+}
+
+void SettledUtil::reset() {
+	atTargetTimer->clearHardMark();
+	lastError = 0;
+}
+
+TimeUtil::TimeUtil(const Supplier<std::unique_ptr<AbstractTimer>> &itimerSupplier,
+                   const Supplier<std::unique_ptr<AbstractRate>> &irateSupplier,
+                   const Supplier<std::unique_ptr<SettledUtil>> &isettledUtilSupplier)
+  : timerSupplier(itimerSupplier), rateSupplier(irateSupplier), settledUtilSupplier(isettledUtilSupplier) {}
+
+std::unique_ptr<AbstractTimer> TimeUtil::getTimer() const {
+	return timerSupplier.get();
+}
+
+std::unique_ptr<AbstractRate> TimeUtil::getRate() const {
+	return rateSupplier.get();
+}
+
+std::unique_ptr<SettledUtil> TimeUtil::getSettledUtil() const {
+	return settledUtilSupplier.get();
+}
+
+Supplier<std::unique_ptr<AbstractTimer>> TimeUtil::getTimerSupplier() const {
+	return timerSupplier;
+}
+
+Supplier<std::unique_ptr<AbstractRate>> TimeUtil::getRateSupplier() const {
+	return rateSupplier;
+}
+
+Supplier<std::unique_ptr<SettledUtil>> TimeUtil::getSettledUtilSupplier() const {
+	return settledUtilSupplier;
+}
+
+TimeUtil TimeUtilFactory::create() {
+	return createDefault();
+}
+
+TimeUtil TimeUtilFactory::createDefault() {
+	return withSettledUtilParams();
+}
+
+TimeUtil TimeUtilFactory::withSettledUtilParams(const double iatTargetError,
+                                                const double iatTargetDerivative,
+                                                const QTime &iatTargetTime) {
+	return TimeUtil(
+	  Supplier<std::unique_ptr<AbstractTimer>>([]() { return std::make_unique<Timer>(); }),
+	  Supplier<std::unique_ptr<AbstractRate>>([]() { return std::make_unique<Rate>(); }),
+	  Supplier<std::unique_ptr<SettledUtil>>([=]() {
+		  return std::make_unique<SettledUtil>(
+		    std::make_unique<Timer>(), iatTargetError, iatTargetDerivative, iatTargetTime);
+	  }));
+}
+
+Logger::Logger() noexcept : timer(nullptr), logLevel(LogLevel::off), logfile(nullptr) {}
+
+Logger::Logger(std::unique_ptr<AbstractTimer> itimer, std::string_view ifileName, const LogLevel &ilevel) noexcept
+  : timer(std::move(itimer)), logLevel(ilevel), logfile(nullptr) {
+	// the brain's serial streams are just the terminal on the host
+	if (ifileName == "/ser/sout") logfile = stdout;
+	else if (ifileName == "/ser/serr") logfile = stderr;
+	else logfile = fopen(std::string(ifileName).c_str(), "w");
+}
+
+Logger::Logger(std::unique_ptr<AbstractTimer> itimer, FILE *const ifile, const LogLevel &ilevel) noexcept
+  : timer(std::move(itimer)), logLevel(ilevel), logfile(ifile) {}
+
+Logger::~Logger() {
+	if (logfile != stdout && logfile != stderr) close();
+}
+
+std::shared_ptr<Logger> Logger::getDefaultLogger() {
+	return defaultLogger;
+}
+
+void Logger::setDefaultLogger(std::shared_ptr<Logger> ilogger) {
+	defaultLogger = std::move(ilogger);
+}
+
+bool Logger::isSerialStream(std::string_view filename) {
+	return filename.find("/ser/") == 0;
+}
+
+Filter::~Filter() = default;
+
+PassthroughFilter::PassthroughFilter() = default;
+
+double PassthroughFilter::filter(const double ireading) {
+	lastOutput = ireading;
+	return ireading;
+}
+
+double PassthroughFilter::getOutput() const {
+	return lastOutput;
+}
+
+} // namespace okapi
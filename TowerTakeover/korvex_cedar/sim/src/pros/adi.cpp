@@ -0,0 +1,184 @@
+#include <array>
+#include <cerrno>
+#include "sim/robot.hpp"
+
+namespace pros {
+namespace c {
+
+namespace {
+std::array<adi_port_config_e_t, 9> configs = [] {
+	std::array<adi_port_config_e_t, 9> out;
+	out.fill(E_ADI_TYPE_UNDEFINED);
+	return out;
+}();
+std::array<std::int32_t, 9> calibrations{}; // 16x the averaged reading, for the high resolution calls
+std::array<bool, 9> encoderReversed{};
+
+// 1 indexed port, or 0 with errno set
+std::uint8_t checked(std::uint8_t iport) {
+	const std::uint8_t port = sim::adiPort(iport);
+	if (port < 1 || port > 8) {
+		errno = ENXIO;
+		return 0;
+	}
+	return port;
+}
+} // namespace
+
+adi_port_config_e_t adi_port_get_config(std::uint8_t port) {
+	const std::uint8_t adi = checked(port);
+	return adi ? configs[adi] : E_ADI_ERR;
+}
+
+std::int32_t adi_port_get_value(std::uint8_t port) {
+	const std::uint8_t adi = checked(port);
+	return adi ? sim::robot().analogRead(adi) : PROS_ERR;
+}
+
+std::int32_t adi_port_set_config(std::uint8_t port, adi_port_config_e_t type) {
+	const std::uint8_t adi = checked(port);
+	if (!adi) return PROS_ERR;
+	configs[adi] = type;
+	return 1;
+}
+
+std::int32_t adi_port_set_value(std::uint8_t port, std::int32_t) {
+	return checked(port) ? 1 : PROS_ERR;
+}
+
+std::int32_t adi_analog_calibrate(std::uint8_t port) {
+	const std::uint8_t adi = checked(port);
+	if (!adi) return PROS_ERR;
+	// the brain averages readings for half a second
+	std::int32_t total = 0;
+	for (int i = 0; i < 500; i++) {
+		total += sim::robot().analogRead(adi);
+		delay(1);
+	}
+	calibrations[adi] = total * 16 / 500;
+	return total / 500;
+}
+
+std::int32_t adi_analog_read(std::uint8_t port) {
+	return adi_port_get_value(port);
+}
+
+std::int32_t adi_analog_read_calibrated(std::uint8_t port) {
+	const std::uint8_t adi = checked(port);
+	return adi ? sim::robot().analogRead(adi) - calibrations[adi] / 16 : PROS_ERR;
+}
+
+std::int32_t adi_analog_read_calibrated_HR(std::uint8_t port) {
+	const std::uint8_t adi = checked(port);
+	return adi ? (sim::robot().analogRead(adi) << 4) - calibrations[adi] : PROS_ERR;
+}
+
+std::int32_t adi_digital_read(std::uint8_t port) {
+	const std::uint8_t adi = checked(port);
+	return adi ? sim::robot().analogRead(adi) > 2048 : PROS_ERR;
+}
+
+std::int32_t adi_digital_get_new_press(std::uint8_t port) {
+	return checked(port) ? 0 : PROS_ERR;
+}
+
+std::int32_t adi_digital_write(std::uint8_t port, const bool) {
+	return checked(port) ? 1 : PROS_ERR;
+}
+
+std::int32_t adi_pin_mode(std::uint8_t port, std::uint8_t) {
+	return checked(port) ? 1 : PROS_ERR;
+}
+
+std::int32_t adi_motor_set(std::uint8_t port, std::int8_t) {
+	return checked(port) ? 1 : PROS_ERR;
+}
+
+std::int32_t adi_motor_get(std::uint8_t port) {
+	return checked(port) ? 0 : PROS_ERR;
+}
+
+std::int32_t adi_motor_stop(std::uint8_t port) {
+	return checked(port) ? 1 : PROS_ERR;
+}
+
+adi_encoder_t adi_encoder_init(std::uint8_t port_top, std::uint8_t port_bottom, const bool reverse) {
+	const std::uint8_t top = checked(port_top);
+	if (!top || !checked(port_bottom)) return PROS_ERR;
+	configs[top] = E_ADI_LEGACY_ENCODER;
+	encoderReversed[top] = reverse;
+	return top;
+}
+
+std::int32_t adi_encoder_get(adi_encoder_t enc) {
+	const std::uint8_t top = checked(enc);
+	if (!top) return PROS_ERR;
+	const std::int32_t ticks = sim::robot().encoderTicks(top);
+	return encoderReversed[top] ? -ticks : ticks;
+}
+
+std::int32_t adi_encoder_reset(adi_encoder_t enc) {
+	const std::uint8_t top = checked(enc);
+	if (!top) return PROS_ERR;
+	sim::robot().resetEncoder(top);
+	return 1;
+}
+
+std::int32_t adi_encoder_shutdown(adi_encoder_t enc) {
+	const std::uint8_t top = checked(enc);
+	if (!top) return PROS_ERR;
+	configs[top] = E_ADI_TYPE_UNDEFINED;
+	return 1;
+}
+
+} // namespace c
+
+ADIPort::ADIPort(std::uint8_t port, adi_port_config_e_t type) : _port(port) {
+	c::adi_port_set_config(_port, type);
+}
+
+ADIPort::ADIPort() {}
+
+std::int32_t ADIPort::set_config(adi_port_config_e_t type) const {
+	return c::adi_port_set_config(_port, type);
+}
+
+std::int32_t ADIPort::get_config() const {
+	return c::adi_port_get_config(_port);
+}
+
+std::int32_t ADIPort::set_value(std::int32_t value) const {
+	return c::adi_port_set_value(_port, value);
+}
+
+std::int32_t ADIPort::get_value() const {
+	return c::adi_port_get_value(_port);
+}
+
+ADIAnalogIn::ADIAnalogIn(std::uint8_t port) : ADIPort(port, E_ADI_ANALOG_IN) {}
+
+std::int32_t ADIAnalogIn::calibrate() const {
+	return c::adi_analog_calibrate(_port);
+}
+
+std::int32_t ADIAnalogIn::get_value_calibrated() const {
+	return c::adi_analog_read_calibrated(_port);
+}
+
+std::int32_t ADIAnalogIn::get_value_calibrated_HR() const {
+	return c::adi_analog_read_calibrated_HR(_port);
+}
+
+ADIEncoder::ADIEncoder(std::uint8_t port_top, std::uint8_t port_bottom, bool reversed) {
+	_port = c::adi_encoder_init(port_top, port_bottom, reversed);
+}
+
+std::int32_t ADIEncoder::reset() const {
+	return c::adi_encoder_reset(_port);
+}
+
+std::int32_t ADIEncoder::get_value() const {
+	return c::adi_encoder_get(_port);
+}
+
+} // namespace pros
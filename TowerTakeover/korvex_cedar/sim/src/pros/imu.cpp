@@ -0,0 +1,143 @@
+#include <cerrno>
+#include <cmath>
+#include "sim/robot.hpp"
+
+namespace pros {
+namespace c {
+
+namespace {
+constexpr double calibrationTime = 2; // s
+
+bool ready(std::uint8_t iport) {
+	if (iport < 1 || iport > 21) {
+		errno = ENXIO;
+		return false;
+	}
+	if (iport != sim::robot().getConfig().imuPort) {
+		errno = ENODEV;
+		return false;
+	}
+	if (sim::robot().imuTime < calibrationTime) {
+		errno = EAGAIN;
+		return false;
+	}
+	return true;
+}
+
+double degrees(double irad) {
+	return irad * 180 / M_PI;
+}
+} // namespace
+
+std::int32_t imu_reset(std::uint8_t port) {
+	if (!ready(port) && errno != EAGAIN) return PROS_ERR;
+	sim::robot().imuTime = 0;
+	sim::robot().imuOffset = sim::robot().imuHeading();
+	return 1;
+}
+
+double imu_get_rotation(std::uint8_t port) {
+	if (!ready(port)) return PROS_ERR_F;
+	return degrees(sim::robot().imuHeading() - sim::robot().imuOffset);
+}
+
+double imu_get_heading(std::uint8_t port) {
+	const double rotation = imu_get_rotation(port);
+	if (rotation == PROS_ERR_F) return PROS_ERR_F;
+	const double heading = std::fmod(rotation, 360);
+	return heading < 0 ? heading + 360 : heading;
+}
+
+double imu_get_yaw(std::uint8_t port) {
+	const double rotation = imu_get_rotation(port);
+	if (rotation == PROS_ERR_F) return PROS_ERR_F;
+	return std::remainder(rotation, 360);
+}
+
+double imu_get_pitch(std::uint8_t port) {
+	return ready(port) ? 0 : PROS_ERR_F;
+}
+
+double imu_get_roll(std::uint8_t port) {
+	return ready(port) ? 0 : PROS_ERR_F;
+}
+
+euler_s_t imu_get_euler(std::uint8_t port) {
+	if (!ready(port)) return {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+	return {0, 0, imu_get_yaw(port)};
+}
+
+quaternion_s_t imu_get_quaternion(std::uint8_t port) {
+	if (!ready(port)) return {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+	const double half = (sim::robot().imuHeading() - sim::robot().imuOffset) / 2;
+	return {0, 0, std::sin(half), std::cos(half)};
+}
+
+imu_gyro_s_t imu_get_gyro_rate(std::uint8_t port) {
+	if (!ready(port)) return {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+	return {0, 0, degrees(sim::robot().imuRate())};
+}
+
+// in g, mounted flat with x forward and y right, turning pulls sideways toward the middle of the turn
+imu_accel_s_t imu_get_accel(std::uint8_t port) {
+	if (!ready(port)) return {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+	const sim::Robot &robot = sim::robot();
+	return {robot.acceleration / 9.81, robot.velocity * robot.angularVelocity / 9.81, 1};
+}
+
+imu_status_e_t imu_get_status(std::uint8_t port) {
+	if (ready(port)) return static_cast<imu_status_e_t>(0);
+	return errno == EAGAIN ? E_IMU_STATUS_CALIBRATING : E_IMU_STATUS_ERROR;
+}
+
+} // namespace c
+
+std::int32_t Imu::reset() const {
+	return c::imu_reset(_port);
+}
+
+double Imu::get_rotation() const {
+	return c::imu_get_rotation(_port);
+}
+
+double Imu::get_heading() const {
+	return c::imu_get_heading(_port);
+}
+
+c::quaternion_s_t Imu::get_quaternion() const {
+	return c::imu_get_quaternion(_port);
+}
+
+c::euler_s_t Imu::get_euler() const {
+	return c::imu_get_euler(_port);
+}
+
+double Imu::get_pitch() const {
+	return c::imu_get_pitch(_port);
+}
+
+double Imu::get_roll() const {
+	return c::imu_get_roll(_port);
+}
+
+double Imu::get_yaw() const {
+	return c::imu_get_yaw(_port);
+}
+
+c::imu_gyro_s_t Imu::get_gyro_rate() const {
+	return c::imu_get_gyro_rate(_port);
+}
+
+c::imu_accel_s_t Imu::get_accel() const {
+	return c::imu_get_accel(_port);
+}
+
+c::imu_status_e_t Imu::get_status() const {
+	return c::imu_get_status(_port);
+}
+
+bool Imu::is_calibrating() const {
+	return get_status() & c::E_IMU_STATUS_CALIBRATING;
+}
+
+} // namespace pros
@@ -0,0 +1,180 @@
+#include <cmath>
+#include <cerrno>
+#include "sim/robot.hpp"
+
+namespace pros {
+namespace c {
+
+namespace {
+std::array<bool, 18> lastPressed{};
+
+bool master(controller_id_e_t iid) {
+	if (iid != E_CONTROLLER_MASTER) {
+		errno = EACCES;
+		return false;
+	}
+	return true;
+}
+} // namespace
+
+std::int32_t controller_is_connected(controller_id_e_t id) {
+	return id == E_CONTROLLER_MASTER;
+}
+
+std::int32_t controller_get_analog(controller_id_e_t id, controller_analog_e_t channel) {
+	if (!master(id)) return 0;
+	return sim::robot().analog.at(channel);
+}
+
+std::int32_t controller_get_battery_capacity(controller_id_e_t id) {
+	return master(id) ? 100 : PROS_ERR;
+}
+
+std::int32_t controller_get_battery_level(controller_id_e_t id) {
+	return master(id) ? 100 : PROS_ERR;
+}
+
+std::int32_t controller_get_digital(controller_id_e_t id, controller_digital_e_t button) {
+	if (!master(id)) return 0;
+	return sim::robot().digital.at(button);
+}
+
+std::int32_t controller_get_digital_new_press(controller_id_e_t id, controller_digital_e_t button) {
+	if (!master(id)) return 0;
+	const bool pressed = sim::robot().digital.at(button);
+	const bool newPress = pressed && !lastPressed.at(button);
+	lastPressed.at(button) = pressed;
+	return newPress;
+}
+
+std::int32_t controller_print(controller_id_e_t id, std::uint8_t, std::uint8_t, const char *, ...) {
+	return master(id) ? 1 : PROS_ERR;
+}
+
+std::int32_t controller_set_text(controller_id_e_t id, std::uint8_t, std::uint8_t, const char *) {
+	return master(id) ? 1 : PROS_ERR;
+}
+
+std::int32_t controller_clear_line(controller_id_e_t id, std::uint8_t) {
+	return master(id) ? 1 : PROS_ERR;
+}
+
+std::int32_t controller_clear(controller_id_e_t id) {
+	return master(id) ? 1 : PROS_ERR;
+}
+
+std::int32_t controller_rumble(controller_id_e_t id, const char *) {
+	return master(id) ? 1 : PROS_ERR;
+}
+
+std::int32_t battery_get_voltage() {
+	return std::lround(sim::robot().batteryVoltage);
+}
+
+std::int32_t battery_get_current() {
+	return std::lround(sim::robot().batteryCurrent);
+}
+
+double battery_get_temperature() {
+	return 25;
+}
+
+double battery_get_capacity() {
+	return 100;
+}
+
+std::uint8_t competition_get_status() {
+	return sim::robot().competition;
+}
+
+std::int32_t usd_is_installed() {
+	return 0;
+}
+
+} // namespace c
+
+Controller::Controller(controller_id_e_t id) : _id(id) {}
+
+std::int32_t Controller::is_connected() {
+	return c::controller_is_connected(_id);
+}
+
+std::int32_t Controller::get_analog(controller_analog_e_t channel) {
+	return c::controller_get_analog(_id, channel);
+}
+
+std::int32_t Controller::get_battery_capacity() {
+	return c::controller_get_battery_capacity(_id);
+}
+
+std::int32_t Controller::get_battery_level() {
+	return c::controller_get_battery_level(_id);
+}
+
+std::int32_t Controller::get_digital(controller_digital_e_t button) {
+	return c::controller_get_digital(_id, button);
+}
+
+std::int32_t Controller::get_digital_new_press(controller_digital_e_t button) {
+	return c::controller_get_digital_new_press(_id, button);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const char *str) {
+	return c::controller_set_text(_id, line, col, str);
+}
+
+std::int32_t Controller::clear_line(std::uint8_t line) {
+	return c::controller_clear_line(_id, line);
+}
+
+std::int32_t Controller::rumble(const char *rumble_pattern) {
+	return c::controller_rumble(_id, rumble_pattern);
+}
+
+std::int32_t Controller::clear() {
+	return c::controller_clear(_id);
+}
+
+namespace battery {
+double get_capacity() {
+	return c::battery_get_capacity();
+}
+
+std::int32_t get_current() {
+	return c::battery_get_current();
+}
+
+double get_temperature() {
+	return c::battery_get_temperature();
+}
+
+std::int32_t get_voltage() {
+	return c::battery_get_voltage();
+}
+} // namespace battery
+
+namespace competition {
+std::uint8_t get_status() {
+	return c::competition_get_status();
+}
+
+std::uint8_t is_autonomous() {
+	return (c::competition_get_status() & COMPETITION_AUTONOMOUS) != 0;
+}
+
+std::uint8_t is_connected() {
+	return (c::competition_get_status() & COMPETITION_CONNECTED) != 0;
+}
+
+std::uint8_t is_disabled() {
+	return (c::competition_get_status() & COMPETITION_DISABLED) != 0;
+}
+} // namespace competition
+
+namespace usd {
+std::int32_t is_installed() {
+	return c::usd_is_installed();
+}
+} // namespace usd
+
+} // namespace pros
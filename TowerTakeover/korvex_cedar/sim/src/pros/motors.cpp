@@ -0,0 +1,268 @@
+#include <cerrno>
+#include <cmath>
+#include "sim/robot.hpp"
+
+namespace pros {
+namespace c {
+
+namespace {
+// the simulated motor on a port, or null with errno set like the brain does
+sim::SmartMotor *smart(std::uint8_t iport) {
+	if (iport < 1 || iport > 21) {
+		errno = ENXIO;
+		return nullptr;
+	}
+	return &sim::robot().motor(iport);
+}
+} // namespace
+
+#define MOTOR_OR(port, err)                                                                                            \
+	sim::SmartMotor *motor = smart(port);                                                                              \
+	if (!motor) return err;
+
+std::int32_t motor_move(std::uint8_t port, std::int32_t voltage) {
+	return motor_move_voltage(port, voltage * 12000 / 127);
+}
+
+std::int32_t motor_move_absolute(std::uint8_t port, const double position, const std::int32_t velocity) {
+	MOTOR_OR(port, PROS_ERR);
+	motor->mode = sim::SmartMotor::Mode::position;
+	motor->targetPosition = position;
+	motor->profileVelocity = std::min<double>(std::abs(velocity), motor->maxRpm());
+	return 1;
+}
+
+std::int32_t motor_move_relative(std::uint8_t port, const double position, const std::int32_t velocity) {
+	MOTOR_OR(port, PROS_ERR);
+	return motor_move_absolute(port, motor->fromDegrees(motor->userPosition()) + position, velocity);
+}
+
+std::int32_t motor_move_velocity(std::uint8_t port, const std::int32_t velocity) {
+	MOTOR_OR(port, PROS_ERR);
+	motor->mode = sim::SmartMotor::Mode::velocity;
+	motor->targetVelocity = std::max(-motor->maxRpm(), std::min(motor->maxRpm(), double(velocity)));
+	return 1;
+}
+
+std::int32_t motor_move_voltage(std::uint8_t port, const std::int32_t voltage) {
+	MOTOR_OR(port, PROS_ERR);
+	motor->mode = sim::SmartMotor::Mode::voltage;
+	motor->targetVoltage = std::max(-12000, std::min(12000, voltage));
+	return 1;
+}
+
+std::int32_t motor_modify_profiled_velocity(std::uint8_t port, const std::int32_t velocity) {
+	MOTOR_OR(port, PROS_ERR);
+	motor->profileVelocity = std::min<double>(std::abs(velocity), motor->maxRpm());
+	return 1;
+}
+
+double motor_get_target_position(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR_F);
+	return motor->targetPosition;
+}
+
+std::int32_t motor_get_target_velocity(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR);
+	return motor->mode == sim::SmartMotor::Mode::velocity ? motor->targetVelocity : 0;
+}
+
+double motor_get_actual_velocity(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR_F);
+	return motor->userVelocity();
+}
+
+std::int32_t motor_get_current_draw(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR);
+	return std::lround(motor->current);
+}
+
+std::int32_t motor_get_direction(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR);
+	return motor->userVelocity() < 0 ? -1 : 1;
+}
+
+double motor_get_efficiency(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR_F);
+	// mechanical power out over electrical power in
+	const double in = std::abs(motor->voltage / 1000 * motor->current / 1000);
+	if (in < 1e-3) return 0;
+	const double out = std::abs(motor->torque * motor->velocity / 180 * M_PI);
+	return std::min(100.0, 100 * out / in);
+}
+
+std::int32_t motor_is_over_current(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR);
+	return motor_get_current_draw(port) >= 2500;
+}
+
+std::int32_t motor_is_over_temp(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR);
+	return 0;
+}
+
+std::int32_t motor_is_stopped(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR);
+	return std::abs(motor->velocity) < 1;
+}
+
+std::int32_t motor_get_zero_position_flag(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR);
+	return std::abs(motor->position - motor->zero) < 1;
+}
+
+std::uint32_t motor_get_faults(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR);
+	return motor_is_over_current(port) ? E_MOTOR_FAULT_OVER_CURRENT : E_MOTOR_FAULT_NO_FAULTS;
+}
+
+std::uint32_t motor_get_flags(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR);
+	std::uint32_t flags = E_MOTOR_FLAGS_NONE;
+	if (motor_is_stopped(port)) flags |= E_MOTOR_FLAGS_ZERO_VELOCITY;
+	if (motor_get_zero_position_flag(port)) flags |= E_MOTOR_FLAGS_ZERO_POSITION;
+	return flags;
+}
+
+std::int32_t motor_get_raw_position(std::uint8_t port, std::uint32_t *const timestamp) {
+	MOTOR_OR(port, PROS_ERR);
+	if (timestamp) *timestamp = millis();
+	return std::lround(motor->sign() * motor->position / 360 * motor->ticksPerRev());
+}
+
+double motor_get_position(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR_F);
+	return motor->fromDegrees(motor->userPosition());
+}
+
+double motor_get_power(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR_F);
+	return std::abs(motor->voltage / 1000 * motor->current / 1000);
+}
+
+double motor_get_temperature(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR_F);
+	return 25;
+}
+
+double motor_get_torque(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR_F);
+	return std::abs(motor->torque);
+}
+
+std::int32_t motor_get_voltage(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR);
+	return std::lround(motor->sign() * motor->voltage);
+}
+
+std::int32_t motor_set_zero_position(std::uint8_t port, const double position) {
+	MOTOR_OR(port, PROS_ERR);
+	motor->zero += motor->sign() * motor->toDegrees(position);
+	return 1;
+}
+
+std::int32_t motor_tare_position(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR);
+	motor->zero = motor->position;
+	return 1;
+}
+
+std::int32_t motor_set_brake_mode(std::uint8_t port, const motor_brake_mode_e_t mode) {
+	MOTOR_OR(port, PROS_ERR);
+	motor->brakeMode = mode;
+	return 1;
+}
+
+std::int32_t motor_set_current_limit(std::uint8_t port, const std::int32_t) {
+	MOTOR_OR(port, PROS_ERR);
+	return 1;
+}
+
+std::int32_t motor_set_encoder_units(std::uint8_t port, const motor_encoder_units_e_t units) {
+	MOTOR_OR(port, PROS_ERR);
+	motor->units = units;
+	return 1;
+}
+
+std::int32_t motor_set_gearing(std::uint8_t port, const motor_gearset_e_t gearset) {
+	MOTOR_OR(port, PROS_ERR);
+	motor->gearset = gearset;
+	return 1;
+}
+
+motor_pid_s_t motor_convert_pid(double kf, double kp, double ki, double kd) {
+	auto clamp = [](double x) { return static_cast<std::uint8_t>(std::max(0.0, std::min(255.0, x * 16))); };
+	return {clamp(kf), clamp(kp), clamp(ki), clamp(kd)};
+}
+
+motor_pid_full_s_t motor_convert_pid_full(double kf, double kp, double ki, double kd, double filter, double limit, double threshold, double loopspeed) {
+	auto clamp = [](double x) { return static_cast<std::uint8_t>(std::max(0.0, std::min(255.0, x * 16))); };
+	return {clamp(kf), clamp(kp), clamp(ki), clamp(kd), clamp(filter), static_cast<std::uint16_t>(limit * 16), static_cast<std::uint8_t>(threshold), static_cast<std::uint8_t>(loopspeed)};
+}
+
+// the internal pid gains don't change the sim's idea of the motor controller
+std::int32_t motor_set_pos_pid(std::uint8_t port, const motor_pid_s_t) {
+	MOTOR_OR(port, PROS_ERR);
+	return 1;
+}
+
+std::int32_t motor_set_pos_pid_full(std::uint8_t port, const motor_pid_full_s_t) {
+	MOTOR_OR(port, PROS_ERR);
+	return 1;
+}
+
+std::int32_t motor_set_vel_pid(std::uint8_t port, const motor_pid_s_t) {
+	MOTOR_OR(port, PROS_ERR);
+	return 1;
+}
+
+std::int32_t motor_set_vel_pid_full(std::uint8_t port, const motor_pid_full_s_t) {
+	MOTOR_OR(port, PROS_ERR);
+	return 1;
+}
+
+std::int32_t motor_set_reversed(std::uint8_t port, const bool reverse) {
+	MOTOR_OR(port, PROS_ERR);
+	motor->reversed = reverse;
+	return 1;
+}
+
+std::int32_t motor_set_voltage_limit(std::uint8_t port, const std::int32_t) {
+	MOTOR_OR(port, PROS_ERR);
+	return 1;
+}
+
+motor_brake_mode_e_t motor_get_brake_mode(std::uint8_t port) {
+	MOTOR_OR(port, E_MOTOR_BRAKE_INVALID);
+	return motor->brakeMode;
+}
+
+std::int32_t motor_get_current_limit(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR);
+	return 2500;
+}
+
+motor_encoder_units_e_t motor_get_encoder_units(std::uint8_t port) {
+	MOTOR_OR(port, E_MOTOR_ENCODER_INVALID);
+	return motor->units;
+}
+
+motor_gearset_e_t motor_get_gearing(std::uint8_t port) {
+	MOTOR_OR(port, E_MOTOR_GEARSET_INVALID);
+	return motor->gearset;
+}
+
+std::int32_t motor_is_reversed(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR);
+	return motor->reversed;
+}
+
+std::int32_t motor_get_voltage_limit(std::uint8_t port) {
+	MOTOR_OR(port, PROS_ERR);
+	return 0;
+}
+
+#undef MOTOR_OR
+
+} // namespace c
+} // namespace pros
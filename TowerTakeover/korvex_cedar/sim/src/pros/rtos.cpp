@@ -0,0 +1,429 @@
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "pros/apix.h"
+#include "sim/kernel.hpp"
+#include "sim/robot.hpp"
+
+namespace sim {
+
+namespace {
+struct Task {
+	std::string name;
+	pros::task_fn_t function = nullptr;
+	void *parameters = nullptr;
+	std::uint32_t priority = TASK_PRIORITY_DEFAULT;
+	std::uint32_t order = 0; // creation order, breaks ties so every run schedules the same way
+	pros::task_state_e_t state = pros::E_TASK_STATE_READY;
+	bool deleteRequested = false;
+	std::uint32_t notifyValue = 0;
+	struct Watcher {
+		Task *task;
+		std::uint32_t value;
+		pros::notify_action_e_t action;
+	};
+	std::vector<Watcher> deleteWatchers;
+	std::function<bool()> waitingFor; // set while blocked
+	std::uint64_t wake = 0; // ms, when a blocked task gives up waiting
+	std::condition_variable turn; // the task's thread sleeps on this until it's handed the cpu
+};
+
+struct Mutex {
+	Task *owner = nullptr;
+	std::uint32_t count = 0;
+	bool recursive = false;
+};
+
+struct Kernel {
+	std::mutex handoff; // only guards passing the cpu around, whoever has the cpu owns everything else
+	std::uint64_t time = 0; // ms
+	bool started = false;
+	std::list<Task> tasks; // never shrinks so handles stay valid
+	Task host; // the thread running main(), it has the cpu whenever it isn't in waitFor/sleep
+	Task *running = nullptr;
+	std::uint32_t created = 0;
+	std::list<Mutex> mutexes;
+};
+
+Kernel &kernel() {
+	static Kernel instance;
+	return instance;
+}
+
+thread_local Task *current = nullptr;
+
+Task *self() {
+	return current ? current : &kernel().host;
+}
+
+Task *toTask(pros::task_t itask) {
+	return itask ? static_cast<Task *>(itask) : self();
+}
+
+bool ready(Task *itask) {
+	if (itask->state == pros::E_TASK_STATE_READY) return true;
+	if (itask->state != pros::E_TASK_STATE_BLOCKED) return false;
+	return itask->deleteRequested || itask->wake <= kernel().time || itask->waitingFor();
+}
+
+// highest priority first, then whoever has been waiting longest, then whoever was made first
+Task *pick() {
+	Kernel &k = kernel();
+	Task *best = ready(&k.host) ? &k.host : nullptr;
+	for (auto &task : k.tasks) {
+		if (!ready(&task)) continue;
+		if (!best || task.priority > best->priority ||
+		    (task.priority == best->priority && (task.wake < best->wake || (task.wake == best->wake && task.order < best->order)))) {
+			best = &task;
+		}
+	}
+	return best;
+}
+
+// hand the cpu to the next task, jumping the clock forward while nothing can run
+// iself goes back to sleep until it's picked again, unless it's finished
+void schedule(std::unique_lock<std::mutex> &ilock, Task *iself, bool ifinished) {
+	Kernel &k = kernel();
+	Task *next;
+	while (!(next = pick())) {
+		std::uint64_t wake = UINT64_MAX;
+		if (k.host.state == pros::E_TASK_STATE_BLOCKED) wake = k.host.wake;
+		for (auto &task : k.tasks) {
+			if (task.state == pros::E_TASK_STATE_BLOCKED) wake = std::min(wake, task.wake);
+		}
+		if (wake == UINT64_MAX) {
+			std::fprintf(stderr, "sim: every task is blocked forever at %llums\n", static_cast<unsigned long long>(k.time));
+			std::abort();
+		}
+		while (k.time < wake) {
+			robot().step(0.001);
+			k.time++;
+		}
+	}
+	k.running = next;
+	next->turn.notify_one();
+	if (!ifinished) iself->turn.wait(ilock, [&] { return k.running == iself; });
+}
+
+// block the calling task until ipred is true, ims pass, or the task is deleted
+// before start() the host is the only thing running, so it just polls once
+template <typename P> bool block(P ipred, std::uint32_t ims) {
+	Kernel &k = kernel();
+	if (ipred()) return true;
+	if (!k.started || ims == 0) return false;
+	Task *task = self();
+	{
+		std::unique_lock<std::mutex> handoff(k.handoff);
+		task->waitingFor = ipred;
+		task->wake = ims == TIMEOUT_MAX ? UINT64_MAX : k.time + ims;
+		task->state = pros::E_TASK_STATE_BLOCKED;
+		schedule(handoff, task, false);
+		task->state = pros::E_TASK_STATE_RUNNING;
+		task->waitingFor = nullptr;
+		task->wake = k.time;
+	}
+	if (task->deleteRequested && current) throw TaskDeleted();
+	return ipred();
+}
+
+void notify(Task *itask, std::uint32_t ivalue, pros::notify_action_e_t iaction) {
+	switch (iaction) {
+	case pros::E_NOTIFY_ACTION_BITS: itask->notifyValue |= ivalue; break;
+	case pros::E_NOTIFY_ACTION_INCR: itask->notifyValue++; break;
+	case pros::E_NOTIFY_ACTION_OWRITE: itask->notifyValue = ivalue; break;
+	case pros::E_NOTIFY_ACTION_NO_OWRITE:
+		if (!itask->notifyValue) itask->notifyValue = ivalue;
+		break;
+	default: break;
+	}
+}
+
+void trampoline(Task *itask) {
+	Kernel &k = kernel();
+	{
+		std::unique_lock<std::mutex> handoff(k.handoff);
+		itask->turn.wait(handoff, [&] { return k.running == itask; });
+	}
+	current = itask;
+	if (!itask->deleteRequested) {
+		itask->state = pros::E_TASK_STATE_RUNNING;
+		try {
+			itask->function(itask->parameters);
+		} catch (const TaskDeleted &) {
+		}
+	}
+	std::unique_lock<std::mutex> handoff(k.handoff);
+	itask->state = pros::E_TASK_STATE_DELETED;
+	for (auto &watcher : itask->deleteWatchers) notify(watcher.task, watcher.value, watcher.action);
+	schedule(handoff, itask, true);
+}
+} // namespace
+
+void start() {
+	Kernel &k = kernel();
+	std::lock_guard<std::mutex> handoff(k.handoff);
+	k.host.name = "host";
+	k.host.state = pros::E_TASK_STATE_RUNNING;
+	k.running = &k.host;
+	k.started = true;
+}
+
+bool waitFor(pros::task_t itask, std::uint32_t itimeout) {
+	Task *task = toTask(itask);
+	return block([task] { return task->state == pros::E_TASK_STATE_DELETED; }, itimeout);
+}
+
+void sleep(std::uint32_t ims) {
+	block([] { return false; }, ims);
+}
+
+} // namespace sim
+
+namespace pros {
+namespace c {
+
+std::uint32_t millis() {
+	return static_cast<std::uint32_t>(sim::kernel().time);
+}
+
+task_t task_create(task_fn_t function, void *const parameters, std::uint32_t prio, const std::uint16_t, const char *const name) {
+	sim::Kernel &k = sim::kernel();
+	sim::Task *task = &k.tasks.emplace_back();
+	task->name = name ? name : "";
+	task->function = function;
+	task->parameters = parameters;
+	task->priority = prio;
+	task->order = ++k.created;
+	task->wake = k.time;
+	std::thread(sim::trampoline, task).detach();
+	return task;
+}
+
+void task_delete(task_t task) {
+	sim::Task *target = sim::toTask(task);
+	if (target == &sim::kernel().host || target->state == E_TASK_STATE_DELETED) return;
+	target->deleteRequested = true;
+	if (target == sim::current) throw sim::TaskDeleted();
+}
+
+void task_delay(const std::uint32_t milliseconds) {
+	sim::block([] { return false; }, milliseconds);
+}
+
+void delay(const std::uint32_t milliseconds) {
+	task_delay(milliseconds);
+}
+
+void task_delay_until(std::uint32_t *const prev_time, const std::uint32_t delta) {
+	const std::uint32_t wake = *prev_time + delta;
+	if (wake > millis()) sim::block([] { return false; }, wake - millis());
+	*prev_time = wake;
+}
+
+std::uint32_t task_get_priority(task_t task) {
+	return sim::toTask(task)->priority;
+}
+
+void task_set_priority(task_t task, std::uint32_t prio) {
+	sim::toTask(task)->priority = prio;
+}
+
+task_state_e_t task_get_state(task_t task) {
+	return sim::toTask(task)->state;
+}
+
+void task_suspend(task_t) {}
+
+void task_resume(task_t) {}
+
+std::uint32_t task_get_count() {
+	std::uint32_t count = 0;
+	for (auto &task : sim::kernel().tasks) count += task.state != E_TASK_STATE_DELETED;
+	return count;
+}
+
+char *task_get_name(task_t task) {
+	return const_cast<char *>(sim::toTask(task)->name.c_str());
+}
+
+task_t task_get_by_name(const char *name) {
+	for (auto &task : sim::kernel().tasks) {
+		if (task.state != E_TASK_STATE_DELETED && task.name == name) return &task;
+	}
+	return nullptr;
+}
+
+task_t task_get_current() {
+	return sim::self();
+}
+
+std::uint32_t task_notify(task_t task) {
+	sim::notify(sim::toTask(task), 0, E_NOTIFY_ACTION_INCR);
+	return 1;
+}
+
+std::uint32_t task_notify_ext(task_t task, std::uint32_t value, notify_action_e_t action, std::uint32_t *prev_value) {
+	sim::Task *target = sim::toTask(task);
+	if (prev_value) *prev_value = target->notifyValue;
+	if (action == E_NOTIFY_ACTION_NO_OWRITE && target->notifyValue) return 0;
+	sim::notify(target, value, action);
+	return 1;
+}
+
+std::uint32_t task_notify_take(bool clear_on_exit, std::uint32_t timeout) {
+	sim::Task *task = sim::self();
+	sim::block([&] { return task->notifyValue > 0; }, timeout);
+	const std::uint32_t value = task->notifyValue;
+	if (value) task->notifyValue = clear_on_exit ? 0 : value - 1;
+	return value;
+}
+
+bool task_notify_clear(task_t task) {
+	sim::Task *target = sim::toTask(task);
+	const bool wasPending = target->notifyValue;
+	target->notifyValue = 0;
+	return wasPending;
+}
+
+void task_notify_when_deleting(task_t target_task, task_t task_to_notify, std::uint32_t value, notify_action_e_t notify_action) {
+	sim::toTask(target_task)->deleteWatchers.push_back({sim::toTask(task_to_notify), value, notify_action});
+}
+
+bool task_abort_delay(task_t) {
+	return false;
+}
+
+mutex_t mutex_create() {
+	sim::kernel().mutexes.emplace_back();
+	return &sim::kernel().mutexes.back();
+}
+
+mutex_t mutex_recursive_create() {
+	sim::kernel().mutexes.push_back({nullptr, 0, true});
+	return &sim::kernel().mutexes.back();
+}
+
+bool mutex_take(mutex_t mutex, std::uint32_t timeout) {
+	auto *m = static_cast<sim::Mutex *>(mutex);
+	sim::Task *task = sim::self();
+	if (!sim::block([&] { return !m->owner || (m->recursive && m->owner == task); }, timeout)) return false;
+	m->owner = task;
+	m->count++;
+	return true;
+}
+
+bool mutex_give(mutex_t mutex) {
+	auto *m = static_cast<sim::Mutex *>(mutex);
+	if (m->owner != sim::self()) return false;
+	if (--m->count == 0) {
+		m->owner = nullptr;
+	}
+	return true;
+}
+
+bool mutex_recursive_take(mutex_t mutex, std::uint32_t timeout) {
+	return mutex_take(mutex, timeout);
+}
+
+bool mutex_recursive_give(mutex_t mutex) {
+	return mutex_give(mutex);
+}
+
+task_t mutex_get_owner(mutex_t mutex) {
+	return static_cast<sim::Mutex *>(mutex)->owner;
+}
+
+} // namespace c
+
+using namespace pros::c;
+
+Task::Task(task_fn_t function, void *parameters, std::uint32_t prio, std::uint16_t stack_depth, const char *name) {
+	task = task_create(function, parameters, prio, stack_depth, name);
+}
+
+Task::Task(task_fn_t function, void *parameters, const char *name)
+    : Task(function, parameters, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, name) {}
+
+Task::Task(task_t itask) : task(itask) {}
+
+void Task::operator=(const task_t in) {
+	task = in;
+}
+
+Task Task::current() {
+	return Task(task_get_current());
+}
+
+void Task::remove() {
+	task_delete(task);
+}
+
+std::uint32_t Task::get_priority() {
+	return task_get_priority(task);
+}
+
+void Task::set_priority(std::uint32_t prio) {
+	task_set_priority(task, prio);
+}
+
+std::uint32_t Task::get_state() {
+	return task_get_state(task);
+}
+
+void Task::suspend() {
+	task_suspend(task);
+}
+
+void Task::resume() {
+	task_resume(task);
+}
+
+const char *Task::get_name() {
+	return task_get_name(task);
+}
+
+std::uint32_t Task::notify() {
+	return task_notify(task);
+}
+
+std::uint32_t Task::notify_ext(std::uint32_t value, notify_action_e_t action, std::uint32_t *prev_value) {
+	return task_notify_ext(task, value, action, prev_value);
+}
+
+std::uint32_t Task::notify_take(bool clear_on_exit, std::uint32_t timeout) {
+	return task_notify_take(clear_on_exit, timeout);
+}
+
+bool Task::notify_clear() {
+	return task_notify_clear(task);
+}
+
+void Task::delay(const std::uint32_t milliseconds) {
+	task_delay(milliseconds);
+}
+
+void Task::delay_until(std::uint32_t *const prev_time, const std::uint32_t delta) {
+	task_delay_until(prev_time, delta);
+}
+
+std::uint32_t Task::get_count() {
+	return task_get_count();
+}
+
+Mutex::Mutex() : mutex(mutex_create()) {}
+
+bool Mutex::take(std::uint32_t timeout) {
+	return mutex_take(mutex, timeout);
+}
+
+bool Mutex::give() {
+	return mutex_give(mutex);
+}
+
+} // namespace pros
@@ -0,0 +1,310 @@
+#include <cmath>
+#include <random>
+#include "sim/robot.hpp"
+#include "korvexlib.h"
+
+namespace sim {
+
+namespace {
+constexpr double inch = 0.0254;
+constexpr double cubePeriod = 600; // deg of intake rotation between cubes passing the line sensor
+constexpr double cubeWindow = 180; // deg either side of a cube center where the sensor is covered
+constexpr std::int32_t lineUncovered = 3950; // raw 12 bit readings
+constexpr std::int32_t lineCovered = 950;
+
+constexpr double gravity = 9.81;
+constexpr double slipSpeed = 0.05; // m/s of wheel slip where the tires are at full grip
+constexpr int substeps = 4; // per step, the tires are stiff enough to need it
+constexpr double degPerRad = 180 / M_PI;
+
+// a sign that fades in around 0 so friction doesn't chatter when something is stopped
+double smoothSign(double ix, double iwidth) {
+	return std::tanh(ix / iwidth);
+}
+
+// cedar as built, the ports come straight from korvexlib.h
+RobotConfig cedarConfig() {
+	RobotConfig config;
+	config.leftDrive = {LEFT_MTR1, LEFT_MTR2};
+	config.rightDrive = {RIGHT_MTR1, RIGHT_MTR2};
+	config.driveWheelDiameter = 4 * inch;
+	config.driveTrack = 8.125 * inch;
+	config.chassis.mass = 6.5;
+	config.chassis.inertia = 0.25;
+	config.chassis.wheelbase = 11 * inch;
+	config.chassis.length = 18 * inch;
+	config.chassis.traction = 1.0;
+	config.chassis.scrub = 0.25; // all omnis
+	config.chassis.sideInertia = 0.004;
+	config.chassis.rollingResistance = 2;
+	config.chassis.bumper = 65000; // about 30ms from full speed to stopped against a wall, squashing under a cm
+	config.loads = {
+		{LIFT_MTR, 0.05, 0.3},
+		{TRAY_MTR, 0.05, 0.3},
+		{INTAKE_MTR1, 0.003, 0.05},
+		{INTAKE_MTR2, 0.003, 0.05},
+	};
+	config.tracking[0] = {1, 2.75 * inch, -2.3 * inch, false, 1, 0}; // left, A & B
+	config.tracking[1] = {5, 2.75 * inch, 2.3 * inch, false, 1, 0}; // right, E & F
+	config.tracking[2] = {3, 2.75 * inch, -3 * inch, true, 1, 0}; // strafe, C & D
+	config.intakePort = INTAKE_MTR1;
+	config.linePort = LINE_PORT - 'A' + 1;
+	config.imuPort = IMU_PORT;
+	return config;
+}
+} // namespace
+
+Variation typicalVariation() {
+	Variation variation;
+	variation.encoderScale = 0.005;
+	variation.encoderNoise = 2;
+	variation.imuDrift = 0.1 / 180 * M_PI / 60; // 0.1 deg a minute
+	variation.imuNoise = 0.02 / 180 * M_PI;
+	variation.intakeDelay = 90;
+	variation.intakeSpacing = 0.1;
+	variation.traction = 0.1;
+	variation.startPosition = 0.25 * inch;
+	variation.startHeading = 0.5 / 180 * M_PI;
+	return variation;
+}
+
+double SmartMotor::maxRpm() const {
+	switch (gearset) {
+	case pros::E_MOTOR_GEARSET_36: return 100;
+	case pros::E_MOTOR_GEARSET_06: return 600;
+	default: return 200;
+	}
+}
+
+double SmartMotor::stallTorque() const {
+	return maxRpm() == 100 ? 2.1 : maxRpm() == 600 ? 0.35 : 1.05;
+}
+
+double SmartMotor::ticksPerRev() const {
+	return maxRpm() == 100 ? 1800 : maxRpm() == 600 ? 300 : 900;
+}
+
+double SmartMotor::toDegrees(double iunits) const {
+	switch (units) {
+	case pros::E_MOTOR_ENCODER_ROTATIONS: return iunits * 360;
+	case pros::E_MOTOR_ENCODER_COUNTS: return iunits * 360 / ticksPerRev();
+	default: return iunits;
+	}
+}
+
+double SmartMotor::fromDegrees(double ideg) const {
+	return ideg / toDegrees(1);
+}
+
+Robot::Robot(const RobotConfig &iconfig) : config(iconfig) {
+	for (auto &load : config.loads) {
+		motors.at(load.port).inertia = load.inertia;
+		motors.at(load.port).friction = load.friction;
+	}
+	batteryVoltage = config.battery.voltage * 1000;
+}
+
+void Robot::vary(const Variation &ivariation, std::uint64_t iseed) {
+	variation = ivariation;
+	rng.seed(iseed);
+	auto draw = [&](double isd) { return isd * gaussian(rng); };
+	for (auto &scale : encoderScale) scale = 1 + draw(variation.encoderScale);
+	for (auto &scale : tractionScale) scale = std::max(0.1, 1 + draw(variation.traction));
+	imuBias = draw(variation.imuDrift);
+	cubePhase = draw(variation.intakeDelay);
+	cubeSpacing = std::max(0.5, 1 + draw(variation.intakeSpacing));
+	pose.x = draw(variation.startPosition);
+	pose.y = draw(variation.startPosition);
+	pose.theta = draw(variation.startHeading);
+	imuOffset = pose.theta;
+}
+
+SmartMotor &Robot::motor(std::uint8_t iport) {
+	SmartMotor &motor = motors.at(iport);
+	motor.plugged = true;
+	return motor;
+}
+
+// what the motor's internal controller does with the last command, sets the voltage it applies
+void Robot::control(SmartMotor &motor, double imaxVoltage, double idt) {
+	const double maxSpeed = motor.maxRpm() * 6; // deg/s
+	const double kf = 12000 / maxSpeed;
+	double voltage = 0;
+	motor.driven = true;
+
+	auto velocityControl = [&](double itarget) {
+		const double error = itarget - motor.velocity;
+		motor.integral = std::max(-6000.0, std::min(6000.0, motor.integral + 20 * kf * error * idt));
+		return kf * itarget + 2 * kf * error + motor.integral;
+	};
+	switch (motor.mode) {
+	case SmartMotor::Mode::voltage:
+		motor.integral = 0;
+		voltage = motor.sign() * motor.targetVoltage;
+		if (voltage == 0) {
+			if (motor.brakeMode == pros::E_MOTOR_BRAKE_COAST) motor.driven = false;
+			else if (motor.brakeMode == pros::E_MOTOR_BRAKE_HOLD) voltage = 20 * kf * (motor.holdPosition - motor.position);
+			// brake shorts the windings, which is just 0 V
+		}
+		else motor.holdPosition = motor.position;
+		break;
+	case SmartMotor::Mode::velocity:
+		voltage = velocityControl(motor.sign() * motor.targetVelocity * 6);
+		motor.holdPosition = motor.position;
+		break;
+	case SmartMotor::Mode::position: {
+		const double error = motor.sign() * motor.toDegrees(motor.targetPosition) + motor.zero - motor.position;
+		const double cap = std::abs(motor.profileVelocity) * 6;
+		const double decel = std::sqrt(2 * maxSpeed * 8 * std::abs(error)); // full speed in 1/8 s
+		voltage = velocityControl(std::copysign(std::min(cap, decel), error));
+		motor.holdPosition = motor.position;
+		break;
+	}
+	}
+	motor.voltage = std::max(-imaxVoltage, std::min(imaxVoltage, voltage));
+}
+
+// linear torque/speed curve, the current limit caps it at stall torque
+void Robot::applyTorque(SmartMotor &motor) const {
+	if (!motor.driven) {
+		motor.torque = 0;
+		motor.current = 0;
+		return;
+	}
+	const double load = motor.voltage / 12000 - motor.velocity / (motor.maxRpm() * 6);
+	motor.torque = motor.stallTorque() * std::max(-1.0, std::min(1.0, load));
+	motor.current = 2500 * std::abs(motor.torque) / motor.stallTorque();
+}
+
+// each side's motors spin its wheels, the tires push the chassis depending on how much they slip
+void Robot::stepDrive(double idt) {
+	const ChassisConfig &chassis = config.chassis;
+	const double radius = config.driveWheelDiameter / 2;
+	const double normal = chassis.mass * gravity / 2; // per side
+	std::array<double, 2> force{};
+	for (int side = 0; side < 2; side++) {
+		const auto &ports = side == 0 ? config.leftDrive : config.rightDrive;
+		const double sign = side == 0 ? 1 : -1; // right side motors are mounted mirrored, so physical negative is forward
+		double torque = 0;
+		for (auto port : ports) {
+			const SmartMotor &motor = motors.at(port);
+			torque += sign * motor.torque - motor.friction * smoothSign(wheelSpeed[side], 0.1);
+		}
+		const double ground = velocity + sign * angularVelocity * config.driveTrack / 2;
+		force[side] = chassis.traction * tractionScale[side] * normal * smoothSign(wheelSpeed[side] * radius - ground, slipSpeed);
+		wheelSpeed[side] += (torque - force[side] * radius) / chassis.sideInertia * idt;
+		for (auto port : ports) {
+			SmartMotor &motor = motors.at(port);
+			motor.velocity = sign * wheelSpeed[side] * degPerRad;
+			motor.position += motor.velocity * idt;
+		}
+	}
+
+	// turning drags every wheel sideways, about half the wheelbase out from the center
+	const double scrubTorque = chassis.scrub * chassis.mass * gravity * chassis.wheelbase / 2;
+	velocity += (force[0] + force[1] - chassis.rollingResistance * smoothSign(velocity, 0.01)) / chassis.mass * idt;
+	angularVelocity += ((force[0] - force[1]) * config.driveTrack / 2 - scrubTorque * smoothSign(angularVelocity, 0.05)) / chassis.inertia * idt;
+}
+
+// a bumper that's into a wall squashes like a critically damped spring and pushes the robot back out, so it stops over
+// a few ms like a real bumper and not dead in one step. the chassis only moves along its heading so there's no sliding
+// along the wall, it just stops
+void Robot::collide(double idt) {
+	const ChassisConfig &chassis = config.chassis;
+	const double headingX = std::cos(pose.theta), headingY = std::sin(pose.theta);
+	const double damping = 2 * std::sqrt(chassis.bumper * chassis.mass);
+	for (const Wall &wall : walls) {
+		const double facing = headingX * wall.normalX + headingY * wall.normalY; // - when the front points at the wall
+		if (std::abs(facing) < 0.05) continue; // side on, we'd just scrape along it
+		const double end = facing < 0 ? chassis.length / 2 : -chassis.length / 2; // the bumper that's toward it
+		const double depth = -((pose.x + end * headingX - wall.x) * wall.normalX + (pose.y + end * headingY - wall.y) * wall.normalY);
+		if (depth <= 0) continue;
+		const double push = std::max(0.0, chassis.bumper * depth - damping * velocity * facing); // N out of the wall, it never pulls
+		velocity += push * facing / chassis.mass * idt;
+	}
+}
+
+bool Robot::isDrive(std::uint8_t iport) const {
+	for (auto port : config.leftDrive) if (port == iport) return true;
+	for (auto port : config.rightDrive) if (port == iport) return true;
+	return false;
+}
+
+void Robot::step(double idt) {
+	const double dt = idt / substeps;
+	const double startVelocity = velocity;
+	for (int i = 0; i < substeps; i++) {
+		const double maxVoltage = std::min(12000.0, batteryVoltage);
+		double current = 0;
+		for (std::uint8_t port = 1; port < motors.size(); port++) {
+			SmartMotor &motor = motors[port];
+			if (!motor.plugged) continue;
+			control(motor, maxVoltage, dt);
+			applyTorque(motor);
+			current += motor.current;
+			if (isDrive(port)) continue;
+			const double drag = motor.friction * smoothSign(motor.velocity, 5);
+			motor.velocity += (motor.torque - drag) / motor.inertia * degPerRad * dt;
+			motor.position += motor.velocity * dt;
+		}
+		stepDrive(dt);
+		batteryCurrent = current;
+		batteryVoltage = (config.battery.voltage - config.battery.resistance * current / 1000) * 1000;
+
+		pose.theta += angularVelocity * dt;
+		pose.x += velocity * std::cos(pose.theta) * dt;
+		pose.y += velocity * std::sin(pose.theta) * dt;
+		collide(dt);
+		for (std::size_t w = 0; w < config.tracking.size(); w++) {
+			TrackingWheel &wheel = config.tracking[w];
+			double roll = wheel.strafe ? angularVelocity * wheel.offset * dt : (velocity - angularVelocity * wheel.offset) * dt;
+			if (variation.encoderNoise > 0) {
+				const double tick = M_PI * wheel.diameter / 360; // m
+				roll += variation.encoderNoise * std::sqrt(std::abs(roll)) * gaussian(rng) * tick;
+			}
+			wheel.travel += roll * encoderScale[w];
+		}
+		intakeChain += motors.at(config.intakePort).velocity * dt;
+		imuError += imuBias * dt;
+		if (variation.imuNoise > 0) imuError += variation.imuNoise * std::sqrt(dt) * gaussian(rng);
+	}
+	acceleration = (velocity - startVelocity) / idt;
+	imuTime += idt;
+}
+
+std::int32_t Robot::encoderTicks(std::uint8_t iport) const {
+	for (std::size_t i = 0; i < config.tracking.size(); i++) {
+		const auto &wheel = config.tracking[i];
+		if (wheel.port == iport) {
+			const double deg = wheel.sign * wheel.travel / (M_PI * wheel.diameter) * 360;
+			return static_cast<std::int32_t>(std::lround(deg - encoderZero[i]));
+		}
+	}
+	return 0;
+}
+
+void Robot::resetEncoder(std::uint8_t iport) {
+	for (std::size_t i = 0; i < config.tracking.size(); i++) {
+		const auto &wheel = config.tracking[i];
+		if (wheel.port == iport) encoderZero[i] = wheel.sign * wheel.travel / (M_PI * wheel.diameter) * 360;
+	}
+}
+
+std::int32_t Robot::analogRead(std::uint8_t iport) const {
+	if (iport != config.linePort) return 0;
+	const double phase = std::remainder(intakeChain - cubePhase, cubePeriod * cubeSpacing);
+	return std::abs(phase) < cubeWindow ? lineCovered : lineUncovered;
+}
+
+Robot &robot() {
+	static Robot cedar(cedarConfig());
+	return cedar;
+}
+
+std::uint8_t adiPort(std::uint8_t iport) {
+	if (iport >= 'a' && iport <= 'h') return iport - 'a' + 1;
+	if (iport >= 'A' && iport <= 'H') return iport - 'A' + 1;
+	return iport;
+}
+
+} // namespace sim
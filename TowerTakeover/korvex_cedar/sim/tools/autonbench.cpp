@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "sim/results.hpp"
+
+// runs every auton through cedarsim and compares it to the last saved baseline
+// usage: autonbench [--save] [--baseline <file>]
+// exits 1 if any auton runs out its period, or got slower, ends somewhere else than the baseline, or a motion call stops further off
+
+namespace {
+using sim::Result;
+using sim::Step;
+
+constexpr double timeSlack = 0.05; // s
+constexpr double poseSlack = 1; // in
+constexpr double errorSlack = 1; // cm or deg, a motion call finishing this much further off than it used to fails
+
+std::string dirOf(const std::string &ipath) {
+	const auto slash = ipath.rfind('/');
+	return slash == std::string::npos ? "." : ipath.substr(0, slash);
+}
+
+Result run(const std::string &isim, const std::string &iauton) {
+	return sim::parse(iauton, sim::lines(isim + " --auton " + iauton));
+}
+
+// one auton per line: name done|timeout seconds x y theta odomX odomY odomTheta ms:error,ms:error,... a motion call each
+void write(std::ostream &out, const Result &iresult) {
+	out << iresult.auton << ' ' << (iresult.finished ? "done" : "timeout") << ' ' << iresult.time;
+	for (double value : iresult.pose) out << ' ' << value;
+	for (double value : iresult.odom) out << ' ' << value;
+	out << ' ';
+	for (std::size_t i = 0; i < iresult.steps.size(); i++) out << (i ? "," : "") << iresult.steps[i].ms << ':' << iresult.steps[i].error;
+	if (iresult.steps.empty()) out << '-';
+	out << '\n';
+}
+
+std::vector<Result> read(const std::string &ipath) {
+	std::vector<Result> out;
+	std::ifstream file(ipath);
+	std::string line;
+	while (std::getline(file, line)) {
+		if (line.empty() || line[0] == '#') continue;
+		std::istringstream in(line);
+		Result result;
+		std::string state, motions;
+		in >> result.auton >> state >> result.time;
+		for (double &value : result.pose) in >> value;
+		for (double &value : result.odom) in >> value;
+		in >> motions;
+		result.finished = state == "done";
+		std::istringstream list(motions);
+		std::string motion;
+		while (std::getline(list, motion, ',')) {
+			if (motion == "-") continue;
+			result.steps.emplace_back();
+			result.steps.back().ms = std::stoi(motion);
+			const auto colon = motion.find(':'); // baselines from before the errors were saved don't have them
+			result.steps.back().error = colon == std::string::npos ? NAN : std::stod(motion.substr(colon + 1));
+		}
+		out.push_back(result);
+	}
+	return out;
+}
+
+const Result *find(const std::vector<Result> &iresults, const std::string &iauton) {
+	for (auto &result : iresults) {
+		if (result.auton == iauton) return &result;
+	}
+	return nullptr;
+}
+
+double poseShift(const Result &a, const Result &b) {
+	return std::hypot(a.pose[0] - b.pose[0], a.pose[1] - b.pose[1]);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+	const std::string bin = dirOf(argv[0]);
+	std::string baselinePath = bin + "/../bench/baseline.txt";
+	bool save = false;
+	for (int i = 1; i < argc; i++) {
+		if (!std::strcmp(argv[i], "--save")) save = true;
+		else if (!std::strcmp(argv[i], "--baseline") && i + 1 < argc) baselinePath = argv[++i];
+		else {
+			std::fprintf(stderr, "usage: autonbench [--save] [--baseline <file>]\n");
+			return 2;
+		}
+	}
+
+	const std::string sim = bin + "/cedarsim";
+	const auto baseline = read(baselinePath);
+	std::vector<Result> results;
+	bool regressed = false;
+
+	std::printf("%-13s %-8s %8s %8s %8s %9s %9s  %s\n", "auton", "result", "time", "motions", "slowest", "odom err", "heading", "vs baseline");
+	for (auto &auton : sim::lines(sim + " --list")) {
+		const Result result = run(sim, auton);
+		results.push_back(result);
+
+		int slowest = 0;
+		for (auto &step : result.steps) slowest = std::max(slowest, step.ms);
+		const double odomError = std::hypot(result.pose[0] - result.odom[0], result.pose[1] - result.odom[1]);
+		const double headingError = std::remainder(result.pose[2] - result.odom[2], 360);
+		std::printf("%-13s %-8s %7.2fs %8zu %6dms %7.2fin %7.2fdeg  ", result.auton.c_str(), result.finished ? "done" : "timeout",
+		            result.time, result.steps.size(), slowest, odomError, headingError);
+
+		// a motion call that stops further off than it used to, ie the settle rules traded accuracy for time
+		const Result *before = find(baseline, auton);
+		bool worse = false;
+		for (std::size_t i = 0; before && i < result.steps.size() && i < before->steps.size(); i++) {
+			worse |= std::abs(result.steps[i].error) > std::abs(before->steps[i].error) + errorSlack;
+		}
+		// an auton that runs out the period fails whatever the baseline says, it never gets to finish on the field either
+		regressed |= !result.finished;
+		if (!before) std::printf("new%s\n", result.finished ? "" : "  TIMEOUT");
+		else {
+			const bool slower = result.time > before->time + timeSlack || (before->finished && !result.finished);
+			const bool moved = poseShift(result, *before) > poseSlack;
+			regressed |= slower || moved || worse;
+			std::printf("%+.2fs, ends %.1fin away%s\n", result.time - before->time, poseShift(result, *before),
+			            !result.finished ? "  TIMEOUT" : slower ? "  SLOWER" : moved ? "  MOVED" : worse ? "  LESS ACCURATE" : "");
+		}
+
+		// per motion call, against the same call in the baseline
+		std::printf("  motions ms:");
+		for (std::size_t i = 0; i < result.steps.size(); i++) {
+			std::printf(" %d", result.steps[i].ms);
+			if (before && i < before->steps.size() && before->steps[i].ms != result.steps[i].ms) {
+				std::printf("(%+d)", result.steps[i].ms - before->steps[i].ms);
+			}
+		}
+		std::printf("\n");
+
+		// and what each was still off by, * if it gave up stalled rather than settling
+		std::printf("  motions error:");
+		for (std::size_t i = 0; i < result.steps.size(); i++) {
+			const Step &step = result.steps[i];
+			std::printf(" %.1f%s", step.error, step.reason == "stalled" ? "*" : "");
+			if (before && i < before->steps.size() && std::abs(step.error) > std::abs(before->steps[i].error) + errorSlack) {
+				std::printf("(was %.1f)", before->steps[i].error);
+			}
+		}
+		std::printf("\n");
+	}
+
+	if (save) {
+		std::ofstream file(baselinePath);
+		file << "# written by autonbench --save\n";
+		file << "# auton done|timeout seconds x y theta odomX odomY odomTheta motion_ms:error,...\n";
+		for (auto &result : results) write(file, result);
+		std::printf("saved %s\n", baselinePath.c_str());
+		return 0;
+	}
+	return regressed ? 1 : 0;
+}
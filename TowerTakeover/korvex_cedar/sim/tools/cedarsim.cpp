@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "main.h"
+#include "trackingOdometry.hpp"
+#include "purePursuit.hpp"
+#include "telemetry.hpp"
+#include "sim/kernel.hpp"
+#include "sim/robot.hpp"
+#include "sim/screen.hpp"
+
+// runs korvex_cedar's initialize and then an auton or opcontrol on the simulated brain
+// usage: cedarsim [--auton <name> | --move <driveQ:x,y | driveP:left,right | turnP:deg | driveChain:x,y,... | followPath:x,y,theta,... | driveToPose:x,y,theta>] [--opcontrol <seconds>] [--seed <n>]
+//                 [--drive-gains kp,ki,kd] [--turn-gains kp,ki,kd] [--odom-log] [--telemetry-log dir/] [--list] [--print-gains]
+// the robot's own logging goes to stdout as usual, the sim's results are the lines starting with "sim: "
+// --seed gives the robot a random but repeatable bit of sensor noise, slip and placement error, 0 is the nominal robot
+// --move runs one motion call from the origin instead of an auton and traces the pose every 10ms, for pidtune
+//        or to try out a driveChain through some waypoints, followPath along a spline through some poses or driveToPose
+// --odom-log turns on the odom's sensor log and adds "sim: truth <ms> x y theta" every 10ms, for ekfreplay
+// --print-gains prints main.cpp's driveGains and turnGains as "drive kp,ki,kd" and "turn kp,ki,kd", for pidtune
+// --telemetry-log writes the binary log the brain writes to /usd/ into that directory instead, for logdecode and stepstats
+
+extern std::shared_ptr<okapi::OdomChassisController> chassis;
+extern TrackingOdometry odometry;
+extern bool logMoves;
+
+// main.cpp's motion functions and their gains
+struct pidGains {
+	float kp;
+	float ki;
+	float kd;
+};
+extern pidGains driveGains;
+extern pidGains turnGains;
+void driveQ(okapi::QLength targetX, okapi::QLength targetY, bool backwards, float voltageMax, bool forceFlip, bool debugLog);
+void turnP(int targetTurn, int voltageMax, bool debugLog);
+void driveP(int targetLeft, int targetRight, int voltageMax, bool debugLog);
+void driveChain(const std::vector<okapi::Point> &waypoints, bool backwards, int voltageMax, float sharpTurn, bool debugLog);
+void followPath(const PursuitPath &path, bool backwards, bool debugLog);
+struct PoseSettle {
+	float distance = 3;
+	float angle = 3;
+	int dwell = 100;
+	int timeout = 4000;
+	float velocity = 5;
+};
+void driveToPose(okapi::QLength targetX, okapi::QLength targetY, okapi::QAngle targetTheta, float lead, bool backwards, float voltageMax, PoseSettle settle, bool debugLog);
+
+namespace {
+// auton name -> the brain screen tab and button that select it
+const std::map<std::string, std::pair<std::string, std::string>> autons = {
+	{"redUnprotec", {"Red", "Unprotec"}},
+	{"redProtec", {"Red", "Protec"}},
+	{"redRick", {"Red", "Rick"}},
+	{"blueUnprotec", {"Blue", "Unprotec"}},
+	{"blueProtec", {"Blue", "Protec"}},
+	{"blueRick", {"Blue", "Rick"}},
+	{"skills", {"Skills", "Skills"}},
+	{"characterize", {"Skills", "Characterize"}},
+};
+
+// the bits of field wall an auton runs into on purpose, in its starting frame (in, normal pointing into the field)
+// skills' zone wall is the diagonal one across the corner, square to the ram, where the old 700ms ram had cedar up
+// against it for the last 200ms of it. it's angled away enough the backup onto the tower later doesn't reach it
+const std::map<std::string, std::vector<std::array<double, 4>>> autonWalls = {
+	{"skills", {{128.2, 9.6, -0.891, -0.454}}},
+};
+
+void trampoline(void *ifunction) {
+	reinterpret_cast<void (*)()>(ifunction)();
+}
+
+pros::task_t run(void (*ifunction)(), const char *iname) {
+	return pros::c::task_create(trampoline, reinterpret_cast<void *>(ifunction), TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, iname);
+}
+
+// the move to run with --move, set before its task starts
+std::vector<double> moveArgs;
+
+void moveDrive() {
+	driveQ(moveArgs[0] * okapi::inch, moveArgs[1] * okapi::inch, false, 115, false, false);
+}
+
+void moveDriveP() {
+	driveP(static_cast<int>(moveArgs[0]), static_cast<int>(moveArgs[1]), 115, false);
+}
+
+void moveTurn() {
+	turnP(static_cast<int>(moveArgs[0]), 127, false);
+}
+
+void moveChain() {
+	std::vector<okapi::Point> waypoints;
+	for (std::size_t i = 0; i + 1 < moveArgs.size(); i += 2) waypoints.push_back({moveArgs[i] * okapi::inch, moveArgs[i + 1] * okapi::inch});
+	driveChain(waypoints, false, 115, 45, false);
+}
+
+void movePath() {
+	std::vector<okapi::OdomState> waypoints;
+	for (std::size_t i = 0; i + 2 < moveArgs.size(); i += 3) waypoints.push_back({moveArgs[i] * okapi::inch, moveArgs[i + 1] * okapi::inch, moveArgs[i + 2] * okapi::degree});
+	followPath(PursuitPath(waypoints), false, false);
+}
+
+void movePose() {
+	driveToPose(moveArgs[0] * okapi::inch, moveArgs[1] * okapi::inch, moveArgs[2] * okapi::degree, 0.6, false, 115, PoseSettle(), false);
+}
+
+// the numbers after "<name>:", comma separated
+std::vector<double> parseArgs(const std::string &imove, const std::string &iname) {
+	std::vector<double> args;
+	if (imove.compare(0, iname.size() + 1, iname + ":")) return args;
+	const char *text = imove.c_str() + iname.size() + 1;
+	char *end;
+	for (double value = std::strtod(text, &end); end != text; value = std::strtod(text, &end)) {
+		args.push_back(value);
+		text = *end == ',' ? end + 1 : end;
+	}
+	return args;
+}
+
+bool parseGains(const char *itext, pidGains &ogains) {
+	return std::sscanf(itext, "%f,%f,%f", &ogains.kp, &ogains.ki, &ogains.kd) == 3;
+}
+
+void usage() {
+	std::fprintf(stderr, "usage: cedarsim [--auton <name> | --move <driveQ:x,y | driveP:left,right | turnP:deg | driveChain:x,y,... | followPath:x,y,theta,... | driveToPose:x,y,theta>] [--opcontrol <seconds>] [--seed <n>]\n"
+	                     "                [--drive-gains kp,ki,kd] [--turn-gains kp,ki,kd] [--odom-log] [--telemetry-log dir/] [--list] [--print-gains]\nautons:");
+	for (auto &auton : autons) std::fprintf(stderr, " %s", auton.first.c_str());
+	std::fprintf(stderr, "\n");
+	std::_Exit(2); // exit() hangs on the robot's global objects
+}
+
+void printPose(const std::string &ikey) {
+	const sim::Pose &pose = sim::robot().pose;
+	std::printf("sim: %s %.2f %.2f %.2f\n", ikey.c_str(), pose.x / 0.0254, pose.y / 0.0254, pose.theta * 180 / M_PI);
+}
+
+// passes the robot's cout through, and after each motion's "task complete" line adds "sim: step x y theta"
+// with where the robot really is, so the tools can see where a run starts to wander
+class StepLog : public std::streambuf {
+	public:
+	explicit StepLog(std::streambuf *iout) : out(iout) {
+	}
+
+	protected:
+	int overflow(int c) override {
+		if (c == traits_type::eof()) return 0;
+		out->sputc(c);
+		if (c != '\n') {
+			line += char(c);
+			return c;
+		}
+		if (line.find("task complete") != std::string::npos) {
+			out->pubsync();
+			printPose("step");
+		}
+		line.clear();
+		return c;
+	}
+
+	int sync() override {
+		return out->pubsync();
+	}
+
+	std::streambuf *out;
+	std::string line;
+};
+
+// like sim::waitFor, with --odom-log it prints where the robot really is every 10ms on the way
+bool odomLog = false;
+bool waitTracing(pros::task_t itask, std::uint32_t ilimit) {
+	if (!odomLog) return sim::waitFor(itask, ilimit);
+	const std::uint32_t start = pros::c::millis();
+	bool finished = false;
+	while (!finished && pros::c::millis() - start < ilimit) {
+		finished = sim::waitFor(itask, std::min<std::uint32_t>(10, ilimit - (pros::c::millis() - start)));
+		printPose("truth " + std::to_string(pros::c::millis()));
+	}
+	return finished;
+}
+
+// sim: <what> <done|timeout> <seconds>, then where the robot really is and where odom thinks it is (in, in, deg)
+void report(const std::string &iwhat, bool ifinished, std::uint32_t ims) {
+	const OdomPose odom = odometry.getPose();
+	std::printf("sim: %s %s %.3f\n", iwhat.c_str(), ifinished ? "done" : "timeout", ims / 1000.0);
+	printPose("pose");
+	std::printf("sim: odom %.2f %.2f %.2f\n", odom.x / 2.54, odom.y / 2.54, odom.theta * 180 / M_PI);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+	std::string auton = "redProtec";
+	std::uint32_t opcontrolTime = 0;
+	unsigned long long seed = 0;
+	std::string move;
+	const char *telemetryLog = nullptr;
+	for (int i = 1; i < argc; i++) {
+		if (!std::strcmp(argv[i], "--auton") && i + 1 < argc) auton = argv[++i];
+		else if (!std::strcmp(argv[i], "--opcontrol") && i + 1 < argc) opcontrolTime = std::atoi(argv[++i]) * 1000;
+		else if (!std::strcmp(argv[i], "--move") && i + 1 < argc) move = argv[++i];
+		else if (!std::strcmp(argv[i], "--drive-gains") && i + 1 < argc) {
+			if (!parseGains(argv[++i], driveGains)) usage();
+		}
+		else if (!std::strcmp(argv[i], "--turn-gains") && i + 1 < argc) {
+			if (!parseGains(argv[++i], turnGains)) usage();
+		}
+		else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) seed = std::strtoull(argv[++i], nullptr, 10);
+		else if (!std::strcmp(argv[i], "--odom-log")) odomLog = true;
+		else if (!std::strcmp(argv[i], "--telemetry-log") && i + 1 < argc) telemetryLog = argv[++i];
+		else if (!std::strcmp(argv[i], "--print-gains")) {
+			std::printf("drive %g,%g,%g\nturn %g,%g,%g\n", driveGains.kp, driveGains.ki, driveGains.kd, turnGains.kp, turnGains.ki, turnGains.kd);
+			std::fflush(stdout);
+			std::_Exit(0);
+		}
+		else if (!std::strcmp(argv[i], "--list")) {
+			for (auto &name : autons) std::printf("%s\n", name.first.c_str());
+			std::fflush(stdout);
+			std::_Exit(0);
+		}
+		else usage();
+	}
+	if (!autons.count(auton)) usage();
+	void (*moveFunction)() = nullptr;
+	if (!move.empty()) {
+		if ((moveArgs = parseArgs(move, "driveQ")).size() == 2) moveFunction = moveDrive;
+		else if ((moveArgs = parseArgs(move, "driveP")).size() == 2) moveFunction = moveDriveP;
+		else if ((moveArgs = parseArgs(move, "turnP")).size() == 1) moveFunction = moveTurn;
+		else if ((moveArgs = parseArgs(move, "driveChain")).size() >= 2 && moveArgs.size() % 2 == 0) moveFunction = moveChain;
+		else if ((moveArgs = parseArgs(move, "followPath")).size() >= 6 && moveArgs.size() % 3 == 0) moveFunction = movePath;
+		else if ((moveArgs = parseArgs(move, "driveToPose")).size() == 3) moveFunction = movePose;
+		else usage();
+	}
+	if (seed) sim::robot().vary(sim::typicalVariation(), seed);
+	if (autonWalls.count(auton)) {
+		for (auto &wall : autonWalls.at(auton)) sim::robot().walls.push_back({wall[0] * 0.0254, wall[1] * 0.0254, wall[2], wall[3]});
+	}
+
+	StepLog stepLog(std::cout.rdbuf());
+	std::cout.rdbuf(&stepLog);
+	if (odomLog) odometry.setLogging(true);
+	// the sim has no sd card, so this is what initialize does when there is one
+	if (telemetryLog) {
+		if (!telemetry().openLog(telemetryLog)) {
+			std::fprintf(stderr, "couldn't make a log in %s\n", telemetryLog);
+			return 2;
+		}
+		odometry.setLogging(true);
+		logMoves = true;
+	}
+
+	pros::task_t init = run(initialize, "User Initialization (PROS)");
+	sim::start();
+	sim::waitFor(init, TIMEOUT_MAX);
+
+	if (moveFunction) {
+		// sim: trace <ms since the move started> x y theta, then the usual report
+		// the trace keeps going half a second past the return so drifting after the robot calls it done shows up
+		const std::uint32_t start = pros::c::millis();
+		pros::task_t task = run(moveFunction, "User Autonomous (PROS)");
+		bool finished = false;
+		while (!finished && pros::c::millis() - start < 10000) {
+			finished = sim::waitFor(task, 10);
+			printPose("trace " + std::to_string(pros::c::millis() - start));
+			if (odomLog) printPose("truth " + std::to_string(pros::c::millis()));
+		}
+		if (!finished) pros::c::task_delete(task);
+		const std::uint32_t end = pros::c::millis();
+		while (pros::c::millis() - end < 500) {
+			sim::sleep(10);
+			printPose("trace " + std::to_string(pros::c::millis() - start));
+			if (odomLog) printPose("truth " + std::to_string(pros::c::millis()));
+		}
+		report(move, finished, end - start);
+		telemetry().flushLog();
+		telemetry().drain(); // what the drain task hadn't got to yet
+		std::fflush(stdout);
+		std::_Exit(0);
+	}
+
+	const auto &button = autons.at(auton);
+	if (!sim::screen::press(button.first, button.second)) std::fprintf(stderr, "couldn't select %s\n", auton.c_str());
+
+	const std::uint32_t limit = auton == "skills" || auton == "characterize" ? 60000 : 15000;
+	std::uint32_t start = pros::c::millis();
+	pros::task_t task = run(autonomous, "User Autonomous (PROS)");
+	const bool finished = waitTracing(task, limit);
+	if (!finished) pros::c::task_delete(task);
+	report(auton, finished, pros::c::millis() - start);
+
+	if (opcontrolTime) {
+		start = pros::c::millis();
+		task = run(opcontrol, "User Operator Control (PROS)");
+		waitTracing(task, opcontrolTime);
+		pros::c::task_delete(task);
+		report("opcontrol", false, pros::c::millis() - start);
+	}
+
+	// the robot's tasks never return, so leave without running their destructors
+	telemetry().flushLog();
+	telemetry().drain();
+	std::fflush(stdout);
+	std::_Exit(0);
+}
@@ -0,0 +1,148 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// fits driveP's feedforward and the effective track width from the characterize auton's log
+// usage: drivefit [log]            reads stdin without a log
+//        bin/cedarsim --auton characterize | bin/drivefit
+// quasistatic and dynamic samples fit volts = kS*sign(v) + kV*v + kA*a for each side and both together,
+// spin samples fit track = (vLeft - vRight) / rate, the tracking wheels' effective track for withOdometry in main.cpp
+
+namespace {
+struct Sample {
+	std::string test;
+	double volts[2], velocity[2], acceleration[2];
+	double rate; // deg/s
+};
+
+constexpr double minVelocity = 2; // cm/s, under this the robot is stuck in static friction and kS*sign(v) is a lie
+constexpr double minRate = 10; // deg/s
+
+// the usual least squares, solving the normal equations for volts = kS*sign(v) + kV*v + kA*a
+struct Fit {
+	double kS = 0, kV = 0, kA = 0, r2 = 0;
+	int n = 0;
+};
+
+bool solve3(double a[3][3], double b[3], double out[3]) {
+	for (int col = 0; col < 3; col++) {
+		int pivot = col;
+		for (int row = col + 1; row < 3; row++)
+			if (std::abs(a[row][col]) > std::abs(a[pivot][col])) pivot = row;
+		if (std::abs(a[pivot][col]) < 1e-12) return false;
+		std::swap(a[col], a[pivot]);
+		std::swap(b[col], b[pivot]);
+		for (int row = col + 1; row < 3; row++) {
+			const double factor = a[row][col] / a[col][col];
+			for (int k = col; k < 3; k++) a[row][k] -= factor * a[col][k];
+			b[row] -= factor * b[col];
+		}
+	}
+	for (int row = 2; row >= 0; row--) {
+		double sum = b[row];
+		for (int k = row + 1; k < 3; k++) sum -= a[row][k] * out[k];
+		out[row] = sum / a[row][row];
+	}
+	return true;
+}
+
+Fit fit(const std::vector<Sample> &isamples, const std::vector<int> &isides) {
+	double ata[3][3] = {}, atb[3] = {};
+	std::vector<std::pair<std::vector<double>, double>> rows;
+	for (const Sample &sample : isamples) {
+		if (sample.test == "spin") continue;
+		for (int side : isides) {
+			if (std::abs(sample.velocity[side]) < minVelocity) continue;
+			const double x[3] = {sample.velocity[side] > 0 ? 1.0 : -1.0, sample.velocity[side], sample.acceleration[side]};
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 3; j++) ata[i][j] += x[i] * x[j];
+				atb[i] += x[i] * sample.volts[side];
+			}
+			rows.push_back({{x[0], x[1], x[2]}, sample.volts[side]});
+		}
+	}
+	Fit result;
+	result.n = rows.size();
+	double k[3];
+	if (!solve3(ata, atb, k)) return result;
+	result.kS = k[0];
+	result.kV = k[1];
+	result.kA = k[2];
+
+	double mean = 0, total = 0, residual = 0;
+	for (const auto &row : rows) mean += row.second / rows.size();
+	for (const auto &row : rows) {
+		const double predicted = k[0] * row.first[0] + k[1] * row.first[1] + k[2] * row.first[2];
+		total += (row.second - mean) * (row.second - mean);
+		residual += (row.second - predicted) * (row.second - predicted);
+	}
+	result.r2 = total > 0 ? 1 - residual / total : 0;
+	return result;
+}
+
+void print(const char *iname, const Fit &ifit) {
+	std::printf("%-6s kS %.3f V  kV %.4f V/(cm/s)  kA %.4f V/(cm/s^2)  r^2 %.3f  (%d samples)\n", iname, ifit.kS, ifit.kV, ifit.kA, ifit.r2, ifit.n);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+	if (argc > 2 || (argc == 2 && (!std::strcmp(argv[1], "-h") || !std::strcmp(argv[1], "--help")))) {
+		std::cerr << "usage: drivefit [log]\n";
+		return 2;
+	}
+	std::ifstream file;
+	if (argc == 2) {
+		file.open(argv[1]);
+		if (!file) {
+			std::cerr << "drivefit: can't open " << argv[1] << "\n";
+			return 2;
+		}
+	}
+	std::istream &in = argc == 2 ? file : std::cin;
+
+	// <ms>: char <test> <volts left> <volts right> <cm/s left> <cm/s right> <cm/s^2 left> <cm/s^2 right> <deg/s>
+	std::vector<Sample> samples;
+	std::string line;
+	while (std::getline(in, line)) {
+		const auto at = line.find(": char ");
+		if (at == std::string::npos) continue;
+		std::istringstream fields(line.substr(at + 7));
+		Sample sample;
+		if (fields >> sample.test >> sample.volts[0] >> sample.volts[1] >> sample.velocity[0] >> sample.velocity[1] >> sample.acceleration[0] >> sample.acceleration[1] >> sample.rate)
+			samples.push_back(sample);
+	}
+	if (samples.empty()) {
+		std::cerr << "drivefit: no characterize lines in the log\n";
+		return 1;
+	}
+
+	const Fit left = fit(samples, {0}), right = fit(samples, {1}), both = fit(samples, {0, 1});
+	print("left", left);
+	print("right", right);
+	print("both", both);
+
+	// the rate is clockwise, so turning right has the left side going forward faster
+	double vw = 0, ww = 0;
+	int spins = 0;
+	for (const Sample &sample : samples) {
+		if (sample.test != "spin" || std::abs(sample.rate) < minRate) continue;
+		const double rate = sample.rate * M_PI / 180;
+		vw += (sample.velocity[0] - sample.velocity[1]) * rate;
+		ww += rate * rate;
+		spins++;
+	}
+	if (spins) std::printf("track  %.1f cm (%.2f in) effective  (%d samples)\n", vw / ww, vw / ww / 2.54, spins);
+	else std::printf("track  no spin samples over %.0f deg/s\n", minRate);
+
+	if (both.n < 3) {
+		std::cerr << "drivefit: not enough moving samples to fit\n";
+		return 1;
+	}
+	std::printf("\nFeedforward driveFeedforward = {%.3g, %.3g, %.3g};\n", both.kS, both.kV, both.kA);
+	return 0;
+}
@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "poseEkf.hpp"
+
+// runs the odom's PoseEkf over its sensor log, the same filter the robot runs, so the noise can be tuned on the computer
+// usage: ekfreplay [--noise acceleration,angularAcceleration,trackingWheel,driveWheel,imuHeading,gyro[,gate]] [log]
+//        bin/cedarsim --auton skills --odom-log | bin/ekfreplay
+//        on the robot turn on odometry.setLogging, save the terminal with pros terminal > odom.log and bin/ekfreplay odom.log
+// the geometry and noise come from the log's "odom config" line, --noise tries some other noise (0 leaves that sensor out)
+// prints where the filter ends up next to the tracking wheels on their own, so it's clear what the imu and the drive
+// motors add, and with the sim's "sim: truth" lines how far off each got along the way
+// then how long an update takes on this computer, for the brain's number turn on odomDebug
+
+namespace {
+// a reading, or a setPose that landed right after it
+struct Event {
+	OdomReading reading;
+	bool setPose = false;
+	float pose[3]; // cm, cm, radians
+};
+
+struct Truth {
+	double x, y, theta; // in, in, degrees
+};
+
+struct Result {
+	EkfState end;
+	double maxError = 0; // in
+	double sumSquare = 0;
+	double maxHeading = 0; // degrees
+	int compared = 0;
+	int rejected[2] = {}; // drive left, right
+};
+
+Result replay(const std::vector<Event> &ievents, const EkfConfig &iconfig, bool iaccelerometer, const std::map<std::uint32_t, Truth> &itruth) {
+	PoseEkf ekf(iconfig);
+	Result result;
+	for (const Event &event : ievents) {
+		if (event.setPose) {
+			ekf.setPose(event.pose[0], event.pose[1], event.pose[2]);
+			continue;
+		}
+		OdomReading reading = event.reading;
+		if (!iaccelerometer) reading.accelX = reading.accelY = NAN;
+		ekf.update(reading);
+		if (ekf.getRejected() & PoseEkf::leftDrive) result.rejected[0]++;
+		if (ekf.getRejected() & PoseEkf::rightDrive) result.rejected[1]++;
+
+		const auto truth = itruth.find(reading.time);
+		if (truth == itruth.end()) continue;
+		const EkfState state = ekf.getState();
+		const double error = std::hypot(state.x / 2.54 - truth->second.x, state.y / 2.54 - truth->second.y);
+		result.maxError = std::max(result.maxError, error);
+		result.sumSquare += error * error;
+		result.maxHeading = std::max(result.maxHeading, std::abs(state.theta * 180 / M_PI - truth->second.theta));
+		result.compared++;
+	}
+	result.end = ekf.getState();
+	return result;
+}
+
+void print(const char *iname, const Result &iresult) {
+	std::printf("%-12s %7.2f %7.2f %7.2f", iname, iresult.end.x / 2.54, iresult.end.y / 2.54, iresult.end.theta * 180 / M_PI);
+	if (iresult.compared) std::printf("  %7.2f %7.2f %9.2f", iresult.maxError, std::sqrt(iresult.sumSquare / iresult.compared), iresult.maxHeading);
+	std::printf("\n");
+}
+
+void usage() {
+	std::cerr << "usage: ekfreplay [--noise acceleration,angularAcceleration,trackingWheel,driveWheel,imuHeading,gyro[,gate]] [log]\n";
+	std::exit(2);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+	const char *path = nullptr;
+	const char *noiseText = nullptr;
+	for (int i = 1; i < argc; i++) {
+		if (!std::strcmp(argv[i], "--noise") && i + 1 < argc) noiseText = argv[++i];
+		else if (argv[i][0] != '-' && !path) path = argv[i];
+		else usage();
+	}
+	std::ifstream file;
+	if (path) {
+		file.open(path);
+		if (!file) {
+			std::cerr << "ekfreplay: can't open " << path << "\n";
+			return 2;
+		}
+	}
+	std::istream &in = path ? file : std::cin;
+
+	EkfConfig config{};
+	bool configured = false;
+	std::vector<Event> events;
+	std::map<std::uint32_t, Truth> truth;
+	std::string line;
+	while (std::getline(in, line)) {
+		if (!line.compare(0, 11, "sim: truth ")) {
+			std::istringstream fields(line.substr(11));
+			std::uint32_t time;
+			Truth pose;
+			if (fields >> time >> pose.x >> pose.y >> pose.theta) truth[time] = pose;
+			continue;
+		}
+		const auto at = line.find(": odom ");
+		if (at == std::string::npos) continue;
+		std::istringstream fields(line.substr(at + 7));
+		if (!line.compare(at + 7, 7, "config ")) {
+			std::string word;
+			EkfNoise &noise = config.noise;
+			fields >> word;
+			configured = bool(fields >> config.cmPerTick >> config.leftOffset >> config.rightOffset >> config.strafeOffset >> config.driveCmPerTick >> config.driveOffset
+				>> noise.acceleration >> noise.angularAcceleration >> noise.trackingWheel >> noise.driveWheel >> noise.imuHeading >> noise.gyro >> noise.gate);
+			continue;
+		}
+		Event event;
+		if (!line.compare(at + 7, 5, "pose ")) {
+			std::string word;
+			event.setPose = true;
+			if (!(fields >> word >> event.pose[0] >> event.pose[1] >> event.pose[2])) continue;
+		}
+		else {
+			OdomReading &reading = event.reading;
+			// pros terminal prints inf for PROS_ERR_F, which >> won't take
+			std::string driveLeft, driveRight, rotation, gyro, accelX, accelY;
+			if (!(fields >> reading.left >> reading.right >> reading.strafe >> driveLeft >> driveRight >> rotation >> gyro >> accelX >> accelY)) continue;
+			reading.time = std::stoul(line.substr(0, at));
+			reading.driveLeft = std::strtod(driveLeft.c_str(), nullptr);
+			reading.driveRight = std::strtod(driveRight.c_str(), nullptr);
+			reading.rotation = std::strtod(rotation.c_str(), nullptr);
+			reading.gyro = std::strtod(gyro.c_str(), nullptr);
+			reading.accelX = std::strtod(accelX.c_str(), nullptr);
+			reading.accelY = std::strtod(accelY.c_str(), nullptr);
+		}
+		events.push_back(event);
+	}
+	if (!configured) {
+		std::cerr << "ekfreplay: no odom config line in the log, was it started with setLogging?\n";
+		return 1;
+	}
+	if (events.empty()) {
+		std::cerr << "ekfreplay: no odom readings in the log\n";
+		return 1;
+	}
+	if (noiseText) {
+		EkfNoise &noise = config.noise;
+		if (std::sscanf(noiseText, "%f,%f,%f,%f,%f,%f,%f", &noise.acceleration, &noise.angularAcceleration, &noise.trackingWheel, &noise.driveWheel, &noise.imuHeading,
+		                &noise.gyro, &noise.gate) < 6)
+			usage();
+	}
+
+	int readings = 0;
+	for (const Event &event : events) readings += !event.setPose;
+	std::printf("%d readings over %.1fs\n", readings, (events.back().reading.time - events.front().reading.time) / 1000.0);
+	std::printf("             end x (in)     y   theta%s\n", truth.empty() ? "" : "  max err rms err max heading");
+
+	const Result ekf = replay(events, config, true, truth);
+	print("ekf", ekf);
+	EkfConfig wheels = config;
+	wheels.noise.driveWheel = wheels.noise.imuHeading = wheels.noise.gyro = 0;
+	print("wheels only", replay(events, wheels, false, truth));
+	std::printf("thrown out   drive left %d, drive right %d\n", ekf.rejected[0], ekf.rejected[1]);
+
+	// time just the filter, over enough passes to get a steady number
+	const std::map<std::uint32_t, Truth> none;
+	int passes = 0;
+	const auto start = std::chrono::steady_clock::now();
+	std::chrono::duration<double> elapsed{};
+	while (elapsed.count() < 0.5) {
+		replay(events, config, true, none);
+		passes++;
+		elapsed = std::chrono::steady_clock::now() - start;
+	}
+	std::printf("an update takes %.0fns here\n", elapsed.count() * 1e9 / passes / readings);
+	return 0;
+}
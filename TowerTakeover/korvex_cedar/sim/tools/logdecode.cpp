@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// turns a telemetry log off the brain's sd card (/usd/cedarNNN.tlm, see include/telemetry.hpp) into a csv per channel
+// usage: logdecode <log> [out dir]
+//        bin/logdecode cedar004.tlm match4/ then open match4/odom.csv, match4/driveQ.csv... in whatever graphs
+// each csv is ms then the channel's fields, one row per record. channels that never logged don't get a file
+// prints how many records each channel had and over how long, and whether the ring dropped any
+// bin/cedarsim --auton skills --telemetry-log /tmp/ makes one to try it on
+
+namespace {
+struct Channel {
+	std::string name;
+	std::vector<std::string> fields;
+	std::string csv; // the rows so far
+	int records = 0;
+	std::uint32_t first = 0, last = 0; // ms
+};
+
+constexpr std::uint8_t version = 1;
+constexpr std::uint8_t droppedChannel = 255;
+
+void usage() {
+	std::cerr << "usage: logdecode <log> [out dir]\n";
+	std::exit(2);
+}
+
+// a 0 terminated string at at, moves at past it
+bool readString(const std::vector<std::uint8_t> &idata, std::size_t &at, std::string &out) {
+	const std::size_t end = std::find(idata.begin() + at, idata.end(), 0) - idata.begin();
+	if (end >= idata.size()) return false;
+	out.assign(idata.begin() + at, idata.begin() + end);
+	at = end + 1;
+	return true;
+}
+
+// little endian like the brain, whatever this computer is
+std::uint32_t readU32(const std::uint8_t *ibytes) {
+	return ibytes[0] | ibytes[1] << 8 | ibytes[2] << 16 | std::uint32_t(ibytes[3]) << 24;
+}
+
+float readF32(const std::uint8_t *ibytes) {
+	const std::uint32_t bits = readU32(ibytes);
+	float value;
+	std::memcpy(&value, &bits, 4);
+	return value;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+	if (argc < 2 || argc > 3) usage();
+	std::string outDir = argc == 3 ? argv[2] : ".";
+	if (outDir.back() != '/') outDir += '/';
+
+	std::ifstream file(argv[1], std::ios::binary);
+	if (!file) {
+		std::cerr << "logdecode: can't open " << argv[1] << "\n";
+		return 2;
+	}
+	const std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	if (data.size() < 6 || std::memcmp(data.data(), "KVXT", 4)) {
+		std::cerr << "logdecode: " << argv[1] << " isn't a telemetry log\n";
+		return 1;
+	}
+	if (data[4] != version) {
+		std::cerr << "logdecode: log is version " << int(data[4]) << ", this reads version " << int(version) << "\n";
+		return 1;
+	}
+	std::vector<Channel> channels(data[5]);
+	std::size_t at = 6;
+	for (Channel &channel : channels) {
+		std::string fields;
+		if (!readString(data, at, channel.name) || !readString(data, at, fields)) {
+			std::cerr << "logdecode: the channel list is cut off\n";
+			return 1;
+		}
+		std::istringstream words(fields);
+		for (std::string field; words >> field;) channel.fields.push_back(field);
+	}
+
+	int dropped = 0;
+	bool cut = false;
+	char number[32];
+	while (at < data.size()) {
+		if (at + 6 > data.size()) {
+			cut = true;
+			break;
+		}
+		const std::uint32_t time = readU32(&data[at]);
+		const std::uint8_t id = data[at + 4];
+		const std::uint8_t count = data[at + 5];
+		if (at + 6 + count * 4 > data.size()) {
+			cut = true;
+			break;
+		}
+		const std::uint8_t *values = &data[at + 6];
+		at += 6 + count * 4;
+
+		if (id == droppedChannel) {
+			if (count) dropped += readF32(values);
+			continue;
+		}
+		if (id >= channels.size()) {
+			std::cerr << "logdecode: record for channel " << int(id) << " at byte " << at << ", there's only " << channels.size() << ", stopping there\n";
+			break;
+		}
+		Channel &channel = channels[id];
+		if (!channel.records) channel.first = time;
+		channel.last = time;
+		channel.records++;
+		channel.csv += std::to_string(time);
+		for (int i = 0; i < count; i++) {
+			std::snprintf(number, sizeof(number), ",%g", readF32(values + i * 4));
+			channel.csv += number;
+		}
+		channel.csv += '\n';
+	}
+
+	std::printf("%-18s %8s %10s  file\n", "channel", "records", "seconds");
+	for (const Channel &channel : channels) {
+		if (!channel.records) continue;
+		std::string name = channel.name;
+		for (char &c : name) if (c == ' ') c = '_';
+		const std::string path = outDir + name + ".csv";
+		std::ofstream csv(path);
+		if (!csv) {
+			std::cerr << "logdecode: can't write " << path << "\n";
+			return 2;
+		}
+		csv << "ms";
+		for (const std::string &field : channel.fields) csv << "," << field;
+		csv << "\n" << channel.csv;
+		std::printf("%-18s %8d %10.2f  %s\n", channel.name.c_str(), channel.records, (channel.last - channel.first) / 1000.0, path.c_str());
+	}
+	if (dropped) std::printf("the ring dropped %d records, drain more often or log less\n", dropped);
+	if (cut) std::printf("the last record is cut off, the brain probably lost power mid write\n");
+	return 0;
+}
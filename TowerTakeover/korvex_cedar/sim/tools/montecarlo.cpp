@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sim/results.hpp"
+
+// runs one auton many times with a different seed each time (sensor noise, imu drift, intake timing, slip,
+// placement, see sim::typicalVariation) and shows how spread out the finish time and end pose get
+// usage: montecarlo [--auton <name>] [--runs <n>] [--jobs <n>]
+// every run is its own cedarsim process so they use all the cores, a seed always gives the same run
+
+namespace {
+using sim::Result;
+
+std::string dirOf(const std::string &ipath) {
+	const auto slash = ipath.rfind('/');
+	return slash == std::string::npos ? "." : ipath.substr(0, slash);
+}
+
+double distance(const double *a, const double *b) {
+	return std::hypot(a[0] - b[0], a[1] - b[1]);
+}
+
+double percentile(std::vector<double> ivalues, double ip) {
+	if (ivalues.empty()) return 0;
+	std::sort(ivalues.begin(), ivalues.end());
+	return ivalues[std::min(ivalues.size() - 1, std::size_t(ip * ivalues.size()))];
+}
+
+void printSpread(const char *iname, const std::vector<double> &ivalues) {
+	std::printf("%-16s %8.2f %8.2f %8.2f %8.2f\n", iname, percentile(ivalues, 0.05), percentile(ivalues, 0.5),
+	            percentile(ivalues, 0.95), percentile(ivalues, 1));
+}
+
+void usage() {
+	std::fprintf(stderr, "usage: montecarlo [--auton <name>] [--runs <n>] [--jobs <n>]\n");
+	std::exit(2);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+	std::string auton = "redRick";
+	int runs = 200;
+	int jobs = std::max(1u, std::thread::hardware_concurrency());
+	for (int i = 1; i < argc; i++) {
+		if (!std::strcmp(argv[i], "--auton") && i + 1 < argc) auton = argv[++i];
+		else if (!std::strcmp(argv[i], "--runs") && i + 1 < argc) runs = std::max(1, std::atoi(argv[++i]));
+		else if (!std::strcmp(argv[i], "--jobs") && i + 1 < argc) jobs = std::max(1, std::atoi(argv[++i]));
+		else usage();
+	}
+
+	const std::string sim = dirOf(argv[0]) + "/cedarsim --auton " + auton + " --seed ";
+	const auto begin = std::chrono::steady_clock::now();
+
+	// seed 0 is the nominal robot, everything else is measured against where it went
+	const Result nominal = sim::parse(auton, sim::lines(sim + "0"));
+	std::vector<Result> results(runs);
+	std::atomic<int> next{0};
+	std::vector<std::thread> workers;
+	for (int j = 0; j < jobs; j++) {
+		workers.emplace_back([&] {
+			for (int i = next++; i < runs; i = next++) results[i] = sim::parse(auton, sim::lines(sim + std::to_string(i + 1)));
+		});
+	}
+	for (auto &worker : workers) worker.join();
+	const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+	int finished = 0;
+	std::vector<double> times, endError, headingError, odomError;
+	for (auto &result : results) {
+		finished += result.finished;
+		times.push_back(result.time);
+		endError.push_back(distance(result.pose, nominal.pose));
+		headingError.push_back(std::abs(std::remainder(result.pose[2] - nominal.pose[2], 360)));
+		odomError.push_back(distance(result.pose, result.odom));
+	}
+
+	std::printf("%s: %d runs on %d cores in %.1fs, nominal %s in %.2fs\n", auton.c_str(), runs, jobs, wall,
+	            nominal.finished ? "done" : "timeout", nominal.time);
+	std::printf("finished %d/%d\n\n", finished, runs);
+	std::printf("%-16s %8s %8s %8s %8s\n", "", "p5", "p50", "p95", "max");
+	printSpread("time s", times);
+	printSpread("end off in", endError);
+	printSpread("heading off deg", headingError);
+	printSpread("odom wrong in", odomError);
+
+	// per motion call: how long it takes and how far from the nominal robot it leaves us
+	// the step that adds the most spread is the one to make more robust
+	std::printf("\n%4s %9s %7s %6s %9s %8s %8s\n", "step", "ms mean", "ms sd", "runs", "off in", "p95 in", "added");
+	double lastSpread = 0, worstGrowth = 0;
+	std::size_t worst = 0;
+	for (std::size_t s = 0; s < nominal.steps.size(); s++) {
+		std::vector<double> ms, off;
+		for (auto &result : results) {
+			if (s >= result.steps.size()) continue;
+			ms.push_back(result.steps[s].ms);
+			off.push_back(distance(result.steps[s].pose, nominal.steps[s].pose));
+		}
+		if (ms.empty()) break;
+		double mean = 0, variance = 0, spread = 0;
+		for (double value : ms) mean += value / ms.size();
+		for (double value : ms) variance += (value - mean) * (value - mean) / ms.size();
+		for (double value : off) spread += value * value / off.size();
+		spread = std::sqrt(spread);
+		std::printf("%4zu %9.0f %7.0f %6zu %9.2f %8.2f %+8.2f\n", s + 1, mean, std::sqrt(variance), ms.size(), spread,
+		            percentile(off, 0.95), spread - lastSpread);
+		if (spread - lastSpread > worstGrowth) {
+			worstGrowth = spread - lastSpread;
+			worst = s + 1;
+		}
+		lastSpread = spread;
+	}
+	if (worst) std::printf("\nstep %zu adds the most spread (%+.2fin rms)\n", worst, worstGrowth);
+	return 0;
+}
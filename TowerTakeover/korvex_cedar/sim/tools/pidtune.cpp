@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sim/results.hpp"
+
+// tunes driveQ's or turnP's gains in the sim with the same particle swarm okapi's PIDTuner uses
+// usage: pidtune [--loop drive|turn] [--iterations <n>] [--particles <n>] [--jobs <n>] [--seed <n>]
+// each particle is scored on a few moves (cedarsim --move) and every move of every particle runs at once
+// across the cores, cost per move is kSettle * settle time + kITAE * itae like PIDTuner, lower is better
+// prints the best gains next to what main.cpp has now (cedarsim --print-gains), paste them into driveGains/turnGains if they look good
+
+namespace {
+using sim::Result;
+
+struct Gains {
+	double kp, ki, kd;
+};
+
+// what to tune and what to try it on
+struct Loop {
+	const char *name;
+	const char *flag; // cedarsim option that sets the gains
+	Gains current; // what main.cpp has, filled in from cedarsim --print-gains
+	Gains min, max;
+	double band; // in or deg, inside this counts as settled
+	std::vector<std::string> moves;
+	double (*error)(const sim::Step &, const std::string &); // in or deg off the move's target at a trace sample
+};
+
+// same swarm constants as okapi::PIDTuner
+constexpr double inertia = 0.5;
+constexpr double confSelf = 1.1;
+constexpr double confSwarm = 1.2;
+constexpr double kSettle = 1;
+constexpr double kITAE = 2;
+constexpr double notSettled = 10; // s, what a move that never settles costs
+constexpr double horizon = 5; // s, itae counts the error out to here
+
+// driveQ from the origin to (x, y), error is how far the robot really is from the target
+double driveError(const sim::Step &isample, const std::string &imove) {
+	double x = 0, y = 0;
+	std::sscanf(imove.c_str(), "driveQ:%lf,%lf", &x, &y);
+	return std::hypot(x - isample.pose[0], y - isample.pose[1]);
+}
+
+double turnError(const sim::Step &isample, const std::string &imove) {
+	double target = 0;
+	std::sscanf(imove.c_str(), "turnP:%lf", &target);
+	return std::abs(target - isample.pose[2]);
+}
+
+const Loop drive = {"drive", "--drive-gains", {}, {0, 0, 0}, {0.2, 0.1, 2}, 1,
+                    {"driveQ:12,0", "driveQ:24,0", "driveQ:48,0"}, driveError};
+const Loop turn = {"turn", "--turn-gains", {}, {0, 0, 0}, {8, 1, 3}, 1,
+                   {"turnP:15", "turnP:45", "turnP:90", "turnP:180"}, turnError}; // 15 so the gains can still get a small turn going
+
+struct Score {
+	double cost = 0;
+	std::vector<double> settle; // s per move
+	std::vector<double> itae;
+};
+
+std::string dirOf(const std::string &ipath) {
+	const auto slash = ipath.rfind('/');
+	return slash == std::string::npos ? "." : ipath.substr(0, slash);
+}
+
+// settle time is the first sample after which the error stays inside the band, a move that never gets there costs
+// notSettled however quickly it gave up. itae is integrated over the trace with the error as a fraction of the move, so long
+// and short moves weigh the same, and past the end of the trace it keeps counting the error it stopped at out to horizon,
+// so gains that stop short don't get off lightly for having a short trace
+void score(const Loop &iloop, const std::string &imove, const Result &iresult, double &osettle, double &oitae) {
+	osettle = notSettled;
+	oitae = 0;
+	if (iresult.trace.empty()) return;
+	const double size = std::max(1.0, iloop.error(sim::Step{}, imove));
+	double last = 0, error = size;
+	bool inside = false;
+	for (auto &sample : iresult.trace) {
+		error = iloop.error(sample, imove);
+		const double t = sample.ms / 1000.0;
+		oitae += t * error / size * (t - last);
+		last = t;
+		if (error > iloop.band) inside = false;
+		else if (!inside) {
+			inside = true;
+			osettle = t;
+		}
+	}
+	if (!inside) osettle = notSettled;
+	if (last < horizon) oitae += (horizon + last) / 2 * error / size * (horizon - last); // t * error integrated from last to horizon
+}
+
+// run every (gains, move) pair on its own cedarsim, ijobs at a time
+std::vector<Score> evaluate(const std::string &isim, const Loop &iloop, const std::vector<Gains> &igains, int ijobs) {
+	const std::size_t moves = iloop.moves.size();
+	std::vector<Score> scores(igains.size());
+	for (auto &score : scores) {
+		score.settle.resize(moves);
+		score.itae.resize(moves);
+	}
+	std::atomic<std::size_t> next{0};
+	std::vector<std::thread> workers;
+	for (int j = 0; j < ijobs; j++) {
+		workers.emplace_back([&] {
+			for (std::size_t n = next++; n < igains.size() * moves; n = next++) {
+				const Gains &gains = igains[n / moves];
+				const std::string &move = iloop.moves[n % moves];
+				char args[128];
+				std::snprintf(args, sizeof(args), " %s %g,%g,%g --move %s", iloop.flag, gains.kp, gains.ki, gains.kd, move.c_str());
+				Score &out = scores[n / moves];
+				score(iloop, move, sim::parse(move, sim::lines(isim + args)), out.settle[n % moves], out.itae[n % moves]);
+			}
+		});
+	}
+	for (auto &worker : workers) worker.join();
+	for (auto &score : scores) {
+		for (std::size_t m = 0; m < moves; m++) score.cost += kSettle * score.settle[m] + kITAE * score.itae[m];
+	}
+	return scores;
+}
+
+// what main.cpp has now, so the swarm starts from it and it's what the best gets compared against
+bool currentGains(const std::string &isim, Loop &oloop) {
+	const std::string prefix = std::string(oloop.name) + " ";
+	for (auto &line : sim::lines(isim + " --print-gains")) {
+		if (!line.compare(0, prefix.size(), prefix)) {
+			Gains &gains = oloop.current;
+			return std::sscanf(line.c_str() + prefix.size(), "%lf,%lf,%lf", &gains.kp, &gains.ki, &gains.kd) == 3;
+		}
+	}
+	return false;
+}
+
+void printScore(const char *iname, const Loop &iloop, const Gains &igains, const Score &iscore) {
+	std::printf("%-8s kp %-8.4g ki %-8.4g kd %-8.4g cost %7.3f  settle", iname, igains.kp, igains.ki, igains.kd, iscore.cost);
+	for (std::size_t m = 0; m < iloop.moves.size(); m++) std::printf(" %s %.2fs", iloop.moves[m].c_str(), iscore.settle[m]);
+	std::printf("\n");
+}
+
+void usage() {
+	std::fprintf(stderr, "usage: pidtune [--loop drive|turn] [--iterations <n>] [--particles <n>] [--jobs <n>] [--seed <n>]\n");
+	std::exit(2);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+	Loop loop = drive;
+	std::size_t iterations = 5, particles = 16;
+	int jobs = std::max(1u, std::thread::hardware_concurrency());
+	unsigned seed = 1;
+	for (int i = 1; i < argc; i++) {
+		if (!std::strcmp(argv[i], "--loop") && i + 1 < argc) {
+			const std::string name = argv[++i];
+			if (name == "drive") loop = drive;
+			else if (name == "turn") loop = turn;
+			else usage();
+		}
+		else if (!std::strcmp(argv[i], "--iterations") && i + 1 < argc) iterations = std::max(1, std::atoi(argv[++i]));
+		else if (!std::strcmp(argv[i], "--particles") && i + 1 < argc) particles = std::max(1, std::atoi(argv[++i]));
+		else if (!std::strcmp(argv[i], "--jobs") && i + 1 < argc) jobs = std::max(1, std::atoi(argv[++i]));
+		else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) seed = std::atoi(argv[++i]);
+		else usage();
+	}
+	const std::string sim = dirOf(argv[0]) + "/cedarsim";
+	if (!currentGains(sim, loop)) {
+		std::fprintf(stderr, "pidtune: couldn't get the current gains out of %s --print-gains\n", sim.c_str());
+		return 2;
+	}
+
+	// same shape as PIDTuner::autotune, but a whole generation is scored at once
+	std::mt19937 rng(seed);
+	auto uniform = [&](double imin, double imax) { return std::uniform_real_distribution<double>(imin, imax)(rng); };
+	double Gains::*const terms[] = {&Gains::kp, &Gains::ki, &Gains::kd};
+
+	std::vector<Gains> position(particles), velocity(particles), best(particles);
+	std::vector<double> bestCost(particles, INFINITY);
+	for (std::size_t p = 0; p < particles; p++) {
+		for (auto term : terms) {
+			position[p].*term = uniform(loop.min.*term, loop.max.*term);
+			velocity[p].*term = uniform(-1, 1) * (loop.max.*term - loop.min.*term) / 10;
+		}
+	}
+	position[0] = loop.current; // start one particle from what the robot has now
+
+	const Score current = evaluate(sim, loop, {loop.current}, jobs)[0];
+	Gains globalBest = loop.current;
+	double globalCost = current.cost;
+	Score globalScore = current;
+	for (std::size_t iteration = 0; iteration < iterations; iteration++) {
+		const auto scores = evaluate(sim, loop, position, jobs);
+		for (std::size_t p = 0; p < particles; p++) {
+			if (scores[p].cost < bestCost[p]) {
+				bestCost[p] = scores[p].cost;
+				best[p] = position[p];
+			}
+			if (scores[p].cost < globalCost) {
+				globalCost = scores[p].cost;
+				globalBest = position[p];
+				globalScore = scores[p];
+			}
+		}
+		std::printf("iteration %zu: best cost %.3f\n", iteration + 1, globalCost);
+
+		for (std::size_t p = 0; p < particles; p++) {
+			for (auto term : terms) {
+				double &pos = position[p].*term;
+				double &vel = velocity[p].*term;
+				vel = inertia * vel + confSelf * uniform(0, 1) * (best[p].*term - pos) +
+				      confSwarm * uniform(0, 1) * (globalBest.*term - pos);
+				pos = std::max(loop.min.*term, std::min(loop.max.*term, pos + vel));
+			}
+		}
+	}
+
+	std::printf("\n%s loop, %zu particles x %zu iterations x %zu moves\n", loop.name, particles, iterations, loop.moves.size());
+	printScore("current", loop, loop.current, current);
+	printScore("best", loop, globalBest, globalScore);
+	std::printf("\npidGains %sGains = {%.4g, %.4g, %.4g};\n", loop.name, globalBest.kp, globalBest.ki, globalBest.kd);
+	return 0;
+}
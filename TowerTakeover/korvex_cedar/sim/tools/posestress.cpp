@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "seqLock.hpp"
+#include "trackingOdometry.hpp"
+
+// hammers the odom's SeqLock with real threads, one writer like the odom task and the rest reading, on one core it still
+// catches readers that get preempted halfway through a copy
+// every pose the writer puts out has all its fields worked out from one counter, so a reader that gets a mix of two
+// writes finds fields that don't agree
+// usage: posestress [--seconds n] [--readers n], readers defaults to one per core and at least 3
+// exits 1 if any read was torn
+
+namespace {
+OdomPose poseFor(std::uint32_t in) {
+	const float n = in;
+	return {n, -n, n * 0.5f, n * 2, n * 3, n * 4, in};
+}
+
+bool torn(const OdomPose &ipose) {
+	const float n = ipose.time;
+	return ipose.x != n or ipose.y != -n or ipose.theta != n * 0.5f or ipose.velocityX != n * 2 or ipose.velocityY != n * 3 or ipose.angularVelocity != n * 4;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+	double seconds = 2;
+	unsigned readers = std::max(3u, std::thread::hardware_concurrency());
+	for (int i = 1; i < argc; i++) {
+		if (!std::strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = std::atof(argv[++i]);
+		else if (!std::strcmp(argv[i], "--readers") && i + 1 < argc) readers = std::atoi(argv[++i]);
+		else {
+			std::fprintf(stderr, "usage: posestress [--seconds n] [--readers n]\n");
+			return 2;
+		}
+	}
+
+	// counters small enough that every float above is exact
+	constexpr std::uint32_t wrap = 1 << 20;
+	SeqLock<OdomPose> channel;
+	std::atomic<bool> stop{false};
+	std::atomic<std::uint64_t> writes{0};
+	std::vector<std::uint64_t> reads(readers), tornReads(readers), stale(readers);
+
+	std::thread writer([&] {
+		std::uint32_t n = 0;
+		while (!stop) {
+			n = (n + 1) % wrap;
+			channel.write(poseFor(n));
+			writes++;
+		}
+	});
+	std::vector<std::thread> threads;
+	for (unsigned r = 0; r < readers; r++) {
+		threads.emplace_back([&, r] {
+			std::uint32_t last = 0;
+			while (!stop) {
+				const OdomPose pose = channel.read();
+				reads[r]++;
+				if (torn(pose)) tornReads[r]++;
+				if (pose.time == last) stale[r]++;
+				last = pose.time;
+			}
+		});
+	}
+
+	std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+	stop = true;
+	writer.join();
+	for (auto &thread : threads) thread.join();
+
+	std::uint64_t totalReads = 0, totalTorn = 0, totalStale = 0;
+	for (unsigned r = 0; r < readers; r++) {
+		totalReads += reads[r];
+		totalTorn += tornReads[r];
+		totalStale += stale[r];
+	}
+	std::printf("%u readers, %.1fs: %llu writes, %llu reads (%.0f%% saw the same write twice), %llu torn\n", readers, seconds,
+	            (unsigned long long)writes, (unsigned long long)totalReads, totalReads ? 100.0 * totalStale / totalReads : 0.0,
+	            (unsigned long long)totalTorn);
+	return totalTorn ? 1 : 0;
+}
@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// how each move in a telemetry log (include/telemetry.hpp) responded, instead of graphing turnP's csv and squinting
+// usage: stepstats [--moves] [--band percent] <log.tlm>...
+//        bin/stepstats /media/usd/cedar*.tlm to line up a whole day of gain changes
+//        bin/cedarsim --auton skills --telemetry-log /tmp/ && bin/stepstats /tmp/cedar000.tlm for the sim's
+// a move is every record of a channel with the same start, so any channel with error and start fields gets picked up
+// (turnP and driveQ). per move, off its first error:
+//   rise       ms from 90% of the way left to 10%
+//   overshoot  how far past it went, % of where it started
+//   settle     ms till the error got inside --band % (5 by default) of where it started and stayed there, - if it never did
+//   steady     the error over the last 5 loops, signed
+//   saturated  % of loops the output was up against voltageMax
+// prints each channel's averages with a row per log, --moves lists every move too
+// logs get mapped rather than read and spread over every core, so a few thousand take seconds
+
+namespace {
+struct Move {
+	std::uint32_t start; // ms
+	float initial; // error at the start
+	float duration; // ms
+	float rise = NAN;
+	float overshoot = 0;
+	float settle = NAN;
+	float steady = 0;
+	float saturated = NAN;
+};
+
+struct Run {
+	std::string problem; // empty if it read fine
+	std::map<std::string, std::vector<Move>> moves; // by channel
+};
+
+struct Sample {
+	std::uint32_t time;
+	float error;
+	float output; // the biggest output's size
+	float cap; // NAN if the channel doesn't log voltageMax
+};
+
+// where a channel keeps the bits we want, -1 if it doesn't
+struct Columns {
+	std::string name;
+	int error = -1, start = -1, cap = -1;
+	std::vector<int> outputs;
+};
+
+double band = 0.05;
+
+std::uint32_t readU32(const std::uint8_t *ibytes) {
+	return ibytes[0] | ibytes[1] << 8 | ibytes[2] << 16 | std::uint32_t(ibytes[3]) << 24;
+}
+
+float readF32(const std::uint8_t *ibytes) {
+	const std::uint32_t bits = readU32(ibytes);
+	float value;
+	std::memcpy(&value, &bits, 4);
+	return value;
+}
+
+Move analyze(const std::vector<Sample> &isamples) {
+	const Sample &first = isamples.front();
+	Move move;
+	move.start = first.time;
+	move.initial = first.error;
+	move.duration = isamples.back().time - first.time;
+	const float size = std::abs(first.error);
+	const float sign = first.error < 0 ? -1 : 1;
+
+	float furthest = 0; // past the target
+	std::uint32_t at90 = 0;
+	bool seen90 = false, seen10 = false;
+	int lastOutside = -1;
+	int saturated = 0;
+	for (std::size_t i = 0; i < isamples.size(); i++) {
+		const Sample &sample = isamples[i];
+		const float left = sample.error * sign; // still to go, negative past it
+		if (!seen90 and left <= 0.9f * size) {
+			seen90 = true;
+			at90 = sample.time;
+		}
+		if (seen90 and !seen10 and left <= 0.1f * size) {
+			seen10 = true;
+			move.rise = sample.time - at90;
+		}
+		furthest = std::max(furthest, -left);
+		if (std::abs(sample.error) > band * size) lastOutside = i;
+		if (sample.cap > 0 and sample.output >= 0.99f * sample.cap) saturated++;
+	}
+	move.overshoot = furthest / size * 100;
+	if (lastOutside < 0) move.settle = 0;
+	else if (lastOutside + 1 < (int)isamples.size()) move.settle = isamples[lastOutside + 1].time - first.time;
+
+	const std::size_t tail = std::min<std::size_t>(5, isamples.size());
+	for (std::size_t i = isamples.size() - tail; i < isamples.size(); i++) move.steady += isamples[i].error / tail;
+	if (std::isfinite(first.cap)) move.saturated = 100.0f * saturated / isamples.size();
+	return move;
+}
+
+Run readRun(const char *ipath) {
+	Run run;
+	const int fd = open(ipath, O_RDONLY);
+	if (fd < 0) {
+		run.problem = "can't open it";
+		return run;
+	}
+	struct stat info;
+	if (fstat(fd, &info) || info.st_size < 6) {
+		close(fd);
+		run.problem = "isn't a telemetry log";
+		return run;
+	}
+	const std::size_t length = info.st_size;
+	void *mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapped == MAP_FAILED) {
+		run.problem = "can't map it";
+		return run;
+	}
+	madvise(mapped, length, MADV_SEQUENTIAL);
+	const std::uint8_t *data = static_cast<const std::uint8_t *>(mapped);
+
+	if (std::memcmp(data, "KVXT", 4) or data[4] != 1) run.problem = "isn't a version 1 telemetry log";
+
+	// the channel list, two 0 terminated strings each
+	std::vector<Columns> channels(data[5]);
+	std::size_t at = 6;
+	for (Columns &channel : channels) {
+		if (!run.problem.empty()) break;
+		const std::uint8_t *end = static_cast<const std::uint8_t *>(std::memchr(data + at, 0, length - at));
+		const std::uint8_t *fieldsEnd = end ? static_cast<const std::uint8_t *>(std::memchr(end + 1, 0, length - (end + 1 - data))) : nullptr;
+		if (!fieldsEnd) {
+			run.problem = "channel list is cut off";
+			break;
+		}
+		channel.name.assign(data + at, end);
+		const std::string fields(end + 1, fieldsEnd);
+		at = fieldsEnd + 1 - data;
+		int column = 0;
+		for (std::size_t from = 0; from < fields.size(); column++) {
+			std::size_t to = fields.find(' ', from);
+			if (to == std::string::npos) to = fields.size();
+			const std::string field = fields.substr(from, to - from);
+			if (field == "error") channel.error = column;
+			else if (field == "start") channel.start = column;
+			else if (field == "voltageMax") channel.cap = column;
+			else if (!field.compare(0, 7, "voltage")) channel.outputs.push_back(column);
+			from = to + 1;
+		}
+	}
+
+	// each channel's current move, analysed when its start changes
+	std::vector<std::vector<Sample>> current(channels.size());
+	std::vector<float> currentStart(channels.size(), NAN);
+	auto finish = [&](std::size_t ichannel) {
+		if (!current[ichannel].empty() and current[ichannel].front().error != 0) run.moves[channels[ichannel].name].push_back(analyze(current[ichannel]));
+		current[ichannel].clear();
+	};
+	while (run.problem.empty() and at + 6 <= length) {
+		const std::uint32_t time = readU32(data + at);
+		const std::uint8_t id = data[at + 4];
+		const std::uint8_t count = data[at + 5];
+		const std::uint8_t *values = data + at + 6;
+		if (at + 6 + count * 4 > length) break; // cut off by the power going
+		at += 6 + count * 4;
+		if (id >= channels.size()) continue; // dropped counts, or a channel we don't know
+		const Columns &channel = channels[id];
+		if (channel.error < 0 or channel.start < 0 or channel.error >= count or channel.start >= count) continue;
+
+		const float start = readF32(values + channel.start * 4);
+		if (start != currentStart[id]) {
+			finish(id);
+			currentStart[id] = start;
+		}
+		Sample sample{time, readF32(values + channel.error * 4), 0, NAN};
+		for (int output : channel.outputs) {
+			if (output < count) sample.output = std::max(sample.output, std::abs(readF32(values + output * 4)));
+		}
+		if (channel.cap >= 0 and channel.cap < count) sample.cap = readF32(values + channel.cap * 4);
+		current[id].push_back(sample);
+	}
+	for (std::size_t i = 0; i < channels.size(); i++) finish(i);
+	munmap(mapped, length);
+	return run;
+}
+
+void usage() {
+	std::fprintf(stderr, "usage: stepstats [--moves] [--band percent] <log.tlm>...\n");
+	std::exit(2);
+}
+
+// prints a number or - for one that never happened, iformat is " %<width>..."
+void column(float ivalue, const char *iformat) {
+	if (std::isfinite(ivalue)) std::printf(iformat, ivalue);
+	else std::printf(" %*s", std::atoi(std::strchr(iformat, '%') + 1), "-");
+}
+} // namespace
+
+int main(int argc, char **argv) {
+	bool listMoves = false;
+	std::vector<const char *> paths;
+	for (int i = 1; i < argc; i++) {
+		if (!std::strcmp(argv[i], "--moves")) listMoves = true;
+		else if (!std::strcmp(argv[i], "--band") && i + 1 < argc) band = std::atof(argv[++i]) / 100;
+		else if (argv[i][0] != '-') paths.push_back(argv[i]);
+		else usage();
+	}
+	if (paths.empty() or !(band > 0)) usage();
+
+	// one log at a time per core
+	std::vector<Run> runs(paths.size());
+	std::atomic<std::size_t> next{0};
+	std::vector<std::thread> workers;
+	const unsigned jobs = std::max(1u, std::min<unsigned>(std::thread::hardware_concurrency(), paths.size()));
+	for (unsigned j = 0; j < jobs; j++) {
+		workers.emplace_back([&] {
+			for (std::size_t i; (i = next++) < paths.size();) runs[i] = readRun(paths[i]);
+		});
+	}
+	for (auto &worker : workers) worker.join();
+
+	std::vector<std::string> channels;
+	for (std::size_t i = 0; i < runs.size(); i++) {
+		if (!runs[i].problem.empty()) std::fprintf(stderr, "stepstats: %s %s, skipping it\n", paths[i], runs[i].problem.c_str());
+		for (const auto &moves : runs[i].moves) {
+			if (std::find(channels.begin(), channels.end(), moves.first) == channels.end()) channels.push_back(moves.first);
+		}
+	}
+	std::sort(channels.begin(), channels.end());
+	if (channels.empty()) {
+		std::fprintf(stderr, "stepstats: no moves in there, the robot only logs them with an sd card in or debugLog on\n");
+		return 1;
+	}
+
+	if (listMoves) {
+		for (std::size_t i = 0; i < runs.size(); i++) {
+			for (const auto &moves : runs[i].moves) {
+				std::printf("%s %s\n      start   initial  ms   rise  overshoot  settle   steady  saturated\n", paths[i], moves.first.c_str());
+				for (const Move &move : moves.second) {
+					std::printf("%11.2fs %8.2f %5.0f", move.start / 1000.0, move.initial, move.duration);
+					column(move.rise, " %6.0f");
+					std::printf(" %9.1f%%", move.overshoot);
+					column(move.settle, " %7.0f");
+					std::printf(" %8.2f", move.steady);
+					column(move.saturated, " %9.0f");
+					std::printf("%s\n", std::isfinite(move.saturated) ? "%" : "");
+				}
+			}
+		}
+		std::printf("\n");
+	}
+
+	// each channel's averages, a row per log so runs line up against each other
+	for (const std::string &channel : channels) {
+		std::printf("%s  (settle inside %.0f%%)\n%-32s moves   rise  overshoot  worst  settle  unsettled  |steady|  saturated\n", channel.c_str(), band * 100, "log");
+		for (std::size_t i = 0; i < runs.size(); i++) {
+			const auto found = runs[i].moves.find(channel);
+			if (found == runs[i].moves.end()) continue;
+			const std::vector<Move> &moves = found->second;
+			double rise = 0, overshoot = 0, worst = 0, settle = 0, steady = 0, saturated = 0;
+			int rose = 0, settled = 0, capped = 0;
+			for (const Move &move : moves) {
+				if (std::isfinite(move.rise)) rise += move.rise, rose++;
+				overshoot += move.overshoot;
+				worst = std::max<double>(worst, move.overshoot);
+				if (std::isfinite(move.settle)) settle += move.settle, settled++;
+				steady += std::abs(move.steady);
+				if (std::isfinite(move.saturated)) saturated += move.saturated, capped++;
+			}
+			std::string name = paths[i];
+			if (name.size() > 32) name = "..." + name.substr(name.size() - 29);
+			std::printf("%-32s %5zu", name.c_str(), moves.size());
+			column(rose ? rise / rose : NAN, " %6.0f");
+			std::printf(" %9.1f%% %5.1f%%", overshoot / moves.size(), worst);
+			column(settled ? settle / settled : NAN, " %7.0f");
+			std::printf(" %10d %9.2f", int(moves.size()) - settled, steady / moves.size());
+			column(capped ? saturated / capped : NAN, " %9.0f");
+			std::printf("%s\n", capped ? "%" : "");
+		}
+		std::printf("\n");
+	}
+	return 0;
+}
@@ -0,0 +1,118 @@
+#include "asyncMotion.hpp"
+#include <iostream>
+#include <vector>
+
+namespace {
+// every async move that's been started and hasn't finished, its task and its status. only one move drives at a time,
+// but a cancelled one can still be on its way out of its loop when the next starts, so each task looks up its own
+// rather than whoever started last. a move only starts once it has a slot, so cancelAsyncMotion can always reach it
+struct Running {
+	std::atomic<pros::task_t> task{nullptr};
+	std::shared_ptr<MotionStatus> status;
+};
+std::array<Running, 4> running;
+const pros::task_t starting = &running; // a slot's task while its move hasn't started yet
+
+// taking, freeing and cancelling slots, looking up your own doesn't need it
+pros::Mutex &runningLock() {
+	static pros::Mutex lock;
+	return lock;
+}
+
+struct AsyncStart {
+	std::function<void()> move;
+	Running *slot;
+};
+
+void asyncTrampoline(void *istart) {
+	AsyncStart *start = static_cast<AsyncStart *>(istart);
+	Running *slot = start->slot;
+	slot->task = pros::c::task_get_current();
+	auto status = slot->status;
+	start->move();
+	delete start;
+	// out of the table before it counts as settled, so whoever's waiting to start the next move gets a clean slate
+	runningLock().take(TIMEOUT_MAX);
+	slot->status.reset();
+	slot->task = nullptr;
+	runningLock().give();
+	status->settled = true;
+}
+} // namespace
+
+void MotionStatus::begin(float itotal, bool idriving) {
+	travelled = 0;
+	total = std::abs(itotal);
+	driving = idriving;
+}
+
+MotionStatus &motionStatus() {
+	static MotionStatus unwatched;
+	const pros::task_t self = pros::c::task_get_current();
+	for (auto &entry : running) {
+		if (entry.task == self) return *entry.status;
+	}
+	return unwatched;
+}
+
+AsyncMotion::AsyncMotion(std::function<void()> imove, bool idriving) : status(std::make_shared<MotionStatus>()), driving(idriving) {
+	cancelAsyncMotion();
+	Running *slot = nullptr;
+	runningLock().take(TIMEOUT_MAX);
+	for (auto &entry : running) {
+		if (entry.task == nullptr) {
+			slot = &entry;
+			slot->task = starting;
+			slot->status = status;
+			break;
+		}
+	}
+	runningLock().give();
+	if (!slot) { // every slot's a move that won't finish, starting another we couldn't cancel would be worse
+		std::cout << pros::millis() << ": no room for another async move, not starting it" << std::endl;
+		status->cancelled = true;
+		status->settled = true;
+		return;
+	}
+	pros::c::task_create(asyncTrampoline, new AsyncStart{imove, slot}, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Async Motion");
+}
+
+bool AsyncMotion::isSettled() const {
+	return status->settled;
+}
+
+float AsyncMotion::getProgress() const {
+	if (status->settled) return 1;
+	if (status->driving != driving || status->total <= 0) return 0;
+	return std::min(1.0f, status->travelled / status->total);
+}
+
+void AsyncMotion::waitUntilSettled() const {
+	while (!status->settled) pros::delay(10);
+}
+
+void AsyncMotion::waitUntilProgress(float ifraction) const {
+	while (getProgress() < ifraction) pros::delay(10);
+}
+
+void AsyncMotion::waitUntilDistance(okapi::QLength idistance) const {
+	const float target = idistance.convert(okapi::centimeter);
+	while (!status->settled && !(status->driving && status->travelled >= target)) pros::delay(10);
+}
+
+void AsyncMotion::cancel() const {
+	status->cancelled = true;
+}
+
+void cancelAsyncMotion() {
+	std::vector<std::shared_ptr<MotionStatus>> moves;
+	runningLock().take(TIMEOUT_MAX);
+	for (auto &entry : running) {
+		if (entry.task != nullptr) moves.push_back(entry.status);
+	}
+	runningLock().give();
+	for (auto &move : moves) move->cancelled = true;
+	for (auto &move : moves) {
+		while (!move->settled) pros::delay(10);
+	}
+}
@@ -0,0 +1,62 @@
+#include "contact.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr float gravity = 980.665; // cm/s^2 in a g
+} // namespace
+
+ContactDetector::ContactDetector(const EkfConfig &iodom, const ContactConfig &iconfig) : odom(iodom), config(iconfig) {
+}
+
+void ContactDetector::update(const OdomReading &ireading) {
+	if (!primed) {
+		last = ireading;
+		primed = true;
+		return;
+	}
+	const float dt = (ireading.time - last.time) / 1000.0f;
+	if (dt <= 0) return;
+
+	// the robot's forward speed and spin from the tracking wheels, they don't slip so this is what the ground is doing
+	const float left = (ireading.left - last.left) * odom.cmPerTick / dt;
+	const float right = (ireading.right - last.right) * odom.cmPerTick / dt;
+	const float spin = (left - right) / (odom.rightOffset - odom.leftOffset); // radians/s clockwise
+	const float forward = (left + right) / 2 + spin * (odom.leftOffset + odom.rightOffset) / 2;
+
+	// what each side's drive wheels would be rolling at if they had grip, against what their motors say
+	const bool driveOk = std::isfinite(ireading.driveLeft) and std::isfinite(ireading.driveRight) and std::isfinite(last.driveLeft) and std::isfinite(last.driveRight);
+	const float ground[2] = {forward + spin * odom.driveOffset, forward - spin * odom.driveOffset};
+	const double drive[2] = {ireading.driveLeft - last.driveLeft, ireading.driveRight - last.driveRight};
+	bool slipping[2] = {false, false};
+	for (int side = 0; side < 2; side++) {
+		const bool off = driveOk and std::abs(drive[side] * odom.driveCmPerTick / dt - ground[side]) > config.slipSpeed;
+		if (!off) slipSince[side] = 0;
+		else if (!slipSince[side]) slipSince[side] = ireading.time;
+		slipping[side] = off and ireading.time - slipSince[side] >= (std::uint32_t)config.slipTime;
+	}
+	state.slipLeft = slipping[0];
+	state.slipRight = slipping[1];
+
+	// only losing speed counts from the wheels, a tick of jitter either way is 0.6g at 10ms
+	float impact = std::max(0.0f, std::abs(lastForward) - std::abs(forward)) / dt / gravity;
+	if (std::isfinite(ireading.accelX) and std::isfinite(ireading.accelY)) impact = std::max(impact, (float)std::hypot(ireading.accelX, ireading.accelY));
+	if (impact > config.collisionAccel and !hitting) {
+		state.collisions++;
+		state.collisionTime = ireading.time;
+		state.impact = impact;
+	}
+	hitting = impact > config.collisionAccel;
+
+	const bool still = std::abs(left) < config.stopSpeed and std::abs(right) < config.stopSpeed;
+	if (!still) stoppedSince = 0;
+	else if (!stoppedSince) stoppedSince = ireading.time;
+	state.stopped = still and ireading.time - stoppedSince >= (std::uint32_t)config.stopTime;
+
+	lastForward = forward;
+	last = ireading;
+}
+
+ContactState ContactDetector::getState() const {
+	return state;
+}
@@ -0,0 +1,92 @@
+#include "cubeSensor.hpp"
+
+CubeSensor::CubeSensor(pros::ADIAnalogIn &iline, std::int32_t ithreshold, std::int32_t ihysteresis)
+	: line(iline), threshold(ithreshold), hysteresis(ihysteresis) {
+}
+
+void CubeSensor::start(std::uint32_t iperiod) {
+	if (started) return;
+	period = iperiod;
+	// fill the median up so it doesn't start out on its zeros and call it covered
+	const double reading = line.get_value_calibrated_HR();
+	for (int i = 0; i < 3; i++) filter.filter(reading);
+	value = reading;
+	covered = reading < threshold;
+	edgeTime = pros::millis();
+	started = true;
+	pros::c::task_create(loop, this, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "CubeSensor");
+}
+
+void CubeSensor::loop(void *isensor) {
+	CubeSensor *sensor = static_cast<CubeSensor *>(isensor);
+	std::uint32_t wake = pros::millis();
+	while (true) {
+		sensor->step();
+		pros::Task::delay_until(&wake, sensor->period);
+	}
+}
+
+void CubeSensor::step() {
+	const double filtered = filter.filter(line.get_value_calibrated_HR());
+	value = filtered;
+
+	bool now = covered;
+	if (now and filtered > threshold + hysteresis / 2) now = false;
+	else if (!now and filtered < threshold - hysteresis / 2) now = true;
+	if (now == covered) return;
+
+	covered = now;
+	edgeTime = pros::millis();
+	for (auto &waiter : waiters) {
+		const pros::task_t task = waiter;
+		if (task) pros::c::task_notify(task);
+	}
+}
+
+bool CubeSensor::isCovered() const {
+	return covered;
+}
+
+double CubeSensor::getValue() const {
+	return value;
+}
+
+std::uint32_t CubeSensor::getEdgeTime() const {
+	return edgeTime;
+}
+
+bool CubeSensor::waitUntilCovered(std::uint32_t itimeout) {
+	return waitUntil(true, itimeout);
+}
+
+bool CubeSensor::waitUntilUncovered(std::uint32_t itimeout) {
+	return waitUntil(false, itimeout);
+}
+
+bool CubeSensor::waitUntil(bool icovered, std::uint32_t itimeout) {
+	const std::uint32_t start = pros::millis();
+	const pros::task_t self = pros::c::task_get_current();
+
+	// sign up before looking, so an edge between the look and the wait still leaves a notification to wake us
+	std::atomic<pros::task_t> *slot = nullptr;
+	for (auto &waiter : waiters) {
+		pros::task_t empty = nullptr;
+		if (waiter.compare_exchange_strong(empty, self)) {
+			slot = &waiter;
+			break;
+		}
+	}
+
+	bool reached = covered == icovered;
+	while (!reached) {
+		const std::uint32_t waited = pros::millis() - start;
+		if (waited >= itimeout) break;
+		// every slot's taken, nothing will wake us so fall back to checking every sample
+		if (slot) pros::c::task_notify_take(true, itimeout - waited);
+		else pros::delay(period);
+		reached = covered == icovered;
+	}
+
+	if (slot) *slot = nullptr;
+	return reached;
+}
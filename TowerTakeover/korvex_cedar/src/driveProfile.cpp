@@ -0,0 +1,54 @@
+#include "driveProfile.hpp"
+#include <algorithm>
+
+TrapezoidProfile::TrapezoidProfile(float idistance, float imaxVelocity, float imaxAccel, float imaxJerk)
+	: sign(idistance < 0 ? -1 : 1), distance(std::abs(idistance)), velocity(std::abs(imaxVelocity)), accel(std::abs(imaxAccel)) {
+	// an s-curve ramps the acceleration over jerkTime, which costs the same as starting the plain trapezoid
+	// jerkTime / 2 late, so the trapezoid is planned as usual and the ramp is spread over its corners
+	jerkTime = imaxJerk > 0 ? accel / imaxJerk : 0;
+	if (distance <= 0 || velocity <= 0 || accel <= 0) {
+		velocity = accelTime = cruiseTime = jerkTime = 0;
+		return;
+	}
+	// too short to reach full speed, peak where speeding up meets slowing down
+	if (velocity * velocity / accel > distance) velocity = std::sqrt(distance * accel);
+	jerkTime = std::min(jerkTime, velocity / accel);
+	accelTime = velocity / accel;
+	cruiseTime = distance / velocity - accelTime;
+}
+
+float TrapezoidProfile::duration() const {
+	return 2 * accelTime + cruiseTime + jerkTime;
+}
+
+TrapezoidProfile::State TrapezoidProfile::sample(float it) const {
+	if (distance <= 0 || velocity <= 0) return {0, 0, 0};
+	const float t = std::max(0.0f, std::min(it, duration()));
+
+	// the plain trapezoid at time s
+	const float decelStart = accelTime + cruiseTime;
+	auto accelAt = [&](float s) { return s < 0 ? 0 : s < accelTime ? accel : s < decelStart ? 0 : s < decelStart + accelTime ? -accel : 0; };
+	auto velocityAt = [&](float s) {
+		s = std::max(0.0f, std::min(s, duration()));
+		if (s < accelTime) return accel * s;
+		if (s < decelStart) return velocity;
+		return std::max(0.0f, velocity - accel * (s - decelStart));
+	};
+	auto positionAt = [&](float s) {
+		s = std::max(0.0f, std::min(s, 2 * accelTime + cruiseTime));
+		if (s < accelTime) return accel * s * s / 2;
+		if (s < decelStart) return velocity * accelTime / 2 + velocity * (s - accelTime);
+		const float d = s - decelStart;
+		return velocity * accelTime / 2 + velocity * cruiseTime + velocity * d - accel * d * d / 2;
+	};
+
+	if (jerkTime <= 0) return {sign * positionAt(t), sign * velocityAt(t), sign * accelAt(t)};
+
+	// s-curve: everything is the trapezoid's averaged over the last jerkTime, which turns each step in acceleration
+	// into a ramp. acceleration and velocity come out exact, position is simpson's rule and within a hair
+	const float h = jerkTime;
+	const float a = (velocityAt(t) - velocityAt(t - h)) / h;
+	const float v = (positionAt(t) - positionAt(t - h)) / h;
+	const float x = (positionAt(t - h) + 4 * positionAt(t - h / 2) + positionAt(t)) / 6;
+	return {sign * x, sign * v, sign * a};
+}
@@ -1,6 +1,16 @@
 #include <fstream>
 #include "main.h"
 #include "korvexlib.h"
+#include "loopTimer.hpp"
+#include "motorCache.hpp"
+#include "asyncMotion.hpp"
+#include "cubeSensor.hpp"
+#include "driveProfile.hpp"
+#include "purePursuit.hpp"
+#include "sensorSnapshot.hpp"
+#include "settle.hpp"
+#include "telemetry.hpp"
+#include "trackingOdometry.hpp"
 
 // chassis
 auto chassis = ChassisControllerBuilder() // two tracking wheels
@@ -41,12 +51,20 @@ ControllerButton cubeReturn(ControllerDigital::B);
 // sensors
 pros::Imu imu(IMU_PORT);
 pros::ADIAnalogIn line(LINE_PORT); // line sensor on tray, for cube detection
+CubeSensor cube(line); // the line sensor's task, wait on cubes with this instead of reading line
 pros::ADIEncoder trackingLeft(1, 2);
 pros::ADIEncoder trackingRight(5, 6);
 pros::ADIEncoder trackingStrafe(3, 4, true);
 
 // base global defenitions
 const int LIFT_STACKING_HEIGHT = 700; // the motor ticks above which we are stacking
+bool logMoves = false; // every motion function's loop into telemetry like debugLog, initialize turns it on with an sd card in
+const float TRACKING_CM_PER_TICK = 2.75 * 2.54 * M_PI / 360; // 2.75in tracking wheels, 360 ticks a turn
+// left and right 2.3in either side of the middle like withOdometry's 4.6in track, strafe 3in behind
+// the drive's 4in wheels 8.125in apart, okapi has their encoders in counts. EkfNoise's defaults are tuned for cedar
+TrackingOdometry odometry(trackingLeft, trackingRight, trackingStrafe, imu, LEFT_MTR1, -RIGHT_MTR1,
+	{TRACKING_CM_PER_TICK, -2.3 * 2.54, 2.3 * 2.54, -3 * 2.54, 4 * 2.54 * M_PI / imev5GreenTPR, 8.125 / 2 * 2.54, EkfNoise()});
+SensorSampler sensors(liftMotor, trayMotor, intakeMotors, masterController); // opcontrol reads these once a loop
 enum class autonStates { // the possible auton selections
 	off,
 	redProtec,
@@ -55,7 +73,8 @@ enum class autonStates { // the possible auton selections
 	blueProtec,
 	blueUnprotec,
 	blueRick,
-	skills
+	skills,
+	characterize
 };
 autonStates autonSelection = autonStates::off; // the current auton selection
 
@@ -78,99 +97,108 @@ cubeStates cubeState = cubeStates::covered;
 // odom debug global
 bool odomDebug = false;
 
+// pid constants for the motion functions, globals so the sim's pidtune can try others
+struct pidGains {
+	float kp;
+	float ki;
+	float kd;
+};
+pidGains driveGains = {0.1523, 0.05337, 0.2989}; // driveQ straights
+pidGains turnGains = {3.069, 0.4337, 1.464}; // turnP
+Feedforward driveFeedforward = {0.991, 0.112, 0.00722}; // driveP, sim/bin/drivefit on the characterize auton (these are the sim's)
+
 // create a button descriptor string array
 static const char *btnmMap[] = {"Unprotec", "Protec", "Rick", ""};
 
 void driveP(int targetLeft, int targetRight, int voltageMax=115, bool debugLog=false) {
 
-	// the touchables ;)))))))) touch me uwu :):):)
-	float kp = 0.15;
-	float acc = 5;
-	float kpTurn = 0.7;
-	float accTurn = 4;
+	// the touchables ;)))))))) touch me uwu :):):) (kS/kV/kA in driveFeedforward up top)
+	float kp = 0.4; // volts per cm behind the profile
+	float kd = 0.01; // volts per cm/s behind the profile
+	float maxAccel = 150; // cm/s^2
+	float maxJerk = 1500; // cm/s^3, rounds off the profile's corners
+	float topSpeed = 106; // cm/s, 200rpm on 4in wheels
 
 	// the untouchables
-	float voltageLeft = 0;
-	float voltageRight = 0;
+	float tickCm = TRACKING_CM_PER_TICK;
+	int startLeft = chassis->getModel()->getSensorVals()[0];
+	int startRight = chassis->getModel()->getSensorVals()[1];
+	float distanceLeft = targetLeft * tickCm;
+	float distanceRight = targetRight * tickCm;
+	float ratioLeft; // each side's share of the profile, the longer side drives it and the other scales it down
+	float ratioRight;
+	float positionLeft = 0; // cm
+	float positionRight = 0;
+	float positionLastLeft;
+	float positionLastRight;
+	float velocityLeft; // cm/s
+	float velocityRight;
+	float voltageLeft;
+	float voltageRight;
+	float t; // s into the profile
 	int errorLeft;
 	int errorRight;
-	int voltageCap = 0;
-	int signLeft;
-	int signRight;
-	int errorCurrent = 0;
-	int errorLast = 0;
-	int sameErrCycles = 0;
-	int same0ErrCycles = 0;
+	float errorCurrent = 0; // cm
 	int startTime = pros::millis();
-	targetLeft = targetLeft + chassis->getModel()->getSensorVals()[0];
-	targetRight = targetRight + chassis->getModel()->getSensorVals()[1];
+	targetLeft = targetLeft + startLeft;
+	targetRight = targetRight + startRight;
+	float longest = std::max(std::abs(distanceLeft), std::abs(distanceRight));
+	ratioLeft = longest > 0 ? distanceLeft / longest : 0;
+	ratioRight = longest > 0 ? distanceRight / longest : 0;
+	TrapezoidProfile profile(longest, topSpeed * voltageMax / 127, maxAccel, maxJerk);
+	MotionStatus &status = motionStatus();
+	status.begin(longest, true);
+	SettleDetector settle({1, 3, 50, 400, 1, 4, int(profile.duration() * 1000) + 1000}); // cm, cm/s, ms, ms, cm/s, cm, ms
+
+	LoopTimer timer(10, "driveP"); // runs the loop every 10ms on the dot
 
 	while(autonomous){
+		t = (pros::millis() - startTime) / 1000.0;
+		TrapezoidProfile::State plan = profile.sample(t);
+
+		positionLastLeft = positionLeft;
+		positionLastRight = positionRight;
+		positionLeft = (chassis->getModel()->getSensorVals()[0] - startLeft) * tickCm;
+		positionRight = (chassis->getModel()->getSensorVals()[1] - startRight) * tickCm;
+		velocityLeft = (positionLeft - positionLastLeft) / timer.dt();
+		velocityRight = (positionRight - positionLastRight) / timer.dt();
 		errorLeft = targetLeft - chassis->getModel()->getSensorVals()[0]; // error is target minus actual value
 		errorRight = targetRight - chassis->getModel()->getSensorVals()[1];
-		errorCurrent = (abs(errorRight) + abs(errorLeft)) / 2;
+		errorCurrent = (abs(errorRight) + abs(errorLeft)) / 2.0 * tickCm;
+		status.travelled = plan.position;
 
-		signLeft = errorLeft / abs(errorLeft); // + or - 1
-		signRight = errorRight / abs(errorRight);
+		// follow the plan, feedforward for where it's going and pd for where we've ended up
+		voltageLeft = driveFeedforward.calculate(plan.velocity * ratioLeft, plan.acceleration * ratioLeft)
+			+ (plan.position * ratioLeft - positionLeft) * kp + (plan.velocity * ratioLeft - velocityLeft) * kd;
+		voltageRight = driveFeedforward.calculate(plan.velocity * ratioRight, plan.acceleration * ratioRight)
+			+ (plan.position * ratioRight - positionRight) * kp + (plan.velocity * ratioRight - velocityRight) * kd;
 
-		if(signLeft == signRight){
-			voltageLeft = errorLeft * kp; // intended voltage is error times constant
-			voltageRight = errorRight * kp;
-			voltageCap = voltageCap + acc;  // slew rate
-		}
-		else{
-			voltageLeft = errorLeft * kpTurn; // same logic with different turn value
-			voltageRight = errorRight * kpTurn;
-			voltageCap = voltageCap + accTurn;  // turn slew rate
-		}
-		
-		if(voltageCap > voltageMax) voltageCap = voltageMax; // voltageCap cannot exceed 115
-
-		if(abs(voltageLeft) > voltageCap) voltageLeft = voltageCap * signLeft; // limit the voltage
-		if(abs(voltageRight) > voltageCap) voltageRight = voltageCap * signRight;// ditto
-
-		// set the motors to the intended speed
-		chassis->getModel()->tank(voltageLeft/127, voltageRight/127); // dont feel like retuning soo we divide by 127
-
-		// timeout utility
-		if (errorLast == errorCurrent) {
-			if (errorCurrent <= 2) same0ErrCycles +=1; // less than 2 ticks is "0" error
-			sameErrCycles += 1;
-		}
-		else {
-			sameErrCycles = 0;
-			same0ErrCycles = 0;
-		}
+		// set the motors to the intended voltage
+		chassis->getModel()->tank(voltageLeft / 12, voltageRight / 12);
 
 		// exit paramaters
-		if ((errorLast < 5 and errorCurrent < 5) or sameErrCycles >= 20) { // allowing for smol error or exit if we stay the same err for .4 second
+		if (settle.update(errorCurrent, std::max(std::abs(velocityLeft), std::abs(velocityRight)), status.cancelled, std::max(std::abs(voltageLeft), std::abs(voltageRight)) >= 12)) {
 			chassis->stop();
-			std::cout << pros::millis() << "task complete with error " << errorCurrent << " in " << (pros::millis() - startTime) << "ms" << std::endl;
+			std::cout << pros::millis() << "task complete with error " << errorCurrent << "cm, in " << (pros::millis() - startTime) << "ms, " << settle.reasonName() << std::endl;
+			timer.report();
 			return;
 		}
-		
+
 		// debug
-		if (debugLog) {
-			std::cout << pros::millis() << "error  " << errorCurrent << std::endl;
-			std::cout << pros::millis() << "errorLeft  " << errorLeft << std::endl;
-			std::cout << pros::millis() << "errorRight  " << errorRight << std::endl;
-			std::cout << pros::millis() << "voltageLeft  " << voltageLeft << std::endl;
-			std::cout << pros::millis() << "voltageRight  " << voltageRight << std::endl;
-		}
+		if (debugLog or logMoves) telemetry().log(Telemetry::driveP, {plan.position, plan.velocity, positionLeft, velocityLeft, positionRight, velocityRight, voltageLeft, voltageRight});
 
 		// nothing goes after this
-		errorLast = errorCurrent;
-		pros::delay(20);
+		timer.wait();
 	}
 }
 
 void driveQ(QLength targetX, QLength targetY, bool backwards=false, float voltageMax=115, bool forceFlip=false, bool debugLog=false) {
 
 	// tune for straights
-	float kp = 0.058;
-	float ki = 0.0;
-	float kd = 0.5;
-	// fk yeah lets just keep tuning 30 mins before a match lmao
+	float kp = driveGains.kp;
+	float ki = driveGains.ki;
+	float kd = driveGains.kd;
+	// fk yeah lets just keep tuning 30 mins before a match lmao (or run sim/bin/pidtune)
 
 	// tune for turns
 	float kpTurn = 0.0;
@@ -179,55 +207,72 @@ void driveQ(QLength targetX, QLength targetY, bool backwards=false, float voltag
 
 	// the untouchables
 	float error; // distance to target
-	float errorLast = 0; // error in the last loop
+	float along; // distance left along the line from where we started, see below
+	float alongLast = 0; // along in the last loop
 	float errorTheta; // targetTheta - robotTheta
 	float errorLastTheta = 0; // errorTheta in the last loop
 	float p; // proportional straight
-	float i; // integral straight
+	float i = 0; // integral straight
 	float d; // derivative straight
 	float pTurn; // proportional turn
-	float iTurn; // integral turn
+	float iTurn = 0; // integral turn
 	float dTurn; // derivative turn
 	float voltageLeft;
 	float voltageRight;
 	float voltage; // calculated straight voltage
-	float xDif = targetX.convert(centimeter) - chassis->getState().x.convert(centimeter); // target.x - robot.x
-	float yDif = targetY.convert(centimeter) - chassis->getState().y.convert(centimeter); // target.y - robot.y
-	float xOrig = chassis->getState().x.convert(centimeter); // original x coord
-	float yOrig = chassis->getState().y.convert(centimeter); // original y coord
+	OdomPose pose = odometry.getPose(); // where we are, once a loop so x and y always match
+	float xDif = targetX.convert(centimeter) - pose.x; // target.x - robot.x
+	float yDif = targetY.convert(centimeter) - pose.y; // target.y - robot.y
+	float xOrig = pose.x; // original x coord
+	float yOrig = pose.y; // original y coord
 	float targetTheta = std::atan2(yDif,xDif)*180 / M_PI; // angle from origin to target
 	float distanceTotal = std::sqrt(std::pow((targetX.convert(centimeter) - xOrig), 2) + std::pow((targetY.convert(centimeter) - yOrig), 2)); // total distance we need to travel
 	float distanceOrig; // distance from original position
-	int sameErrCycles = 0; // number of cycles we have stayed the same error
-	int same0ErrCycles = 0; // number of cycles we have stayed at 0 error
+	float velocity; // cm/s forward, turning on the spot to fix the heading doesn't count
+	int sensorLeft = chassis->getModel()->getSensorVals()[0];
+	int sensorRight = chassis->getModel()->getSensorVals()[1];
 	int startTime = pros::millis();
 
 	if (backwards) targetTheta = std::atan(yDif/xDif)*180 / M_PI;
 	if (forceFlip) targetTheta = -targetTheta; // i know its dumb
 	voltageMax = voltageMax/127; // normalize the voltageMax
+	MotionStatus &status = motionStatus();
+	status.begin(distanceTotal, true);
+	// twice as long as the feedforward says it takes at voltageMax, and a second to get going and settle
+	const float cruise = std::max(10.0f, (voltageMax * 12 - driveFeedforward.kS) / driveFeedforward.kV); // cm/s
+	SettleDetector settle({3, 5, 60, 300, 2.5, 8, int(2000 * distanceTotal / cruise) + 1000}); // cm, cm/s, ms, ms, cm/s, cm, ms
+
+	LoopTimer timer(20, "driveQ"); // runs the loop every 20ms on the dot
 
 	while(autonomous) {
 
 		// get difference in x and y, robot distance from target
-		xDif = targetX.convert(centimeter) - chassis->getState().x.convert(centimeter);
-		yDif = targetY.convert(centimeter) - chassis->getState().y.convert(centimeter);
+		pose = odometry.getPose();
+		xDif = targetX.convert(centimeter) - pose.x;
+		yDif = targetY.convert(centimeter) - pose.y;
 
 		// get difference in x and y, robot distance from move start, to detect overshoot
-		distanceOrig = std::sqrt(std::pow((chassis->getState().x.convert(centimeter) - xOrig), 2) + std::pow((chassis->getState().y.convert(centimeter) - yOrig), 2));
+		distanceOrig = std::sqrt(std::pow((pose.x - xOrig), 2) + std::pow((pose.y - yOrig), 2));
+		status.travelled = distanceOrig;
 
 		// get distance to target, ie error
 		error = std::sqrt(std::pow(xDif, 2) + std::pow(yDif, 2));
-
-		p = (error * kp);
-		if (abs(error) <= 5) i = ((i + error) * ki); // if we are in range for I to be desireable
+		// the pid drives off how much further along the line there is to go, negative once we're past the point. a miss off
+		// to the side can't be driven out, flipping on the full distance just rocks back and forth across the point
+		along = distanceTotal - distanceOrig;
+		velocity = (chassis->getModel()->getSensorVals()[0] - sensorLeft + chassis->getModel()->getSensorVals()[1] - sensorRight) / 2.0 * TRACKING_CM_PER_TICK / timer.dt();
+		sensorLeft = chassis->getModel()->getSensorVals()[0];
+		sensorRight = chassis->getModel()->getSensorVals()[1];
+
+		p = (along * kp);
+		if (abs(along) <= 5) i = ((i + along * timer.ticks()) * ki); // if we are in range for I to be desireable
 		else i = 0;
-		d = (error - errorLast) * kd;
+		d = (along - alongLast) / timer.ticks() * kd;
 		
 		// set voltage
 		voltage = p + i + d;
 
-		if (voltage > voltageMax) {voltage = voltageMax;}
-		if (distanceOrig > distanceTotal) {voltage = -voltage;} // if we have passed our point
+		if (std::abs(voltage) > voltageMax) {voltage = std::copysign(voltageMax, voltage);}
 		if (backwards) {voltage = -voltage;} // if we are driving backwards
 
 		voltageLeft = voltage;
@@ -238,8 +283,8 @@ void driveQ(QLength targetX, QLength targetY, bool backwards=false, float voltag
 
 		// calculate voltage change for left/right
 		pTurn = (error * kpTurn);
-		iTurn = ((iTurn + errorTheta) * kiTurn); // if we are in range for I to be desireable
-		dTurn = (errorTheta - errorLastTheta) * kdTurn;
+		iTurn = ((iTurn + errorTheta * timer.ticks()) * kiTurn); // if we are in range for I to be desireable
+		dTurn = (errorTheta - errorLastTheta) / timer.ticks() * kdTurn;
 
 		voltageLeft = voltageLeft + (pTurn + iTurn + dTurn);
 		voltageRight = voltageRight + -(pTurn + iTurn + dTurn);
@@ -248,102 +293,77 @@ void driveQ(QLength targetX, QLength targetY, bool backwards=false, float voltag
 		// set the motors to the intended speed
 		chassis->getModel()->tank(voltageLeft, voltageRight);
 
-		// timeout utility
-		if (std::round(errorLast) == std::round(error)) {
-			if (abs(error) <= 3) same0ErrCycles +=1; // less than 3 cm is "0" error
-			sameErrCycles += 1;
-		}
-		else {
-			sameErrCycles = 0;
-			same0ErrCycles = 0;
-		}
-
 		// exit paramaters
-		if ((same0ErrCycles > 15) or sameErrCycles >= 20) { // exit if we stay the same 0err for .3 sec or same err for .4 second
+		if (settle.update(error, velocity, status.cancelled, std::abs(voltage) >= voltageMax)) {
 			chassis->stop();
-			std::cout << pros::millis() << "task complete with error " << error << "cm, in " << (pros::millis() - startTime) << "ms" << std::endl;
+			std::cout << pros::millis() << "task complete with error " << error << "cm, in " << (pros::millis() - startTime) << "ms, " << settle.reasonName() << std::endl;
+			timer.report();
 			return;
 		}
 
 		// debug
-		if (debugLog) {
-			std::cout << pros::millis() << ": error  " << error << std::endl;
-			std::cout << pros::millis() << ": errorTheta  " << errorTheta << std::endl;
-			std::cout << pros::millis() << ": targetTheta  " << targetTheta << std::endl;
-			std::cout << pros::millis() << ": voltageLeft " << voltageLeft << std::endl;
-			std::cout << pros::millis() << ": voltageRight  " << voltageRight << std::endl;
-			// std::cout << pros::millis() << ": xDif  " << xDif << std::endl;
-			// std::cout << pros::millis() << ": yDif  " << yDif << std::endl;
-			// std::cout << pros::millis() << ": dist from orig  " << distanceOrig << std::endl;
-		}
+		if (debugLog or logMoves) telemetry().log(Telemetry::driveQ, {distanceOrig > distanceTotal ? -error : error, errorTheta, targetTheta, voltageLeft, voltageRight, voltageMax, float(startTime)});
 
 		// nothing goes after this
-		errorLast = error;
+		alongLast = along;
 		errorLastTheta = errorTheta;
-		pros::delay(20);
+		timer.wait();
 	}
 }
 
 void turnP(int targetTurn, int voltageMax=127, bool debugLog=false) {
  
-	// the touchables ;)))))))) touch me uwu :):):)
-	float kp = 1.6;
-	float ki = 0.8;
-	float kd = 0.45;
+	// the touchables ;)))))))) touch me uwu :):):) (in turnGains up top)
+	float kp = turnGains.kp;
+	float ki = turnGains.ki;
+	float kd = turnGains.kd;
+	float voltageMin = 55; // out of 127, what it takes to get the chassis turning at all, only used outside the settle band
 
 	// the untouchables
 	int voltageCap = 0;
 	float voltage = 0;
 	float errorCurrent;
-	float errorLast;
-	int errorCurrentInt;
-	int errorLastInt;
-	int sameErrCycles = 0;
-	int same0ErrCycles = 0;
+	float errorLast = 0;
 	int p;
-	float i;
+	float i = 0;
 	int d;
 	int sign;
 	float error;
 	int startTime = pros::millis();
 
+	MotionStatus &status = motionStatus();
+	status.begin(targetTurn - imu.get_rotation(), false);
+	SettleDetector settle({2, 10, 40, 400, 3, 5, 1000 + 20 * int(std::abs(status.total))}); // deg, deg/s, ms, ms, deg/s, deg, ms
+
+	LoopTimer timer(10, "turnP"); // runs the loop every 10ms on the dot
+
 	while(autonomous) {
 		error = targetTurn - imu.get_rotation();
 		errorCurrent = abs(error);
-		errorCurrentInt = errorCurrent;
-		sign = targetTurn / abs(targetTurn); // -1 or 1
+		status.travelled = status.total - errorCurrent;
+		sign = error < 0 ? -1 : 1; // which way we still have to go, not which way the turn started
 
 		p = (error * kp);
 		if (abs(error) < 10) { // if we are in range for I to be desireable
-			i = ((i + error) * ki);
+			i = ((i + error * timer.ticks()) * ki);
 		}
 		else
 			i = 0;
-		d = (error - errorLast) * kd;
+		d = (error - errorLast) / timer.ticks() * kd;
 		
 		voltage = p + i + d;
 
 		if(abs(voltage) > voltageMax) voltage = voltageMax * sign;
+		if(errorCurrent > 2 and abs(voltage) < voltageMin) voltage = voltageMin * sign; // p and the leaky i are too soft to beat scrub a few deg out
 
 		// set the motors to the intended speed
 		chassis->getModel()->tank(voltage/127, -voltage/127);
 
-		// timeout utility
-		if (errorLastInt == errorCurrentInt) {
-			if (errorLast <= 2 and errorCurrent <= 2) { // saying that error less than 2 counts as 0
-				same0ErrCycles +=1;
-			}
-			sameErrCycles += 1;
-		}
-		else {
-			sameErrCycles = 0;
-			same0ErrCycles = 0;
-		}
-
 		// exit paramaters
-		if (same0ErrCycles >= 5 or sameErrCycles >= 60) { // allowing for smol error or exit if we stay the same err for .6 second
+		if (settle.update(errorCurrent, imu.get_gyro_rate().z, status.cancelled, std::abs(voltage) >= voltageMax)) {
 			chassis->stop();
-			std::cout << pros::millis() << "task complete with error " << errorCurrent << " in " << (pros::millis() - startTime) << "ms" << std::endl;
+			std::cout << pros::millis() << "task complete with error " << errorCurrent << "deg, in " << (pros::millis() - startTime) << "ms, " << settle.reasonName() << std::endl;
+			timer.report();
 			return;
 		}
 		
@@ -351,13 +371,12 @@ void turnP(int targetTurn, int voltageMax=127, bool debugLog=false) {
 		// std::cout << pros::millis() << "error " << errorCurrent << std::endl;
 		// std::cout << pros::millis() << "voltage " << voltage << std::endl;
 
-		// for csv output, graphing the function
-		if (debugLog) std::cout << pros::millis() << "," << error << "," << voltage << std::endl;
+		// for graphing the function
+		if (debugLog or logMoves) telemetry().log(Telemetry::turnP, {error, voltage, float(voltageMax), float(startTime)});
 
 		// nothing goes after this
-		errorLast = errorCurrent;
-		errorLastInt = errorLast;
-		pros::delay(10);
+		errorLast = error; // signed, d off abs(error) kicks the wrong way once we're past the target
+		timer.wait();
 	}
 }
 
@@ -367,53 +386,51 @@ void turnQ(QLength targetX, QLength targetY, bool backwards=false, bool forceFli
 	float ki = 0.0;
 	float kd = 0.5;
 	// who needs an I? i retuned during drivers meeting lmao
+	float voltageMin = 0.43; // same floor as turnP's 55 of 127, p alone stops turning ~4deg out and driveQ then misses wide
 
 	// the untouchables
 	float errorTheta; // targetTheta - robotTheta
 	float errorLastTheta = 0; // errorTheta in the last loop
 	float p; // proportional
-	float i; // integral
+	float i = 0; // integral
 	float d; // derivative
 	float voltage; // calculated voltage
-	float xDif = targetX.convert(centimeter) - chassis->getState().x.convert(centimeter); // target.x - robot.x
-	float yDif = targetY.convert(centimeter) - chassis->getState().y.convert(centimeter); // target.y - robot.y
+	OdomPose pose = odometry.getPose();
+	float xDif = targetX.convert(centimeter) - pose.x; // target.x - robot.x
+	float yDif = targetY.convert(centimeter) - pose.y; // target.y - robot.y
 	float targetTheta = std::atan2(yDif,xDif)*180 / M_PI; // angle from robot to target, our goal angle
-	int sameErrCycles = 0; // number of cycles we have stayed the same error
-	int same0ErrCycles = 0; // number of cycles we have stayed at 0 error
 	int startTime = pros::millis();
 
 	if (backwards) targetTheta = std::atan(yDif/xDif)*180 / M_PI;
 	if (forceFlip) targetTheta = -targetTheta;
+	MotionStatus &status = motionStatus();
+	status.begin(targetTheta - imu.get_rotation(), false);
+	SettleDetector settle({2, 10, 40, 300, 3, 8, 1000 + 20 * int(std::abs(status.total))}); // deg, deg/s, ms, ms, deg/s, deg, ms
+
+	LoopTimer timer(20, "turnQ"); // runs the loop every 20ms on the dot
 
 	while(autonomous) {
 
 		// get difference in x and y, robot distance from target
 		errorTheta = targetTheta - imu.get_rotation();
+		status.travelled = status.total - std::abs(errorTheta);
 
 		p = (errorTheta * kp);
-		if (abs(errorTheta) < 10) i = ((i + errorTheta) * ki); // if we are in range for I to be desireable
+		if (abs(errorTheta) < 10) i = ((i + errorTheta * timer.ticks()) * ki); // if we are in range for I to be desireable
 		else i = 0;
-		d = (errorTheta - errorLastTheta) * kd;
+		d = (errorTheta - errorLastTheta) / timer.ticks() * kd;
 		
 		voltage = p + i + d;
+		if (std::abs(errorTheta) > 2 and std::abs(voltage) < voltageMin) voltage = std::copysign(voltageMin, errorTheta);
 
 		// set the motors to the intended speed
 		chassis->getModel()->tank(voltage, -voltage);
 
-		// timeout utility
-		if (std::round(errorLastTheta) == std::round(errorTheta)) {
-			if (abs(errorTheta) <= 4) same0ErrCycles +=1; // less than 4 deg is "0" error
-			sameErrCycles += 1;
-		}
-		else {
-			sameErrCycles = 0;
-			same0ErrCycles = 0;
-		}
-
 		// exit paramaters
-		if ((same0ErrCycles > 5) or sameErrCycles >= 15) { // exit if we stay the same 0err for .1 sec or same err for .3 second
+		if (settle.update(errorTheta, imu.get_gyro_rate().z, status.cancelled, std::abs(voltage) >= 1)) {
 			chassis->stop();
-			std::cout << pros::millis() << "task complete with error " << errorTheta << "deg, in " << (pros::millis() - startTime) << "ms" << std::endl;
+			std::cout << pros::millis() << "task complete with error " << errorTheta << "deg, in " << (pros::millis() - startTime) << "ms, " << settle.reasonName() << std::endl;
+			timer.report();
 			return;
 		}
 
@@ -426,26 +443,368 @@ void turnQ(QLength targetX, QLength targetY, bool backwards=false, bool forceFli
 
 		// nothing goes after this
 		errorLastTheta = errorTheta;
-		pros::delay(20);
+		timer.wait();
 	}
 }
 
 void driveTo(QLength targetX, QLength targetY, bool backwards=false, int voltageMax=115, bool forceFlip=false, bool debugLog=false) {
 	float targetTheta;
-	if (backwards or forceFlip) targetTheta = std::atan((targetY.convert(centimeter) - chassis->getState().y.convert(centimeter))/(targetX.convert(centimeter) - chassis->getState().x.convert(centimeter)))*180 / M_PI;
-	else targetTheta = std::atan2((targetY.convert(centimeter) - chassis->getState().y.convert(centimeter)), (targetX.convert(centimeter) - chassis->getState().x.convert(centimeter)))*180 / M_PI;
+	OdomPose pose = odometry.getPose();
+	if (backwards or forceFlip) targetTheta = std::atan((targetY.convert(centimeter) - pose.y)/(targetX.convert(centimeter) - pose.x))*180 / M_PI;
+	else targetTheta = std::atan2((targetY.convert(centimeter) - pose.y), (targetX.convert(centimeter) - pose.x))*180 / M_PI;
 	if (abs(targetTheta - imu.get_rotation()) > 20) {turnQ(targetX, targetY, backwards, forceFlip, debugLog);} // only turn if the degree error is greater than 20 deg
+	if (motionStatus().cancelled) return;
 	driveQ(targetX, targetY, backwards, voltageMax, forceFlip, debugLog);
 }
 
-void traySlew(bool forward) {
+// drives through the waypoints one after another, carrying speed through each one instead of stopping like a driveTo per point would
+// only slows down for the last point and for points where the path bends more than sharpTurn degrees, those get a full driveQ
+// ie driveChain({{20_in, 0_in}, {40_in, 10_in}, {60_in, 10_in}}, false, 90);
+// an OdomState goes in as {state.x, state.y}, the chain points itself along the path so there's no theta to hit
+void driveChain(const std::vector<Point> &waypoints, bool backwards=false, int voltageMax=115, float sharpTurn=45, bool debugLog=false) {
+
+	// the touchables
+	float kpTurn = 0.02; // steering per deg of heading error while we keep going
+	float acc = 0.04; // slew from a standstill, same as driveP's 5 a loop out of 127
+	float passRadius = 10; // cm, this close to a waypoint counts as passing it
+
+	// the untouchables
+	float voltage = 0; // straight voltage, carried from one waypoint to the next
+	float voltageTurn;
+	float xDif;
+	float yDif;
+	float error; // distance to the waypoint
+	float along; // how far the waypoint is still ahead along the leg, negative once we've gone past it
+	float targetTheta;
+	float errorTheta;
+	MotionStatus &status = motionStatus();
+	int startTime = pros::millis();
+
+	for (size_t n = 0; n < waypoints.size(); n++) {
+		QLength targetX = waypoints[n].x;
+		QLength targetY = waypoints[n].y;
+		OdomPose pose = odometry.getPose();
+		float xLeg = targetX.convert(centimeter) - pose.x;
+		float yLeg = targetY.convert(centimeter) - pose.y;
+		float legLength = std::sqrt(std::pow(xLeg, 2) + std::pow(yLeg, 2));
+
+		// how hard the path bends at this waypoint, going by the waypoints so missing one a bit doesn't change the answer
+		// the last one is a full stop
+		float bend = 180;
+		if (n + 1 < waypoints.size()) {
+			float xIn = n ? targetX.convert(centimeter) - waypoints[n - 1].x.convert(centimeter) : xLeg;
+			float yIn = n ? targetY.convert(centimeter) - waypoints[n - 1].y.convert(centimeter) : yLeg;
+			float xOut = waypoints[n + 1].x.convert(centimeter) - targetX.convert(centimeter);
+			float yOut = waypoints[n + 1].y.convert(centimeter) - targetY.convert(centimeter);
+			bend = std::abs(std::remainder(std::atan2(yOut, xOut) - std::atan2(yIn, xIn), 2 * M_PI)) * 180 / M_PI;
+		}
+
+		// stopping here anyways, so let driveQ bring us in (and driveTo turn first if we're standing still)
+		if (bend > sharpTurn) {
+			if (voltage == 0) driveTo(targetX, targetY, backwards, voltageMax, false, debugLog);
+			else driveQ(targetX, targetY, backwards, voltageMax, false, debugLog);
+			voltage = 0;
+			if (status.cancelled) return;
+			continue;
+		}
+
+		// from a standstill face the waypoint first like driveTo does
+		if (voltage == 0) {
+			targetTheta = std::atan2(yLeg, xLeg) * 180 / M_PI + (backwards ? 180 : 0);
+			if (std::abs(std::remainder(targetTheta - imu.get_rotation(), 360)) > 20) turnQ(targetX, targetY, backwards, false, debugLog);
+			if (status.cancelled) return;
+		}
+		status.begin(legLength, true);
+
+		LoopTimer timer(20, "driveChain"); // runs the loop every 20ms on the dot
+
+		while (true) {
+			pose = odometry.getPose();
+			xDif = targetX.convert(centimeter) - pose.x;
+			yDif = targetY.convert(centimeter) - pose.y;
+			error = std::sqrt(std::pow(xDif, 2) + std::pow(yDif, 2));
+			along = (xDif * xLeg + yDif * yLeg) / legLength;
+			status.travelled = std::max(0.0f, legLength - along);
+
+			// on to the next one
+			if (error < passRadius or along <= 0 or status.cancelled) break;
+
+			// steer at the waypoint, backwards means pointing the back of the robot at it
+			targetTheta = std::atan2(yDif, xDif) * 180 / M_PI + (backwards ? 180 : 0);
+			errorTheta = std::remainder(targetTheta - imu.get_rotation(), 360);
+
+			voltage = std::min(voltage + acc * (float)timer.ticks(), voltageMax / 127.0f); // slew rate
+			voltageTurn = errorTheta * kpTurn;
+			if (backwards) chassis->getModel()->tank(-voltage + voltageTurn, -voltage - voltageTurn);
+			else chassis->getModel()->tank(voltage + voltageTurn, voltage - voltageTurn);
+
+			if (debugLog or logMoves) telemetry().log(Telemetry::waypoint, {float(n), error, errorTheta});
+
+			// nothing goes after this
+			timer.wait();
+		}
+		timer.report();
+		if (status.cancelled) {
+			chassis->stop();
+			return;
+		}
+		if (debugLog or logMoves) telemetry().log(Telemetry::passedWaypoint, {float(n), float(pros::millis() - startTime)});
+	}
+}
+
+// when driveToPose calls it done, the defaults are about what driveQ and turnQ settle to
+struct PoseSettle {
+	float distance = 3; // cm from the target point
+	float angle = 3; // deg from the target heading
+	int dwell = 100; // ms both have to hold for
+	int timeout = 4000; // ms, give up and stop wherever we are
+	float velocity = 5; // cm/s, the faster tracking wheel has to be slower than this to count as stopped
+};
+
+// drives to targetX, targetY and ends facing targetTheta in one move, curving in rather than a driveQ then a turnP
+// steers at a carrot lead * (distance left) behind the target along targetTheta, so a bigger lead swings wider and
+// comes in straighter, 0 is just driveQ with a final turn on the spot
+// backwards drives in reverse, the front still ends up at targetTheta
+void driveToPose(QLength targetX, QLength targetY, QAngle targetTheta, float lead=0.6, bool backwards=false, float voltageMax=115, PoseSettle settle=PoseSettle(), bool debugLog=false) {
+
+	// the touchables
+	float kp = 0.058; // per cm, same as driveQ's straights
+	float kd = 0.5;
+	float kpTurn = 0.03; // per deg
+	float kdTurn = 0.2;
+	float approach = 15; // cm, inside this we stop chasing the carrot and just turn to targetTheta
+
+	// the untouchables
+	float x;
+	float y;
+	float xCarrot;
+	float yCarrot;
+	float error; // cm to the target
+	float errorLast = 0;
+	float errorTheta; // deg to whatever we're steering at
+	float errorThetaLast = 0;
+	float errorFinal; // deg to targetTheta
+	float voltage; // straight
+	float voltageTurn;
+	float errorFacing; // deg between where we point and the target point
+	float targetRad = targetTheta.convert(radian);
+	float velocity; // cm/s, the faster tracking wheel
+	int sensorLeft = chassis->getModel()->getSensorVals()[0];
+	int sensorRight = chassis->getModel()->getSensorVals()[1];
+	int startTime = pros::millis();
+	voltageMax = voltageMax/127; // normalize the voltageMax
+	MotionStatus &status = motionStatus();
+	status.begin(std::hypot(targetX.convert(centimeter) - odometry.getPose().x, targetY.convert(centimeter) - odometry.getPose().y), true);
+	SettleDetector settleDetector({settle.distance, settle.velocity, settle.dwell, 300, 2.5, 3 * settle.distance, settle.timeout}); // the heading error gets scaled to cm to share the band
+
+	LoopTimer timer(10, "driveToPose"); // runs the loop every 10ms on the dot
+
+	while (true) {
+		OdomPose pose = odometry.getPose();
+		x = pose.x;
+		y = pose.y;
+		error = std::hypot(targetX.convert(centimeter) - x, targetY.convert(centimeter) - y);
+		status.travelled = std::max(0.0f, status.total - error);
+		errorFinal = std::remainder(targetTheta.convert(degree) - imu.get_rotation(), 360);
+		velocity = std::max(std::abs(chassis->getModel()->getSensorVals()[0] - sensorLeft), std::abs(chassis->getModel()->getSensorVals()[1] - sensorRight)) * TRACKING_CM_PER_TICK / timer.dt();
+		sensorLeft = chassis->getModel()->getSensorVals()[0];
+		sensorRight = chassis->getModel()->getSensorVals()[1];
+
+		// the carrot, backwards comes in from the other side
+		xCarrot = targetX.convert(centimeter) - (backwards ? -1 : 1) * lead * error * std::cos(targetRad);
+		yCarrot = targetY.convert(centimeter) - (backwards ? -1 : 1) * lead * error * std::sin(targetRad);
+
+		// steer at the carrot until we're close, then at the final heading
+		if (error > approach) errorTheta = std::remainder(std::atan2(yCarrot - y, xCarrot - x) * 180 / M_PI + (backwards ? 180 : 0) - imu.get_rotation(), 360);
+		else errorTheta = errorFinal;
+
+		// straight, only as much as we're pointed the right way so we don't drive off sideways
+		errorFacing = std::remainder(std::atan2(targetY.convert(centimeter) - y, targetX.convert(centimeter) - x) * 180 / M_PI + (backwards ? 180 : 0) - imu.get_rotation(), 360);
+		voltage = error * kp + (error - errorLast) / timer.ticks() * kd;
+		voltage = std::min(voltage, voltageMax) * std::max(0.0, std::cos(errorFacing * M_PI / 180));
+		if (backwards) voltage = -voltage;
+		voltageTurn = errorTheta * kpTurn + (errorTheta - errorThetaLast) / timer.ticks() * kdTurn;
+
+		// turning wins if a side would saturate
+		if (std::abs(voltage) + std::abs(voltageTurn) > 1) voltage = std::copysign(std::max(0.0f, 1 - std::abs(voltageTurn)), voltage);
+		chassis->getModel()->tank(voltage + voltageTurn, voltage - voltageTurn);
+
+		// exit paramaters
+		if (settleDetector.update(std::max(error, std::abs(errorFinal) * settle.distance / settle.angle), velocity, status.cancelled)) {
+			chassis->stop();
+			std::cout << pros::millis() << "task complete with error " << error << "cm " << errorFinal << "deg, in " << (pros::millis() - startTime) << "ms, " << settleDetector.reasonName() << std::endl;
+			timer.report();
+			return;
+		}
+
+		// debug
+		if (debugLog or logMoves) telemetry().log(Telemetry::driveToPose, {error, errorTheta, errorFinal});
+
+		// nothing goes after this
+		errorLast = error;
+		errorThetaLast = errorTheta;
+		timer.wait();
+	}
+}
+
+// follows a PursuitPath off odom x/y and the imu, unlike profileController it steers back when something knocks us off the path
+// ie followPath(PursuitPath({{0_in, 0_in, 0_deg}, {40_in, 10_in, 0_deg}})); is 9cCurve1 closed loop
+// backwards drives the path with the back of the robot, the waypoint thetas are then the way the back points
+void followPath(const PursuitPath &path, bool backwards=false, bool debugLog=false) {
+
+	// the touchables
+	float topSpeed = 106; // cm/s, 200rpm on 4in wheels
+	float track = 20.6; // cm, the 8.125in wheelbase
+
+	// the untouchables
+	PurePursuit pursuit(path);
+	PurePursuit::Output target;
+	float velocity = 0; // cm/s, the path's speed but never climbing faster than maxAccel
+	float velocityLeft;
+	float velocityRight;
+	float scale;
+	float theta;
+	float speed; // cm/s forward
+	int sensorLeft = chassis->getModel()->getSensorVals()[0];
+	int sensorRight = chassis->getModel()->getSensorVals()[1];
+	int startTime = pros::millis();
+	MotionStatus &status = motionStatus();
+	status.begin(path.length(), true);
+	// the path says when it's done so this is for getting stuck, and goes by the path left, the end can be further away
+	// halfway round a curve. twice as long as the path takes at its top speed, and a second to get going
+	SettleDetector settle({2, 3, 0, 500, 2, 10, int(2000 * path.length() / path.limits().maxVelocity) + 1000}); // cm, cm/s, ms, ms, cm/s, cm, ms
+
+	LoopTimer timer(10, "followPath"); // runs the loop every 10ms on the dot
+
+	while (true) {
+		theta = imu.get_rotation() * M_PI / 180 + (backwards ? M_PI : 0);
+		OdomPose pose = odometry.getPose();
+		target = pursuit.step(pose.x, pose.y, theta);
+		status.travelled = target.travelled;
+		speed = (chassis->getModel()->getSensorVals()[0] - sensorLeft + chassis->getModel()->getSensorVals()[1] - sensorRight) / 2.0 * TRACKING_CM_PER_TICK / timer.dt();
+		sensorLeft = chassis->getModel()->getSensorVals()[0];
+		sensorRight = chassis->getModel()->getSensorVals()[1];
+
+		// exit paramaters
+		if (settle.update(path.length() - target.travelled, speed, status.cancelled) or target.done) {
+			chassis->stop();
+			std::cout << pros::millis() << "task complete with error " << target.endError << "cm, in " << (pros::millis() - startTime) << "ms, " << (settle.reason() == SettleReason::running ? "end of path" : settle.reasonName()) << std::endl;
+			timer.report();
+			return;
+		}
+
+		// wheel speeds for the arc through the lookahead point
+		velocity = std::min(target.velocity, velocity + path.limits().maxAccel * (float)timer.dt());
+		velocityLeft = velocity * (1 + target.curvature * track / 2);
+		velocityRight = velocity * (1 - target.curvature * track / 2);
+		scale = std::max({1.0f, std::abs(velocityLeft) / topSpeed, std::abs(velocityRight) / topSpeed}); // slow both sides to keep the arc
+		velocityLeft /= scale;
+		velocityRight /= scale;
+
+		// the motors' own velocity loops, voltage would let the turn scrub eat the difference between the sides
+		if (backwards) { // the back's left is our right
+			chassis->getModel()->left(-velocityRight / topSpeed);
+			chassis->getModel()->right(-velocityLeft / topSpeed);
+		}
+		else {
+			chassis->getModel()->left(velocityLeft / topSpeed);
+			chassis->getModel()->right(velocityRight / topSpeed);
+		}
+
+		// debug
+		if (debugLog or logMoves) telemetry().log(Telemetry::followPath, {target.travelled, target.curvature, velocity});
+
+		// nothing goes after this
+		timer.wait();
+	}
+}
+
+// drives straight at power (-1 to 1, negative backs into it) till we've hit something and stopped against it, for squaring up on a wall
+// instead of a fixed delay that's too short on a slow battery and wastes time shoving on a fresh one, timeout is for when there's no wall
+void ramWall(float power, std::uint32_t timeout=1500, bool debugLog=false) {
+
+	// the touchables
+	std::uint32_t pushTime = 150; // ms from the hit till we're done, as long as we've stopped, so it has a moment to square up
+
+	// the untouchables
+	std::uint32_t startTime = pros::millis();
+	std::uint32_t collisionsStart = odometry.getContact().collisions;
+	MotionStatus &status = motionStatus();
+	status.begin(0, true);
+
+	LoopTimer timer(10, "ramWall");
+
+	while (true) {
+		ContactState contact = odometry.getContact();
+		bool hit = contact.collisions != collisionsStart;
+
+		chassis->getModel()->tank(power, power);
+
+		// exit paramaters
+		SettleReason reason = SettleReason::running;
+		if (status.cancelled) reason = SettleReason::cancelled;
+		else if (hit and contact.stopped and pros::millis() - contact.collisionTime >= pushTime) reason = SettleReason::settled;
+		else if (pros::millis() - startTime >= timeout) reason = SettleReason::timedOut;
+		if (reason != SettleReason::running) {
+			chassis->getModel()->tank(0, 0);
+			std::cout << pros::millis() << "task complete with error " << (hit ? contact.impact : 0) << "g hit, in " << (pros::millis() - startTime) << "ms, " << settleReasonName(reason) << std::endl;
+			timer.report();
+			return;
+		}
+
+		// debug
+		if (debugLog or logMoves) telemetry().log(Telemetry::ramWall, {float(hit), float(contact.stopped), float(contact.slipLeft), float(contact.slipRight)});
+
+		// nothing goes after this
+		timer.wait();
+	}
+}
+
+// the same moves in their own task, they hand back right away so the auton can get on with the tray/lift
+// ie auto move = driveToAsync(40_in, 0_in); move.waitUntilDistance(20_in); liftMotor.moveAbsolute(400, 200); move.waitUntilSettled();
+AsyncMotion drivePAsync(int targetLeft, int targetRight, int voltageMax=115, bool debugLog=false) {
+	return AsyncMotion([=] { driveP(targetLeft, targetRight, voltageMax, debugLog); });
+}
+
+AsyncMotion driveQAsync(QLength targetX, QLength targetY, bool backwards=false, float voltageMax=115, bool forceFlip=false, bool debugLog=false) {
+	return AsyncMotion([=] { driveQ(targetX, targetY, backwards, voltageMax, forceFlip, debugLog); });
+}
+
+AsyncMotion turnPAsync(int targetTurn, int voltageMax=127, bool debugLog=false) {
+	return AsyncMotion([=] { turnP(targetTurn, voltageMax, debugLog); }, false);
+}
+
+AsyncMotion turnQAsync(QLength targetX, QLength targetY, bool backwards=false, bool forceFlip=false, bool debugLog=false) {
+	return AsyncMotion([=] { turnQ(targetX, targetY, backwards, forceFlip, debugLog); }, false);
+}
+
+AsyncMotion driveToPoseAsync(QLength targetX, QLength targetY, QAngle targetTheta, float lead=0.6, bool backwards=false, float voltageMax=115, PoseSettle settle=PoseSettle(), bool debugLog=false) {
+	return AsyncMotion([=] { driveToPose(targetX, targetY, targetTheta, lead, backwards, voltageMax, settle, debugLog); });
+}
+
+AsyncMotion followPathAsync(const PursuitPath &path, bool backwards=false, bool debugLog=false) {
+	return AsyncMotion([=] { followPath(path, backwards, debugLog); });
+}
+
+// progress and distance follow whichever leg of the chain we're on
+AsyncMotion driveChainAsync(const std::vector<Point> &waypoints, bool backwards=false, int voltageMax=115, float sharpTurn=45, bool debugLog=false) {
+	return AsyncMotion([=] { driveChain(waypoints, backwards, voltageMax, sharpTurn, debugLog); });
+}
+
+// progress and distance follow the drive, the turn before it (if there is one) counts as 0
+AsyncMotion driveToAsync(QLength targetX, QLength targetY, bool backwards=false, int voltageMax=115, bool forceFlip=false, bool debugLog=false) {
+	return AsyncMotion([=] { driveTo(targetX, targetY, backwards, voltageMax, forceFlip, debugLog); });
+}
+
+void traySlew(MotorCache &tray, bool forward) {
+	const double trayPosition = sensors.get().trayPosition;
 	if (forward) {
-		if (trayMotor.getPosition() > 4500) trayMotor.moveVelocity(40);
-		else trayMotor.moveVelocity(100);
+		if (trayPosition > 4500) tray.moveVelocity(40);
+		else tray.moveVelocity(100);
 	}
 	else {
-		if (trayMotor.getPosition() < 1000) trayMotor.moveVelocity(-60);
-		else trayMotor.moveVelocity(-100);
+		if (trayPosition < 1000) tray.moveVelocity(-60);
+		else tray.moveVelocity(-100);
 	}
 }
 
@@ -460,15 +819,12 @@ void generatePaths() { // all motion profile paths stored here, no real error co
 
 // a blocking flipout function
 void flipout() {
-	auto timer = TimeUtilFactory().create().getTimer();
 	intakeMotors.moveVelocity(200);
 	liftMotor.moveAbsolute(400, 200);
-	timer->placeMark();
-	while(line.get_value_calibrated_HR() > 46000 and timer->getDtFromMark().convert(second) < 0.5) pros::delay(20); // wait for the cube to get to position
+	cube.waitUntilCovered(500); // wait for the cube to get to position
 	intakeMotors.moveVelocity(200);
 	pros::delay(100);
-	timer->placeMark();
-	while(line.get_value_calibrated_HR() < 46000 and timer->getDtFromMark().convert(second) < 0.5) pros::delay(20); // move cube above position to initiate flipout
+	cube.waitUntilUncovered(500); // move cube above position to initiate flipout
 	intakeMotors.moveRelative(600, 200);
 	pros::delay(20);
 	while(abs(intakeMotors.getPositionError()) > 50) pros::delay(20); // save the cube yo
@@ -480,11 +836,74 @@ void flipout() {
 	while(abs(liftMotor.getPositionError()) > 40) pros::delay(20);
 }
 
-// just update calculated theta to actual theta using the imu
-void odomImuSupplement (void*) {
+// drivetrain characterization, pick it on the skills tab and run it as the auton with room to drive ~2m forward
+// ramps the voltage slowly (quasistatic, where speed is all kV) then steps it (dynamic, where acceleration is all kA)
+// both ways, then spins on the spot for the tracking wheels' track width. every 10ms it logs
+// <ms>: char <test> <volts left> <volts right> <cm/s left> <cm/s right> <cm/s^2 left> <cm/s^2 right> <deg/s>
+// pros terminal > char.log then sim/bin/drivefit char.log fits kS/kV/kA for driveFeedforward, the sim does the same
+void characterize() {
+	// one test, ivolts gives each side's voltage ims into it
+	auto run = [](Telemetry::Channel channel, std::uint32_t duration, std::function<std::pair<float, float>(int)> ivolts) {
+		float positionLeft[5] = {}; // cm, the last 5 loops so speeds are over 40ms and not one tick of encoder
+		float positionRight[5] = {};
+		float rotation[5] = {};
+		float velocityLeft[9] = {}; // and accelerations over 80ms, they're the noisy ones
+		float velocityRight[9] = {};
+		int startLeft = chassis->getModel()->getSensorVals()[0];
+		int startRight = chassis->getModel()->getSensorVals()[1];
+		std::uint32_t startTime = pros::millis();
+		LoopTimer timer(10, "characterize");
+		for (int loop = 0; pros::millis() - startTime < duration; loop++) {
+			std::pair<float, float> volts = ivolts(pros::millis() - startTime);
+			chassis->getModel()->tank(volts.first / 12, volts.second / 12);
+			for (int i = 8; i > 0; i--) {
+				if (i < 5) {
+					positionLeft[i] = positionLeft[i - 1];
+					positionRight[i] = positionRight[i - 1];
+					rotation[i] = rotation[i - 1];
+				}
+				velocityLeft[i] = velocityLeft[i - 1];
+				velocityRight[i] = velocityRight[i - 1];
+			}
+			positionLeft[0] = (chassis->getModel()->getSensorVals()[0] - startLeft) * TRACKING_CM_PER_TICK;
+			positionRight[0] = (chassis->getModel()->getSensorVals()[1] - startRight) * TRACKING_CM_PER_TICK;
+			rotation[0] = imu.get_rotation();
+			velocityLeft[0] = (positionLeft[0] - positionLeft[4]) / 0.04;
+			velocityRight[0] = (positionRight[0] - positionRight[4]) / 0.04;
+			if (loop >= 12) { // the windows are full
+				telemetry().log(channel, {volts.first, volts.second, velocityLeft[0], velocityRight[0], (velocityLeft[0] - velocityLeft[8]) / 0.08f,
+				                          (velocityRight[0] - velocityRight[8]) / 0.08f, (rotation[0] - rotation[4]) / 0.04f});
+			}
+			timer.wait();
+		}
+		chassis->getModel()->tank(0, 0);
+		pros::delay(1000); // let it roll to a stop before the next one
+	};
+
+	chassis->getModel()->setBrakeMode(AbstractMotor::brakeMode::coast);
+	std::cout << pros::millis() << ": characterizing..." << std::endl;
+	run(Telemetry::charQuasistatic, 6000, [](int ims) { return std::make_pair(ims / 1000.0f, ims / 1000.0f); }); // 1V/s
+	run(Telemetry::charQuasistatic, 6000, [](int ims) { return std::make_pair(-ims / 1000.0f, -ims / 1000.0f); });
+	run(Telemetry::charDynamic, 1200, [](int) { return std::make_pair(6.0f, 6.0f); });
+	run(Telemetry::charDynamic, 1200, [](int) { return std::make_pair(-6.0f, -6.0f); });
+	run(Telemetry::charSpin, 1500, [](int) { return std::make_pair(8.0f, -8.0f); }); // turning scrubs so it needs more to get going
+	run(Telemetry::charSpin, 1500, [](int) { return std::make_pair(-8.0f, 8.0f); });
+	chassis->getModel()->setBrakeMode(AbstractMotor::brakeMode::hold);
+	std::cout << pros::millis() << ": finished characterizing" << std::endl;
+}
+
+// prints the odom when odomDebug is on, the odom itself runs in its own task now
+void odomPrint (void*) {
+	bool benchmarked = false;
 	while (true) {
-		chassis->setState({chassis->getState().x, chassis->getState().y, (((imu.get_rotation()*M_PI)/180) * okapi::radian)});
-		if (odomDebug) std::cout << pros::millis() << ": pos  " << chassis->getState().str() << std::endl;
+		if (odomDebug) {
+			if (!benchmarked) { // what the ekf costs on the brain, it has to fit in the odom's 10ms with lots to spare
+				std::cout << pros::millis() << ": ekf " << odometry.benchmark() << "us an update" << std::endl;
+				benchmarked = true;
+			}
+			OdomPose pose = odometry.getPose();
+			std::cout << pros::millis() << ": pos  " << pose.x << "cm " << pose.y << "cm " << pose.theta * 180 / M_PI << "deg" << std::endl;
+		}
 		pros::delay(20);
 	}
 
@@ -512,6 +931,12 @@ static lv_res_t skillsBtnAction(lv_obj_t *btn) {
 	return LV_RES_OK;
 }
 
+static lv_res_t characterizeBtnAction(lv_obj_t *btn) {
+	masterController.rumble("..");
+	autonSelection = autonStates::characterize;
+	return LV_RES_OK;
+}
+
 /**
  * Runs initialization code. This occurs as soon as the program is started.
  *
@@ -571,6 +996,16 @@ void initialize() {
 	lv_obj_align(skillsBtn, NULL, LV_ALIGN_CENTER, 0, 0);
 	lv_obj_set_free_num(skillsBtn, 102);
 
+	// characterization, also on the skills tab since it isn't for matches
+	lv_obj_t *characterizeBtn = lv_btn_create(skillsTab, NULL);
+	lv_obj_t *characterizeLabel = lv_label_create(characterizeBtn, NULL);
+	lv_label_set_text(characterizeLabel, "Characterize");
+	lv_btn_set_action(characterizeBtn, LV_BTN_ACTION_CLICK, characterizeBtnAction);
+	lv_obj_set_size(characterizeBtn, 450, 50);
+	lv_obj_set_pos(characterizeBtn, 0, 160);
+	lv_obj_align(characterizeBtn, NULL, LV_ALIGN_CENTER, 0, 60);
+	lv_obj_set_free_num(characterizeBtn, 103);
+
 	// debug
 	lv_obj_t *msgBox = lv_mbox_create(telemetryTab, NULL);
 	lv_mbox_set_text(msgBox, "rick from r");
@@ -593,9 +1028,20 @@ void initialize() {
 		std::cout << pros::millis() << ": calibration failed, moving on" << std::endl;
 	}
 
-	// start imu implementation to odom
-	pros::Task odomImuSupplementTask(odomImuSupplement, (void*)NULL, TASK_PRIORITY_DEFAULT-1, TASK_STACK_DEPTH_DEFAULT, "odomImuSUpplement");
-	std::cout << pros::millis() << " odomImuSupplement state:" << odomImuSupplementTask.get_state();
+	// debugLog and the odom log go through here so they don't slow down what they're logging
+	// with a card in it all goes on there too, the odom's sensors and every move included, so there's full rate data
+	// from real matches. sim/bin/logdecode turns a log into csv, sim/bin/stepstats breaks the moves down
+	if (pros::usd::is_installed() and telemetry().openLog("/usd/")) {
+		odometry.setLogging(true);
+		logMoves = true;
+	}
+	telemetry().start();
+
+	// our own odom, the motion functions all go by this now
+	odometry.start(10);
+	cube.start(5);
+
+	pros::Task odomPrintTask(odomPrint, (void*)NULL, TASK_PRIORITY_DEFAULT-1, TASK_STACK_DEPTH_DEFAULT, "odomPrint");
 
 	// log motor temps
 	std::cout << pros::millis() << "\n" << pros::millis() << ": motor temps:" << std::endl;
@@ -611,7 +1057,9 @@ void initialize() {
  * the robot is enabled, this task will exit.
  */
 void disabled() {
+	cancelAsyncMotion(); // it'd keep driving otherwise, nothing stops its task when autonomous does
 	chassis->stop();
+	telemetry().flushLog(); // it's likely to get turned off next
 }
 
 /**
@@ -637,6 +1085,7 @@ void competition_initialize() {}
 
 void autonomous() {
 	chassis->setState({0_cm, 0_cm, 0_deg});
+	odometry.setPose(0, 0, imu.get_rotation() * M_PI / 180); // theta stays the imu's, the motion functions turn by imu.get_rotation()
 	chassis->setMaxVelocity(200);
 	chassis->getModel()->setBrakeMode(AbstractMotor::brakeMode::hold);
 	
@@ -659,17 +1108,13 @@ void autonomous() {
 		driveTo(110_in, 0_in, false, 50);
 		pros::delay(600); // wait for last cube
 		// cubes to position
-		timer->placeMark();
-		while (line.get_value_calibrated_HR() < 46000 and timer->getDtFromMark().convert(second) < 1) pros::delay(200); // wait for the cubes to go above line sensor
+		cube.waitUntilUncovered(1000); // wait for the cubes to go above line sensor
 		intakeMotors.moveVelocity(-100);
-		timer->placeMark();
-		while(line.get_value_calibrated_HR() > 46000 and timer->getDtFromMark().convert(second) < 1) pros::delay(20); // go down until we are covering
+		cube.waitUntilCovered(1000); // go down until we are covering
 		intakeMotors.moveRelative(-50, 100);
 		// go to zone
 		turnP(45);
-		chassis->getModel()->tank(0.8, 0.8); // ram into wall, fingers crossed it lines us up
-		pros::delay(700);
-		chassis->getModel()->tank(0, 0);
+		ramWall(0.8); // ram into wall, fingers crossed it lines us up
 		// stack the first 10
 		trayMotor.moveAbsolute(6350, 70);
 		intakeMotors.setBrakeMode(AbstractMotor::brakeMode::coast);
@@ -688,12 +1133,11 @@ void autonomous() {
 		intakeMotors.moveVelocity(200);
 		driveTo(115_in, -28_in, false, 80);
 		// move the first cube to position
-		timer->placeMark();
-		while (line.get_value_calibrated_HR() < 46000 and timer->getDtFromMark().convert(second) < 1) pros::delay(20); // wait for the cubes to go above line sensor
+		cube.waitUntilUncovered(1000); // wait for the cubes to go above line sensor
 		intakeMotors.moveVelocity(-100);
-		timer->placeMark();
-		while(line.get_value_calibrated_HR() > 46000 and timer->getDtFromMark().convert(second) < 1) pros::delay(20); // go down until we are covering
+		cube.waitUntilCovered(1000); // go down until we are covering
 		intakeMotors.moveRelative(-50, 100);
+		timer->placeMark();
 		while (abs(intakeMotors.getPositionError()) > 20 and timer->getDtFromMark().convert(second) < 1) pros::delay(20);
 		liftMotor.moveAbsolute(2300, 100);
 		driveP(-150, -150);
@@ -711,11 +1155,9 @@ void autonomous() {
 		liftMotor.moveAbsolute(-20, 100);
 		driveTo(35_in, -22_in, false, 50, true);
 		// move second stack to correct position
-		timer->placeMark();
-		while (line.get_value_calibrated_HR() < 46000 and timer->getDtFromMark().convert(second) < 1) pros::delay(200); // wait for the cubes to go above line sensor
+		cube.waitUntilUncovered(1000); // wait for the cubes to go above line sensor
 		intakeMotors.moveVelocity(-200);
-		timer->placeMark();
-		while(line.get_value_calibrated_HR() > 46000 and timer->getDtFromMark().convert(second) < 1) pros::delay(20); // go down until we are covering
+		cube.waitUntilCovered(1000); // go down until we are covering
 		intakeMotors.moveRelative(-150, 100);
 		timer->placeMark();
 		while (abs(intakeMotors.getPositionError()) > 20 and timer->getDtFromMark().convert(second) < 1) pros::delay(20);
@@ -733,11 +1175,9 @@ void autonomous() {
 		// grab 2nd tower cube
 		intakeMotors.moveVelocity(200);
 		driveTo(56_in, 7_in);
-		timer->placeMark();
-		while (line.get_value_calibrated_HR() < 46000 and timer->getDtFromMark().convert(second) < 1) pros::delay(20);
+		cube.waitUntilUncovered(1000);
 		intakeMotors.moveVelocity(-100);
-		timer->placeMark();
-		while(line.get_value_calibrated_HR() > 46000 and timer->getDtFromMark().convert(second) < 1) pros::delay(20);
+		cube.waitUntilCovered(1000);
 		intakeMotors.moveRelative(-50, 100);
 		timer->placeMark();
 		while (abs(intakeMotors.getPositionError()) > 20 and timer->getDtFromMark().convert(second) < 1) pros::delay(20);
@@ -755,11 +1195,9 @@ void autonomous() {
 		intakeMotors.moveVelocity(200);
 		driveTo(23_in, -35_in);
 		// normalize 3rd cube
-		timer->placeMark();
-		while (line.get_value_calibrated_HR() < 46000 and timer->getDtFromMark().convert(second) < 1) pros::delay(20);
+		cube.waitUntilUncovered(1000);
 		intakeMotors.moveVelocity(-100);
-		timer->placeMark();
-		while(line.get_value_calibrated_HR() > 46000 and timer->getDtFromMark().convert(second) < 1) pros::delay(20);
+		cube.waitUntilCovered(1000);
 		intakeMotors.moveRelative(-50, 100);
 		timer->placeMark();
 		while (abs(intakeMotors.getPositionError()) > 20 and timer->getDtFromMark().convert(second) < 1) pros::delay(20);
@@ -792,11 +1230,9 @@ void autonomous() {
 		driveQ(42_in, 24_in, false, 65);
 		intakeMotors.moveVelocity(200);
 		// move cubes to stacking position
-		timer->placeMark();
-		while (line.get_value_calibrated_HR() < 46000 and timer->getDtFromMark().convert(second) < 0.5) pros::delay(20);
+		cube.waitUntilUncovered(500);
 		intakeMotors.moveVelocity(-200);
-		timer->placeMark();
-		while(line.get_value_calibrated_HR() > 46000 and timer->getDtFromMark().convert(second) < 0.5) pros::delay(20);
+		cube.waitUntilCovered(500);
 		intakeMotors.moveRelative(-240, 200);
 		// move to zone
 		turnQ(9_in, -43_in);
@@ -822,12 +1258,10 @@ void autonomous() {
 		chassis->getModel()->setBrakeMode(AbstractMotor::brakeMode::coast);
 		intakeMotors.moveVelocity(200);
 		liftMotor.moveAbsolute(400, 200);
-		timer->placeMark();
-		while(line.get_value_calibrated_HR() > 46000 and timer->getDtFromMark().convert(second) < 0.5) pros::delay(20); // wait for the cube to get to position
+		cube.waitUntilCovered(500); // wait for the cube to get to position
 		intakeMotors.moveVelocity(200);
 		pros::delay(100);
-		timer->placeMark();
-		while(line.get_value_calibrated_HR() < 46000 and timer->getDtFromMark().convert(second) < 0.5) pros::delay(20); // move cube above position to initiate flipout
+		cube.waitUntilUncovered(500); // move cube above position to initiate flipout
 		intakeMotors.moveRelative(600, 200);
 		pros::delay(20);
 		while(abs(intakeMotors.getPositionError()) > 50) pros::delay(20); // save the cube yo
@@ -845,11 +1279,9 @@ void autonomous() {
 		// grab the 3rd cube
 		driveTo(20.5_in, -24_in, false, 70);
 		// move cubes to correct position
-		timer->placeMark();
-		while (line.get_value_calibrated_HR() < 46000 and timer->getDtFromMark().convert(second) < 0.5) pros::delay(20);
+		cube.waitUntilUncovered(500);
 		intakeMotors.moveVelocity(-200);
-		timer->placeMark();
-		while(line.get_value_calibrated_HR() > 46000 and timer->getDtFromMark().convert(second) < 0.5) pros::delay(20);
+		cube.waitUntilCovered(500);
 		intakeMotors.moveRelative(-120, 200);
 		// drive to zone
 		driveTo(8.5_in, -33.5_in, false, 70);
@@ -876,11 +1308,9 @@ void autonomous() {
 		turnQ(100_in, 0_in); // idk why but it needs this??
 		driveTo(50_in, -2_in, false, 60);
 		// move cubes to stacking position
-		timer->placeMark();
-		while (line.get_value_calibrated_HR() < 46000 and timer->getDtFromMark().convert(second) < 0.5) pros::delay(20);
+		cube.waitUntilUncovered(500);
 		intakeMotors.moveVelocity(-200);
-		timer->placeMark();
-		while(line.get_value_calibrated_HR() > 46000 and timer->getDtFromMark().convert(second) < 0.5) pros::delay(20);
+		cube.waitUntilCovered(500);
 		intakeMotors.moveRelative(-240, 200);
 		// move to zone
 		turnQ(9_in, 26_in);
@@ -920,11 +1350,9 @@ void autonomous() {
 		driveQ(42_in, -24_in, false, 65);
 		intakeMotors.moveVelocity(200);
 		// move cubes to stacking position
-		timer->placeMark();
-		while (line.get_value_calibrated_HR() < 46000 and timer->getDtFromMark().convert(second) < 0.5) pros::delay(20);
+		cube.waitUntilUncovered(500);
 		intakeMotors.moveVelocity(-200);
-		timer->placeMark();
-		while(line.get_value_calibrated_HR() > 46000 and timer->getDtFromMark().convert(second) < 0.5) pros::delay(20);
+		cube.waitUntilCovered(500);
 		intakeMotors.moveRelative(-150, 200);
 		// move to zone
 		turnQ(9_in, -40_in);
@@ -958,6 +1386,7 @@ void autonomous() {
 		intakeMotors.moveRelative(500, 200);
 		// move for zone
 		driveTo(18_in, 4_in, true);
+		trayMotor.moveAbsolute(4000, 100); // same as unprotec, get the tray most of the way up on the way there
 		driveTo(12_in, 10_in);
 		// stack
 		liftMotor.moveAbsolute(-20, 100);
@@ -974,11 +1403,16 @@ void autonomous() {
 	case autonStates::blueRick:
 		// blue protec 3 cube
 		break;
+
+	case autonStates::characterize:
+		characterize();
+		break;
 	
 	default:
 		break;
 	}
 	std::cout << pros::millis() << ": auton took " << timer->getDtFromMark().convert(second) << " seconds" << std::endl;
+	telemetry().flushLog(); // the end of the run is the bit we want, don't leave it sitting in the block
 }
 
 /**
@@ -996,6 +1430,7 @@ void autonomous() {
  */
 
 void opcontrol() {
+	cancelAsyncMotion();
 	chassis->stop();
 	chassis->getModel()->setBrakeMode(AbstractMotor::brakeMode::coast);
 	trayMotor.setBrakeMode(okapi::AbstractMotor::brakeMode::hold);
@@ -1004,19 +1439,33 @@ void opcontrol() {
 	bool cubesPositioning = false; // true when we are moving the cubes down to the line sensor, for stacking
 	bool trayDebug = false; // im lazy
 	bool cubeDebug = false; // still lazy
+	bool writeDebug = false; // prints how many motor writes the caches saved every 5s
 	auto timer = TimeUtilFactory().create().getTimer();
+	// every command in the loop goes through these and gets sent once at the bottom, if it changed
+	MotorCache lift(liftMotor, "lift");
+	MotorCache tray(trayMotor, "tray");
+	MotorCache intake(intakeMotors, "intake");
+	ChassisCache drive(chassis->getModel(), "drive");
+	int loops = 0;
 
 	// main loop
 	while (true) {
+		const SensorSnapshot &sense = sensors.sample(); // everything below reads from this, not the devices
+
 		// basic lift control
-		if (liftUp.isPressed()) liftMotor.moveVelocity(100);
-		else if (liftDown.isPressed()) liftMotor.moveVelocity(-100);
-		else if (liftMotor.getPosition() < LIFT_STACKING_HEIGHT and liftMotor.getPosition() > LIFT_STACKING_HEIGHT - 300) liftMotor.moveVoltage(-2000); // basically to force the lift down but not burn the motor, shut off the motor when we stabalize at 0
-		else if (liftMotor.getPosition() < LIFT_STACKING_HEIGHT and liftMotor.getEfficiency() > 50) liftMotor.moveVoltage(-2000);
-		else liftMotor.moveVoltage(0);
+		if (liftUp.isPressed()) lift.moveVelocity(100);
+		else if (liftDown.isPressed()) lift.moveVelocity(-100);
+		else if (sense.liftPosition < LIFT_STACKING_HEIGHT and sense.liftPosition > LIFT_STACKING_HEIGHT - 300) lift.moveVoltage(-2000); // basically to force the lift down but not burn the motor, shut off the motor when we stabalize at 0
+		else if (sense.liftPosition < LIFT_STACKING_HEIGHT and sense.liftEfficiency > 50) lift.moveVoltage(-2000);
+		else lift.moveVoltage(0);
 
 		// flipout routine
-		if (flipoutBtn.changedToPressed()) flipout();
+		if (flipoutBtn.changedToPressed()) {
+			flipout();
+			// flipout drove the motors itself
+			lift.invalidate();
+			intake.invalidate();
+		}
 
 		// advanced intake control, with goal-oriented assists
 
@@ -1029,23 +1478,23 @@ void opcontrol() {
 
 		if (cubesPositioning) {
 			if (cubeState == cubeStates::settingCovered) {
-				if (abs(intakeMotors.getPositionError()) <= 20) { // we finished setting the cube
+				if (abs(sense.intakePositionError) <= 20) { // we finished setting the cube
 					cubeState = cubeStates::finished;
 					cubesPositioning = 0;
 					if (cubeDebug) std::cout << pros::millis() << ": cubeState finished" << std::endl;
 				} 
 			}
-			else if (line.get_value_calibrated_HR() < 46000) { // if we are already covering, move up to uncover
+			else if (cube.isCovered()) { // if we are already covering, move up to uncover
 				if (cubeState == cubeStates::setting) { // this means we have found cube position, so we must move it to its final position
-					intakeMotors.moveRelative(-280, 100);
+					intake.moveRelative(-280, 100);
 					cubeState = cubeStates::settingCovered;
 					if (cubeDebug) std::cout << pros::millis() << ": cubeState settingCovered" << std::endl;
 				}
-				else intakeMotors.moveVelocity(100);
+				else intake.moveVelocity(100);
 				if (cubeDebug) std::cout << pros::millis() << ": cubeState uncovering" << std::endl;
 			}
 			else { // if we arent covering the sensor and we arent setting the final position
-				intakeMotors.moveVelocity(-100);
+				intake.moveVelocity(-100);
 				cubeState = cubeStates::setting;
 				if (cubeDebug) std::cout << pros::millis() << ": cubeState setting" << std::endl;
 			}
@@ -1053,78 +1502,78 @@ void opcontrol() {
 
 		// user controlled intake only enabled while returned
 		if (trayState == trayStates::returned and not shift.isPressed()) { // if nothing else is controlling the intake and we arent moving the tray
-			if (intakeIn.isPressed() and not intakeOut.isPressed() and liftMotor.getPosition() > LIFT_STACKING_HEIGHT) intakeMotors.moveVelocity(100); // if we are dumping into tower, redue intake velocity as not to shoot the cube halfway accross the field
-			else if (intakeIn.isPressed() and not intakeOut.isPressed()) intakeMotors.moveVelocity(200);
-			else if (intakeOut.isPressed() and liftMotor.getPosition() > LIFT_STACKING_HEIGHT) intakeMotors.moveVelocity(-100);
-			else if (intakeOut.isPressed() or (intakeShift.isPressed() and liftMotor.getPosition() > LIFT_STACKING_HEIGHT)) intakeMotors.moveVelocity(-200);
-			else if (not cubesPositioning) intakeMotors.moveVoltage(0);
+			if (intakeIn.isPressed() and not intakeOut.isPressed() and sense.liftPosition > LIFT_STACKING_HEIGHT) intake.moveVelocity(100); // if we are dumping into tower, redue intake velocity as not to shoot the cube halfway accross the field
+			else if (intakeIn.isPressed() and not intakeOut.isPressed()) intake.moveVelocity(200);
+			else if (intakeOut.isPressed() and sense.liftPosition > LIFT_STACKING_HEIGHT) intake.moveVelocity(-100);
+			else if (intakeOut.isPressed() or (intakeShift.isPressed() and sense.liftPosition > LIFT_STACKING_HEIGHT)) intake.moveVelocity(-200);
+			else if (not cubesPositioning) intake.moveVoltage(0);
 		}
 		
 		// advanced tray control, also with goal-oriented assists
 		if (trayReturn.changedToPressed()) { // manual tray toggle requests, this is highest priority control
 			if (trayState == trayStates::returned) { // if we are already returned, move the tray out
-				trayMotor.moveAbsolute(6300, 90);
+				tray.moveAbsolute(6300, 90);
 				trayState = trayStates::extending;
 			}
 			else { // return to default tray position
-				trayMotor.moveAbsolute(0, 100);
+				tray.moveAbsolute(0, 100);
 				trayState = trayStates::returning;
 			}
 		}
 		else if (trayReturnAlt.changedToPressed()) { // a slower, further tray movement for high stacks
 			if (trayState == trayStates::returned) { // if we are already returned, move the tray out
-				trayMotor.moveAbsolute(6600, 65);
+				tray.moveAbsolute(6600, 65);
 				trayState = trayStates::extending;
 			}
 			else { // return to default tray position
-				trayMotor.moveAbsolute(0, 100);
+				tray.moveAbsolute(0, 100);
 				trayState = trayStates::returning;
 			}
 		}
 
 		// update trayState
-		if (trayMotor.getPosition() <= 100 and abs(trayMotor.getActualVelocity()) <= 5 and trayState != trayStates::extending) trayState = trayStates::returned; // let functions know if weve returned
-		else if (trayMotor.getPosition() >= 6000) trayState = trayStates::returning;
+		if (sense.trayPosition <= 100 and abs(sense.trayVelocity) <= 5 and trayState != trayStates::extending) trayState = trayStates::returned; // let functions know if weve returned
+		else if (sense.trayPosition >= 6000) trayState = trayStates::returning;
 
 		// tray control using shift key
 		if (trayState == trayStates::returned) {
 			if (shift.isPressed()) {
-				if (intakeIn.isPressed()) traySlew(true);
-				else if (intakeOut.isPressed()) traySlew(false);
-				else trayMotor.moveVoltage(0);
+				if (intakeIn.isPressed()) traySlew(tray, true);
+				else if (intakeOut.isPressed()) traySlew(tray, false);
+				else tray.moveVoltage(0);
 			}
 			// adjust tray based on lift position
-			else if (liftMotor.getPosition() > LIFT_STACKING_HEIGHT) trayMotor.moveAbsolute(600, 100);
-			else if (liftMotor.getPosition() <= LIFT_STACKING_HEIGHT and trayMotor.getPosition() <= 600) trayMotor.moveAbsolute(0, 100);
-			else trayMotor.moveVoltage(0);
+			else if (sense.liftPosition > LIFT_STACKING_HEIGHT) tray.moveAbsolute(600, 100);
+			else if (sense.liftPosition <= LIFT_STACKING_HEIGHT and sense.trayPosition <= 600) tray.moveAbsolute(0, 100);
+			else tray.moveVoltage(0);
 		}
 
 		// tray stacking mods
 		switch (trayState) {
 			case trayStates::returned:
-				intakeMotors.setBrakeMode(AbstractMotor::brakeMode::hold);
-				chassis->getModel()->setBrakeMode(AbstractMotor::brakeMode::coast);
+				intake.setBrakeMode(AbstractMotor::brakeMode::hold);
+				drive.setBrakeMode(AbstractMotor::brakeMode::coast);
 				if (trayDebug) std::cout << pros::millis() << ": trayState returned" << std::endl;
 				break;
 			case trayStates::returning:
-				if (intakeIn.isPressed() and not intakeOut.isPressed()) intakeMotors.moveVelocity(200);
-				else if (intakeOut.isPressed() or (intakeShift.isPressed())) intakeMotors.moveVelocity(-200);
-				else if (joystickAvg > 0) intakeMotors.moveVoltage(0);
-				else intakeMotors.moveVelocity((joystickAvg*350));
-				intakeMotors.setBrakeMode(AbstractMotor::brakeMode::hold);
-				chassis->getModel()->setBrakeMode(AbstractMotor::brakeMode::coast);
+				if (intakeIn.isPressed() and not intakeOut.isPressed()) intake.moveVelocity(200);
+				else if (intakeOut.isPressed() or (intakeShift.isPressed())) intake.moveVelocity(-200);
+				else if (joystickAvg > 0) intake.moveVoltage(0);
+				else intake.moveVelocity((joystickAvg*350));
+				intake.setBrakeMode(AbstractMotor::brakeMode::hold);
+				drive.setBrakeMode(AbstractMotor::brakeMode::coast);
 				if (trayDebug) std::cout << pros::millis() << ": trayState returning" << std::endl;
 				break;
 			case trayStates::extending:
-				liftMotor.moveAbsolute(-150, 100);
-				intakeMotors.setBrakeMode(AbstractMotor::brakeMode::coast);
-				chassis->getModel()->setBrakeMode(AbstractMotor::brakeMode::hold);
+				lift.moveAbsolute(-150, 100);
+				intake.setBrakeMode(AbstractMotor::brakeMode::coast);
+				drive.setBrakeMode(AbstractMotor::brakeMode::hold);
 
 				// the other intake control will not be used while we are stacking, all control is transfered to this block
 				if (not shift.isPressed() and not shift.changedToReleased()) {
-					if (intakeIn.isPressed()) intakeMotors.moveVelocity(50);
-					else if (intakeOut.isPressed() or intakeShift.isPressed()) intakeMotors.moveVelocity(-50); // two ways to move stack down slowly
-					else intakeMotors.moveVoltage(0);
+					if (intakeIn.isPressed()) intake.moveVelocity(50);
+					else if (intakeOut.isPressed() or intakeShift.isPressed()) intake.moveVelocity(-50); // two ways to move stack down slowly
+					else intake.moveVoltage(0);
 				}
 				if (trayDebug) std::cout << pros::millis() << ": trayState extending" << std::endl;
 				break;
@@ -1133,18 +1582,30 @@ void opcontrol() {
 		}
 
 		// lift brake mod
-		if (liftMotor.getPosition() > LIFT_STACKING_HEIGHT) liftMotor.setBrakeMode(AbstractMotor::brakeMode::brake);
-		else liftMotor.setBrakeMode(AbstractMotor::brakeMode::brake);
+		if (sense.liftPosition > LIFT_STACKING_HEIGHT) lift.setBrakeMode(AbstractMotor::brakeMode::brake);
+		else lift.setBrakeMode(AbstractMotor::brakeMode::brake);
 
-		chassis->getModel()->tank(masterController.getAnalog(ControllerAnalog::leftY),
-								masterController.getAnalog(ControllerAnalog::rightY));
+		drive.tank(sense.leftY, sense.rightY);
 
 
 		// update vals
-		joystickAvg = (masterController.getAnalog(ControllerAnalog::leftY) + (masterController.getAnalog(ControllerAnalog::rightY)) / 2);
+		joystickAvg = (sense.leftY + (sense.rightY) / 2);
+
+		// send it all
+		lift.flush();
+		tray.flush();
+		intake.flush();
+		drive.flush();
 
 		// debug
-		// std::cout << pros::millis() << ": line " << line.get_value_calibrated_HR() << std::endl;
+		if (writeDebug and ++loops % 250 == 0) {
+			lift.print();
+			tray.print();
+			intake.print();
+			drive.print();
+		}
+		// std::cout << pros::millis() << ": line " << cube.getValue() << std::endl;
+		// std::cout << pros::millis() << ": sensors " << sense.age() << "ms old" << std::endl;
 		// std::cout << pros::millis() << ": imu " << imu.get_heading() << std::endl;
 		// std::cout << pros::millis() << ": lef " << trackingLeft.get_value() << std::endl;
 		// std::cout << pros::millis() << ": rig " << trackingRight.get_value() << std::endl;
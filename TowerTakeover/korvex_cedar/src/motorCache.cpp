@@ -0,0 +1,137 @@
+#include "motorCache.hpp"
+
+MotorCache::MotorCache(okapi::AbstractMotor &imotor, const char *iname) : motor(imotor), name(iname) {
+}
+
+void MotorCache::moveVelocity(std::int16_t ivelocity) {
+	queue({Mode::velocity, double(ivelocity), 0});
+}
+
+void MotorCache::moveVoltage(std::int16_t ivoltage) {
+	queue({Mode::voltage, double(ivoltage), 0});
+}
+
+void MotorCache::moveAbsolute(double iposition, std::int32_t ivelocity) {
+	queue({Mode::absolute, iposition, ivelocity});
+}
+
+void MotorCache::moveRelative(double iposition, std::int32_t ivelocity) {
+	queue({Mode::relative, iposition, ivelocity});
+}
+
+void MotorCache::setBrakeMode(okapi::AbstractMotor::brakeMode imode) {
+	count.asked++;
+	pendingBrake = imode;
+}
+
+void MotorCache::queue(const Command &icommand) {
+	count.asked++;
+	pending = icommand;
+	movePending = true;
+}
+
+// a relative move is never the same as the last one, the motor's already somewhere else
+bool MotorCache::same(const Command &ia, const Command &ib) {
+	return ia.mode == ib.mode and ia.mode != Mode::relative and ia.target == ib.target and ia.velocity == ib.velocity;
+}
+
+void MotorCache::flush() {
+	// every refresh ms what it already has goes out again anyway, a motor that dropped off and came back has forgotten it
+	const std::uint32_t now = pros::millis();
+	const bool stale = now - sentTime >= refresh;
+	if (movePending and !same(pending, sent)) send(pending);
+	else if (stale and sent.mode != Mode::none and sent.mode != Mode::relative) send(sent);
+	movePending = false;
+
+	if (pendingBrake != okapi::AbstractMotor::brakeMode::invalid and pendingBrake != sentBrake) {
+		motor.setBrakeMode(pendingBrake);
+		sentBrake = pendingBrake;
+		count.sent++;
+	}
+	else if (stale and sentBrake != okapi::AbstractMotor::brakeMode::invalid) {
+		motor.setBrakeMode(sentBrake);
+		count.sent++;
+	}
+	pendingBrake = okapi::AbstractMotor::brakeMode::invalid;
+	if (stale) sentTime = now;
+}
+
+void MotorCache::send(const Command &icommand) {
+	switch (icommand.mode) {
+		case Mode::velocity: motor.moveVelocity(icommand.target); break;
+		case Mode::voltage: motor.moveVoltage(icommand.target); break;
+		case Mode::absolute: motor.moveAbsolute(icommand.target, icommand.velocity); break;
+		case Mode::relative: motor.moveRelative(icommand.target, icommand.velocity); break;
+		default: break;
+	}
+	sent = icommand;
+	count.sent++;
+}
+
+void MotorCache::invalidate() {
+	sent = Command();
+	sentBrake = okapi::AbstractMotor::brakeMode::invalid;
+}
+
+WriteCount MotorCache::getCount() const {
+	return count;
+}
+
+void MotorCache::print() const {
+	std::cout << pros::millis() << ": writes " << name << " sent " << count.sent << " saved " << count.saved() << std::endl;
+}
+
+ChassisCache::ChassisCache(std::shared_ptr<okapi::ChassisModel> imodel, const char *iname) : model(std::move(imodel)), name(iname) {
+}
+
+void ChassisCache::tank(double ileft, double iright) {
+	count.asked++;
+	pendingLeft = ileft;
+	pendingRight = iright;
+	tankPending = true;
+}
+
+void ChassisCache::setBrakeMode(okapi::AbstractMotor::brakeMode imode) {
+	count.asked++;
+	pendingBrake = imode;
+}
+
+void ChassisCache::flush() {
+	const std::uint32_t now = pros::millis();
+	const bool stale = now - sentTime >= MotorCache::refresh;
+	if ((tankPending and !(tankSent and pendingLeft == sentLeft and pendingRight == sentRight)) or (stale and tankSent)) {
+		if (tankPending) {
+			sentLeft = pendingLeft;
+			sentRight = pendingRight;
+		}
+		model->tank(sentLeft, sentRight);
+		tankSent = true;
+		count.sent++;
+	}
+	tankPending = false;
+
+	if (pendingBrake != okapi::AbstractMotor::brakeMode::invalid and pendingBrake != sentBrake) {
+		model->setBrakeMode(pendingBrake);
+		sentBrake = pendingBrake;
+		count.sent++;
+	}
+	else if (stale and sentBrake != okapi::AbstractMotor::brakeMode::invalid) {
+		model->setBrakeMode(sentBrake);
+		count.sent++;
+	}
+	pendingBrake = okapi::AbstractMotor::brakeMode::invalid;
+	if (stale) sentTime = now;
+}
+
+void ChassisCache::invalidate() {
+	tankSent = false;
+	sentBrake = okapi::AbstractMotor::brakeMode::invalid;
+}
+
+WriteCount ChassisCache::getCount() const {
+	return count;
+}
+
+void ChassisCache::print() const {
+	std::cout << pros::millis() << ": writes " << name << " sent " << count.sent << " saved " << count.saved() << std::endl;
+}
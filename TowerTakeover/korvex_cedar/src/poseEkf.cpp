@@ -0,0 +1,161 @@
+#include "poseEkf.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr float gravity = 980.665; // cm/s^2 in a g
+constexpr float radiansPerDegree = M_PI / 180;
+
+float square(float ix) {
+	return ix * ix;
+}
+} // namespace
+
+PoseEkf::PoseEkf(const EkfConfig &iconfig) : config(iconfig) {
+}
+
+void PoseEkf::update(const OdomReading &ireading) {
+	const bool imuOk = std::isfinite(ireading.rotation) and std::isfinite(ireading.gyro);
+	if (!primed) {
+		last = ireading;
+		primed = true;
+		if (imuOk) imuOffset = state[theta] - ireading.rotation * radiansPerDegree;
+		imuLined = imuOk;
+		return;
+	}
+	const float dt = (ireading.time - last.time) / 1000.0f;
+	if (dt <= 0) return; // same ms as last time, the ticks keep till next update
+
+	const float deltaLeft = (ireading.left - last.left) * config.cmPerTick;
+	const float deltaRight = (ireading.right - last.right) * config.cmPerTick;
+	const float deltaStrafe = (ireading.strafe - last.strafe) * config.cmPerTick;
+	const bool driveOk = std::isfinite(ireading.driveLeft) and std::isfinite(ireading.driveRight) and std::isfinite(last.driveLeft) and std::isfinite(last.driveRight);
+	const float deltaDriveLeft = (ireading.driveLeft - last.driveLeft) * config.driveCmPerTick;
+	const float deltaDriveRight = (ireading.driveRight - last.driveRight) * config.driveCmPerTick;
+	const bool accelOk = std::isfinite(ireading.accelX) and std::isfinite(ireading.accelY);
+	last = ireading;
+	rejected = 0;
+
+	// the imu came up after we started (still calibrating at setPose), line it up with where we've got to
+	if (imuOk and !imuLined) {
+		imuOffset = state[theta] - ireading.rotation * radiansPerDegree;
+		imuLined = true;
+	}
+
+	predict(dt, accelOk ? ireading.accelX * gravity : 0, accelOk ? ireading.accelY * gravity : 0);
+
+	// each wheel rolls the robot's forward speed plus whatever the turn does to it out where it sits
+	// the tracking wheels are what everything else gets checked against so they never get gated, hitting a wall
+	// they're the only thing that knows we stopped
+	const EkfNoise &noise = config.noise;
+	if (noise.trackingWheel > 0) {
+		fuse(deltaLeft, forward, dt, spin, -config.leftOffset * dt, noise.trackingWheel, false);
+		fuse(deltaRight, forward, dt, spin, -config.rightOffset * dt, noise.trackingWheel, false);
+		fuse(deltaStrafe, sideways, -dt, spin, -config.strafeOffset * dt, noise.trackingWheel, false); // counts up going left
+	}
+	if (noise.driveWheel > 0 and driveOk) {
+		if (!fuse(deltaDriveLeft, forward, dt, spin, config.driveOffset * dt, noise.driveWheel, true)) rejected |= leftDrive;
+		if (!fuse(deltaDriveRight, forward, dt, spin, -config.driveOffset * dt, noise.driveWheel, true)) rejected |= rightDrive;
+	}
+	// the imu doesn't slip, so it never gets gated, if it did a long drift could get it locked out for good
+	if (imuOk) {
+		if (noise.gyro > 0) fuse(ireading.gyro * radiansPerDegree, spin, 1, spin, 0, noise.gyro, false);
+		if (noise.imuHeading > 0) fuse(ireading.rotation * radiansPerDegree + imuOffset, theta, 1, theta, 0, noise.imuHeading, false);
+	}
+
+	// float rounding in transform() leaves it a hair off symmetric, which adds up
+	for (int r = 0; r < size; r++) {
+		for (int c = r + 1; c < size; c++) covariance[r][c] = covariance[c][r] = (covariance[r][c] + covariance[c][r]) / 2;
+	}
+}
+
+void PoseEkf::predict(float idt, float iaccelForward, float iaccelSideways) {
+	// the accelerometer feels the turn as well (forward speed times spin, sideways), take that out for how the robot's own velocities change
+	const float v = state[forward], s = state[sideways], w = state[spin];
+	Matrix jacobian = identity();
+	jacobian[forward][sideways] = w * idt;
+	jacobian[forward][spin] = s * idt;
+	jacobian[sideways][forward] = -w * idt;
+	jacobian[sideways][spin] = -v * idt;
+	state[forward] = v + (iaccelForward + w * s) * idt;
+	state[sideways] = s + (iaccelSideways - w * v) * idt;
+	transform(jacobian);
+	covariance[forward][forward] += square(config.noise.acceleration * idt);
+	covariance[sideways][sideways] += square(config.noise.acceleration * idt);
+	covariance[spin][spin] += square(config.noise.angularAcceleration * idt);
+
+	// then the pose moves by those, pointing halfway through the turn
+	const float heading = state[theta] + state[spin] * idt / 2;
+	const float cosine = std::cos(heading), sine = std::sin(heading);
+	const float deltaX = (state[forward] * cosine - state[sideways] * sine) * idt;
+	const float deltaY = (state[forward] * sine + state[sideways] * cosine) * idt;
+	jacobian = identity();
+	jacobian[x][theta] = -deltaY;
+	jacobian[x][forward] = cosine * idt;
+	jacobian[x][sideways] = -sine * idt;
+	jacobian[x][spin] = -deltaY * idt / 2;
+	jacobian[y][theta] = deltaX;
+	jacobian[y][forward] = sine * idt;
+	jacobian[y][sideways] = cosine * idt;
+	jacobian[y][spin] = deltaX * idt / 2;
+	jacobian[theta][spin] = idt;
+	state[x] += deltaX;
+	state[y] += deltaY;
+	state[theta] += state[spin] * idt;
+	transform(jacobian);
+}
+
+PoseEkf::Matrix PoseEkf::identity() {
+	Matrix out{};
+	for (int i = 0; i < size; i++) out[i][i] = 1;
+	return out;
+}
+
+void PoseEkf::transform(const Matrix &ijacobian) {
+	Matrix half{};
+	for (int r = 0; r < size; r++)
+		for (int k = 0; k < size; k++) {
+			if (ijacobian[r][k] == 0) continue; // mostly identity, skip the zeros
+			for (int c = 0; c < size; c++) half[r][c] += ijacobian[r][k] * covariance[k][c];
+		}
+	for (int r = 0; r < size; r++)
+		for (int c = 0; c < size; c++) {
+			float sum = 0;
+			for (int k = 0; k < size; k++) sum += half[r][k] * ijacobian[c][k];
+			covariance[r][c] = sum;
+		}
+}
+
+bool PoseEkf::fuse(float imeasurement, int i, float hi, int j, float hj, float inoise, bool igated) {
+	std::array<float, size> spread; // covariance times the measurement row
+	for (int k = 0; k < size; k++) spread[k] = covariance[k][i] * hi + covariance[k][j] * hj;
+	const float innovation = imeasurement - (hi * state[i] + hj * state[j]);
+	const float variance = hi * spread[i] + hj * spread[j] + inoise * inoise;
+	if (igated and innovation * innovation > square(config.noise.gate) * variance) return false;
+	for (int k = 0; k < size; k++) state[k] += spread[k] / variance * innovation;
+	for (int r = 0; r < size; r++)
+		for (int c = 0; c < size; c++) covariance[r][c] -= spread[r] * spread[c] / variance;
+	return true;
+}
+
+void PoseEkf::setPose(float ix, float iy, float itheta) {
+	state[x] = ix;
+	state[y] = iy;
+	state[theta] = itheta;
+	for (int i : {x, y, theta})
+		for (int k = 0; k < size; k++) covariance[i][k] = covariance[k][i] = 0;
+	imuLined = primed and std::isfinite(last.rotation);
+	if (imuLined) imuOffset = itheta - last.rotation * radiansPerDegree;
+}
+
+EkfState PoseEkf::getState() const {
+	return {state[x], state[y], state[theta], state[forward], state[sideways], state[spin]};
+}
+
+float PoseEkf::getPositionError() const {
+	return std::sqrt(std::max(0.0f, covariance[x][x] + covariance[y][y]));
+}
+
+std::uint8_t PoseEkf::getRejected() const {
+	return rejected;
+}
@@ -0,0 +1,165 @@
+#include "purePursuit.hpp"
+#include <algorithm>
+#include <cmath>
+
+PursuitPath::PursuitPath(const std::vector<okapi::OdomState> &iwaypoints, const PursuitLimits &ilimits) : pathLimits(ilimits) {
+	// the spline, sampled finely enough that straight lines between the samples are as good as the curve
+	std::vector<std::pair<float, float>> dense;
+	for (std::size_t n = 0; n + 1 < iwaypoints.size(); n++) {
+		const float x0 = iwaypoints[n].x.convert(okapi::centimeter), y0 = iwaypoints[n].y.convert(okapi::centimeter);
+		const float x1 = iwaypoints[n + 1].x.convert(okapi::centimeter), y1 = iwaypoints[n + 1].y.convert(okapi::centimeter);
+		const float theta0 = iwaypoints[n].theta.convert(okapi::radian), theta1 = iwaypoints[n + 1].theta.convert(okapi::radian);
+		const float scale = std::hypot(x1 - x0, y1 - y0); // tangents as long as the segment, about what pathfinder does
+		const int steps = std::max(20, int(scale / 0.5f));
+		for (int step = n ? 1 : 0; step <= steps; step++) {
+			const float t = float(step) / steps, t2 = t * t, t3 = t2 * t;
+			const float h00 = 2 * t3 - 3 * t2 + 1, h10 = t3 - 2 * t2 + t, h01 = -2 * t3 + 3 * t2, h11 = t3 - t2;
+			dense.push_back({h00 * x0 + h10 * scale * std::cos(theta0) + h01 * x1 + h11 * scale * std::cos(theta1),
+			                 h00 * y0 + h10 * scale * std::sin(theta0) + h01 * y1 + h11 * scale * std::sin(theta1)});
+		}
+	}
+	if (dense.empty() && !iwaypoints.empty()) dense.push_back({iwaypoints[0].x.convert(okapi::centimeter), iwaypoints[0].y.convert(okapi::centimeter)});
+	if (dense.empty()) return;
+
+	// evenly spaced points along it
+	points.push_back({dense[0].first, dense[0].second, 0, 0, 0});
+	float along = 0; // cm walked since the last point we kept
+	for (std::size_t i = 1; i < dense.size(); i++) {
+		float x = dense[i - 1].first, y = dense[i - 1].second;
+		const float dx = dense[i].first - x, dy = dense[i].second - y;
+		const float segment = std::hypot(dx, dy);
+		float used = 0;
+		while (along + segment - used >= pathLimits.spacing) {
+			used += pathLimits.spacing - along;
+			along = 0;
+			points.push_back({x + dx * used / segment, y + dy * used / segment, points.back().distance + pathLimits.spacing, 0, 0});
+		}
+		along += segment - used;
+	}
+	const auto &end = dense.back();
+	if (along > 1e-3f) points.push_back({end.first, end.second, points.back().distance + along, 0, 0});
+
+	// curvature from the circle through each point and its neighbours
+	for (std::size_t i = 1; i + 1 < points.size(); i++) {
+		const Sample &a = points[i - 1], &b = points[i], &c = points[i + 1];
+		const float ab = std::hypot(b.x - a.x, b.y - a.y), bc = std::hypot(c.x - b.x, c.y - b.y), ca = std::hypot(a.x - c.x, a.y - c.y);
+		const float area2 = std::abs((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x));
+		points[i].curvature = ab * bc * ca > 1e-6f ? 2 * area2 / (ab * bc * ca) : 0;
+	}
+
+	// as fast as the corners allow, then ramp down into the end, followPath ramps up from a standstill itself
+	for (auto &point : points) {
+		point.velocity = point.curvature > 1e-6f ? std::min(pathLimits.maxVelocity, pathLimits.turnK / point.curvature) : pathLimits.maxVelocity;
+		point.velocity = std::max(point.velocity, pathLimits.minVelocity);
+	}
+	points.back().velocity = pathLimits.minVelocity;
+	for (std::size_t i = points.size() - 1; i-- > 0;) {
+		const float ds = points[i + 1].distance - points[i].distance;
+		points[i].velocity = std::min(points[i].velocity, std::sqrt(points[i + 1].velocity * points[i + 1].velocity + 2 * pathLimits.maxAccel * ds));
+	}
+}
+
+const std::vector<PursuitPath::Sample> &PursuitPath::samples() const {
+	return points;
+}
+
+const PursuitLimits &PursuitPath::limits() const {
+	return pathLimits;
+}
+
+float PursuitPath::length() const {
+	return points.empty() ? 0 : points.back().distance;
+}
+
+PurePursuit::PurePursuit(const PursuitPath &ipath, float iminLookahead, float imaxLookahead)
+	: path(ipath), minLookahead(iminLookahead), maxLookahead(imaxLookahead) {
+}
+
+void PurePursuit::reset() {
+	closest = 0;
+	lookahead = 0;
+}
+
+bool PurePursuit::findLookahead(float x, float y, float iradius, float &ox, float &oy) {
+	const auto &points = path.samples();
+	const std::size_t start = std::max<std::size_t>(std::size_t(lookahead), closest);
+	// the lookahead point can't be much more than 2 radii of path past where we are, so that's as far as we look
+	const std::size_t stop = std::min(points.size() - 1, start + std::size_t(2 * iradius / path.limits().spacing) + 2);
+	for (std::size_t i = start; i < stop; i++) {
+		const float dx = points[i + 1].x - points[i].x, dy = points[i + 1].y - points[i].y;
+		const float fx = points[i].x - x, fy = points[i].y - y;
+		const float a = dx * dx + dy * dy, b = 2 * (fx * dx + fy * dy), c = fx * fx + fy * fy - iradius * iradius;
+		const float discriminant = b * b - 4 * a * c;
+		if (a < 1e-9f || discriminant < 0) continue;
+		const float t = (-b + std::sqrt(discriminant)) / (2 * a); // where the segment leaves the circle
+		if (t < 0 || t > 1 || i + t < lookahead) continue;
+		lookahead = i + t;
+		ox = points[i].x + t * dx;
+		oy = points[i].y + t * dy;
+		return true;
+	}
+	return false;
+}
+
+PurePursuit::Output PurePursuit::step(float x, float y, float theta) {
+	const auto &points = path.samples();
+	Output output{0, 0, 0, 0, true};
+	if (points.empty()) return output;
+	const auto distance2 = [&](std::size_t i) { return std::pow(points[i].x - x, 2) + std::pow(points[i].y - y, 2); };
+
+	// closest point, walking forward while the next one is closer
+	while (closest + 1 < points.size() && distance2(closest + 1) <= distance2(closest)) closest++;
+	const PursuitPath::Sample &here = points[closest];
+	const PursuitPath::Sample &end = points.back();
+
+	// slow parts of the path get a short lookahead so corners are followed tightly
+	const PursuitLimits &limits = path.limits();
+	const float speed = (here.velocity - limits.minVelocity) / std::max(1e-3f, limits.maxVelocity - limits.minVelocity);
+	const float radius = minLookahead + (maxLookahead - minLookahead) * std::max(0.0f, std::min(1.0f, speed));
+
+	float lookX, lookY;
+	output.endError = std::sqrt(distance2(points.size() - 1));
+	if (!findLookahead(x, y, radius, lookX, lookY)) {
+		if (output.endError < radius || lookahead >= points.size() - 1) {
+			// run out of path, carry it on straight past the end so we come in lined up with it instead of swerving at the end point
+			lookahead = points.size() - 1;
+			lookX = end.x;
+			lookY = end.y;
+			if (points.size() > 1) {
+				const PursuitPath::Sample &before = points[points.size() - 2];
+				const float ux = (end.x - before.x) / std::max(1e-6f, end.distance - before.distance);
+				const float uy = (end.y - before.y) / std::max(1e-6f, end.distance - before.distance);
+				const float fx = end.x - x, fy = end.y - y;
+				const float b = fx * ux + fy * uy, c = fx * fx + fy * fy - radius * radius;
+				if (b * b - c >= 0) {
+					const float t = std::max(0.0f, -b + std::sqrt(b * b - c));
+					lookX += t * ux;
+					lookY += t * uy;
+				}
+			}
+		}
+		else { // knocked off the path further than the lookahead reaches, head back to the last lookahead point
+			const std::size_t i = std::max<std::size_t>(std::size_t(lookahead), closest);
+			const float t = std::max(0.0f, lookahead - i);
+			lookX = points[i].x + (i + 1 < points.size() ? t * (points[i + 1].x - points[i].x) : 0);
+			lookY = points[i].y + (i + 1 < points.size() ? t * (points[i + 1].y - points[i].y) : 0);
+		}
+	}
+
+	// the arc from the robot through the lookahead point
+	const float dx = lookX - x, dy = lookY - y;
+	const float lateral = -std::sin(theta) * dx + std::cos(theta) * dy; // cm to the right of the robot
+	const float chord2 = dx * dx + dy * dy;
+	output.curvature = chord2 > 1e-6f ? 2 * lateral / chord2 : 0;
+	output.velocity = here.velocity;
+	output.travelled = here.distance;
+
+	// done once we're on the end point or have driven past it
+	bool past = false;
+	if (points.size() > 1 && closest + 2 >= points.size()) {
+		const PursuitPath::Sample &before = points[points.size() - 2];
+		past = (end.x - x) * (end.x - before.x) + (end.y - y) * (end.y - before.y) <= 0;
+	}
+	output.done = output.endError < 2 || past;
+	return output;
+}
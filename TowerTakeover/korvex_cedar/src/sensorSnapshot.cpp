@@ -0,0 +1,21 @@
+#include "sensorSnapshot.hpp"
+
+SensorSampler::SensorSampler(okapi::Motor &ilift, okapi::Motor &itray, okapi::MotorGroup &iintake, okapi::Controller &icontroller)
+	: lift(ilift), tray(itray), intake(iintake), controller(icontroller) {
+}
+
+const SensorSnapshot &SensorSampler::sample() {
+	snapshot.time = pros::millis();
+	snapshot.liftPosition = lift.getPosition();
+	snapshot.liftEfficiency = lift.getEfficiency();
+	snapshot.trayPosition = tray.getPosition();
+	snapshot.trayVelocity = tray.getActualVelocity();
+	snapshot.intakePositionError = intake.getPositionError();
+	snapshot.leftY = controller.getAnalog(okapi::ControllerAnalog::leftY);
+	snapshot.rightY = controller.getAnalog(okapi::ControllerAnalog::rightY);
+	return snapshot;
+}
+
+const SensorSnapshot &SensorSampler::get() const {
+	return snapshot;
+}
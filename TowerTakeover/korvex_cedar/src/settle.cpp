@@ -0,0 +1,57 @@
+#include "settle.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+const char *settleReasonName(SettleReason ireason) {
+	switch (ireason) {
+	case SettleReason::running: return "running";
+	case SettleReason::settled: return "settled";
+	case SettleReason::stalled: return "stalled";
+	case SettleReason::timedOut: return "timed out";
+	case SettleReason::cancelled: return "cancelled";
+	}
+	return "?";
+}
+
+// SettledUtil's own derivative check is per call so it'd change with the loop time, we hand it DBL_MAX and check real velocity instead
+SettleDetector::SettleDetector(const SettleBands &ibands)
+	: bands(ibands),
+	  settled(okapi::TimeUtilFactory::withSettledUtilParams(ibands.error, DBL_MAX, ibands.dwell * okapi::millisecond).getSettledUtil()),
+	  startTime(pros::millis()),
+	  lastTime(startTime) {
+}
+
+bool SettleDetector::update(float ierror, float ivelocity, bool icancelled, bool isaturated) {
+	// a tick of tracking wheel in a 20ms loop is 3cm/s, so smooth it out or a robot dithering on the spot never looks stopped
+	const std::uint32_t now = pros::millis();
+	velocity += (ivelocity - velocity) * std::min(1.0f, (now - lastTime) / velocitySmoothing);
+	lastTime = now;
+
+	// moving means outside the error band as far as settled is concerned, so the dwell starts over
+	const bool inBand = settled->isSettled(std::abs(velocity) > bands.velocity ? DBL_MAX : std::abs(ierror));
+
+	// over the last stall ms we have to have closed in at least progress fast, creeping or rocking on the spot doesn't count
+	// inside the error band we're just waiting out the dwell
+	history.push_back({now, std::abs(ierror)});
+	while (history.size() > 1 and now - history[1].first >= (std::uint32_t)bands.stall) history.pop_front();
+	// and only close in, a stall further out that isn't pushing flat out is the gains being too soft and waits for the timeout
+	// nor while it's still swinging through an overshoot, that's moving and the error just hasn't come down over the window
+	const bool stalled = now - history.front().first >= (std::uint32_t)bands.stall and std::abs(ierror) > bands.error
+		and (std::abs(ierror) <= bands.stallError or isaturated) and std::abs(velocity) <= bands.velocity
+		and history.front().second - std::abs(ierror) < bands.progress * (now - history.front().first) / 1000;
+
+	if (icancelled) exitReason = SettleReason::cancelled;
+	else if (inBand) exitReason = SettleReason::settled;
+	else if (stalled) exitReason = SettleReason::stalled;
+	else if (bands.timeout > 0 and now - startTime >= (std::uint32_t)bands.timeout) exitReason = SettleReason::timedOut;
+	return exitReason != SettleReason::running;
+}
+
+SettleReason SettleDetector::reason() const {
+	return exitReason;
+}
+
+const char *SettleDetector::reasonName() const {
+	return settleReasonName(exitReason);
+}
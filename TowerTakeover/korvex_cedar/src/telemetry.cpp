@@ -0,0 +1,179 @@
+#include "telemetry.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+struct ChannelInfo {
+	const char *name;
+	const char *fields;
+};
+
+// in Channel's order
+const ChannelInfo channels[Telemetry::channelCount] = {
+	{"driveP", "plan planVelocity left velocityLeft right velocityRight voltageLeft voltageRight"},
+	{"driveQ", "error errorTheta targetTheta voltageLeft voltageRight voltageMax start"}, // error goes negative once it's past
+	{"turnP", "error voltage voltageMax start"}, // start is the move's, so sim/tools/stepstats can tell them apart
+	{"waypoint", "n error errorTheta"},
+	{"passed waypoint", "n msIn"},
+	{"driveToPose", "error errorTheta errorFinal"},
+	{"followPath", "along curvature velocity"},
+	{"ramWall", "hit stopped slipLeft slipRight"},
+	{"odom", "left right strafe driveLeft driveRight rotation gyro accelX accelY"},
+	{"odom pose", "x y theta"},
+	{"contact", "impact slipLeft slipRight"}, // impact is g, 0 if it's just a slip starting
+	{"char quasistatic", "voltsLeft voltsRight velocityLeft velocityRight accelLeft accelRight spin"},
+	{"char dynamic", "voltsLeft voltsRight velocityLeft velocityRight accelLeft accelRight spin"},
+	{"char spin", "voltsLeft voltsRight velocityLeft velocityRight accelLeft accelRight spin"},
+};
+} // namespace
+
+Telemetry::Telemetry() {
+	for (std::uint32_t i = 0; i < size; i++) slots[i].sequence = i;
+}
+
+Telemetry &telemetry() {
+	static Telemetry instance;
+	return instance;
+}
+
+bool Telemetry::log(Channel ichannel, std::initializer_list<float> ivalues, std::uint32_t itime) {
+	// claim the next slot, if it hasn't been drained since last time round the ring is full
+	std::uint32_t position = writePosition.load(std::memory_order_relaxed);
+	Slot *slot;
+	while (true) {
+		slot = &slots[position % size];
+		const std::int32_t lag = std::int32_t(slot->sequence.load(std::memory_order_acquire) - position);
+		if (lag == 0) {
+			if (writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+		}
+		else if (lag < 0) {
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		else position = writePosition.load(std::memory_order_relaxed); // someone else got it first
+	}
+
+	TelemetryRecord &record = slot->record;
+	record.time = itime;
+	record.channel = ichannel;
+	record.count = std::min<std::size_t>(ivalues.size(), TelemetryRecord::maxValues);
+	std::copy_n(ivalues.begin(), record.count, record.values);
+	slot->sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+void Telemetry::start(std::FILE *iout, std::uint32_t iperiod) {
+	if (started) return;
+	out = iout;
+	period = iperiod;
+	started = true;
+	pros::c::task_create(loop, this, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "Telemetry");
+}
+
+void Telemetry::loop(void *itelemetry) {
+	Telemetry *telemetry = static_cast<Telemetry *>(itelemetry);
+	std::uint32_t wake = pros::millis();
+	while (true) {
+		telemetry->drain();
+		pros::Task::delay_until(&wake, telemetry->period);
+	}
+}
+
+void Telemetry::drain() {
+	bool wrote = false;
+	while (true) {
+		Slot &slot = slots[readPosition % size];
+		if (slot.sequence.load(std::memory_order_acquire) != readPosition + 1) break; // empty, or still being written
+		const TelemetryRecord record = slot.record;
+		slot.sequence.store(readPosition + size, std::memory_order_release); // free for the next time round
+		readPosition++;
+
+		if (record.channel >= channelCount) continue;
+		logRecord(record);
+		if (logFile and !echo) continue; // it's on the card, formatting it for the serial too is what we're avoiding
+		const ChannelInfo &channel = channels[record.channel];
+		if (!labelled[record.channel]) {
+			std::fprintf(out, "%u: %s fields %s\n", (unsigned)record.time, channel.name, channel.fields);
+			labelled[record.channel] = true;
+		}
+		std::fprintf(out, "%u: %s", (unsigned)record.time, channel.name);
+		for (int i = 0; i < record.count; i++) std::fprintf(out, " %g", record.values[i]);
+		std::fputc('\n', out);
+		wrote = true;
+	}
+
+	const std::uint32_t lost = dropped.load(std::memory_order_relaxed);
+	if (lost != droppedPrinted) {
+		std::fprintf(out, "%u: telemetry dropped %u\n", (unsigned)pros::millis(), (unsigned)(lost - droppedPrinted));
+		logRecord({pros::millis(), droppedChannel, 1, {float(lost - droppedPrinted)}});
+		droppedPrinted = lost;
+		wrote = true;
+	}
+	if (wrote) std::fflush(out);
+	if (flushWanted.exchange(false) or pros::millis() - blockTime >= 1000) writeBlock();
+}
+
+bool Telemetry::openLog(const char *idirectory) {
+	if (logFile or started) return false;
+	// the next number nobody's used, so every run gets its own file
+	char path[128];
+	for (int i = 0; i < 1000 and !logFile; i++) {
+		std::snprintf(path, sizeof(path), "%scedar%03d.tlm", idirectory, i);
+		std::FILE *existing = std::fopen(path, "rb");
+		if (existing) std::fclose(existing);
+		else logFile = std::fopen(path, "ab");
+	}
+	if (!logFile) return false;
+	std::setvbuf(logFile, nullptr, _IONBF, 0); // we do our own blocks
+
+	block[blockUsed++] = 'K';
+	block[blockUsed++] = 'V';
+	block[blockUsed++] = 'X';
+	block[blockUsed++] = 'T';
+	block[blockUsed++] = logVersion;
+	block[blockUsed++] = channelCount;
+	for (const ChannelInfo &channel : channels) {
+		for (const char *text : {channel.name, channel.fields}) {
+			const std::size_t length = std::strlen(text) + 1;
+			std::memcpy(&block[blockUsed], text, length);
+			blockUsed += length;
+		}
+	}
+	writeBlock();
+	std::cout << pros::millis() << ": telemetry log " << path << std::endl;
+	return true;
+}
+
+// the brain and the computer are both little endian so the bytes go as they are
+void Telemetry::logRecord(const TelemetryRecord &irecord) {
+	if (!logFile) return;
+	const std::size_t length = 6 + irecord.count * sizeof(float);
+	if (blockUsed + length > blockSize) writeBlock();
+	std::uint8_t *at = &block[blockUsed];
+	std::memcpy(at, &irecord.time, 4);
+	at[4] = irecord.channel;
+	at[5] = irecord.count;
+	std::memcpy(at + 6, irecord.values, irecord.count * sizeof(float));
+	blockUsed += length;
+}
+
+void Telemetry::flushLog() {
+	flushWanted = true;
+}
+
+void Telemetry::writeBlock() {
+	blockTime = pros::millis();
+	if (!logFile or !blockUsed) return;
+	std::fwrite(block.data(), 1, blockUsed, logFile);
+	std::fflush(logFile);
+	blockUsed = 0;
+}
+
+void Telemetry::setEcho(bool iecho) {
+	echo = iecho;
+}
+
+std::uint32_t Telemetry::getDropped() const {
+	return dropped;
+}
@@ -0,0 +1,139 @@
+#include "trackingOdometry.hpp"
+#include "telemetry.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+TrackingOdometry::TrackingOdometry(pros::ADIEncoder &ileft, pros::ADIEncoder &iright, pros::ADIEncoder &istrafe, pros::Imu &iimu, std::int8_t idriveLeft,
+                                   std::int8_t idriveRight, const EkfConfig &iconfig, const ContactConfig &icontact)
+	: left(ileft), right(iright), strafe(istrafe), imu(iimu), driveLeft(idriveLeft), driveRight(idriveRight), config(iconfig), ekf(iconfig), contact(iconfig, icontact) {
+}
+
+void TrackingOdometry::start(std::uint32_t iperiod) {
+	if (started) return;
+	period = iperiod;
+	const OdomReading reading = read();
+	update(reading);
+	publish(reading.time);
+	started = true;
+	pros::c::task_create(loop, this, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "TrackingOdometry");
+}
+
+void TrackingOdometry::loop(void *iodometry) {
+	TrackingOdometry *odometry = static_cast<TrackingOdometry *>(iodometry);
+	std::uint32_t wake = pros::millis();
+	while (true) {
+		odometry->step();
+		pros::Task::delay_until(&wake, odometry->period);
+	}
+}
+
+namespace {
+// okapi does its own reversing, so pros still counts a reversed motor backwards
+double drivePosition(std::int8_t iport) {
+	const double position = pros::c::motor_get_position(std::abs(iport));
+	return iport < 0 ? -position : position;
+}
+} // namespace
+
+// the imu and the motors read PROS_ERR_F while they're calibrating or unplugged, the filter leaves them out then
+OdomReading TrackingOdometry::read() const {
+	const pros::c::imu_gyro_s_t gyro = imu.get_gyro_rate();
+	const pros::c::imu_accel_s_t accel = imu.get_accel();
+	return {pros::millis(), left.get_value(), right.get_value(), strafe.get_value(), drivePosition(driveLeft), drivePosition(driveRight), imu.get_rotation(),
+	        gyro.z, accel.x, accel.y};
+}
+
+void TrackingOdometry::step() {
+	const OdomReading reading = read();
+	update(reading);
+	if (resetPending) {
+		const OdomPose to = reset.read();
+		ekf.setPose(to.x, to.y, to.theta);
+		if (logging) telemetry().log(Telemetry::odomPose, {to.x, to.y, to.theta}, reading.time);
+		resetPending = false;
+	}
+	publish(reading.time);
+}
+
+void TrackingOdometry::update(const OdomReading &ireading) {
+	if (logging) {
+		telemetry().log(Telemetry::odom, {float(ireading.left), float(ireading.right), float(ireading.strafe), float(ireading.driveLeft), float(ireading.driveRight),
+		                                  float(ireading.rotation), float(ireading.gyro), float(ireading.accelX), float(ireading.accelY)}, ireading.time);
+	}
+	ekf.update(ireading);
+
+	const ContactState before = contact.getState();
+	contact.update(ireading);
+	const ContactState after = contact.getState();
+	const bool hit = after.collisions != before.collisions;
+	if (hit or (after.slipLeft and !before.slipLeft) or (after.slipRight and !before.slipRight)) {
+		telemetry().log(Telemetry::contact, {hit ? after.impact : 0, float(after.slipLeft), float(after.slipRight)}, ireading.time);
+	}
+	contactPublished.write(after);
+}
+
+void TrackingOdometry::publish(std::uint32_t itime) {
+	const EkfState state = ekf.getState();
+	const float cosine = std::cos(state.theta), sine = std::sin(state.theta);
+	published.write({state.x, state.y, state.theta, state.velocityForward * cosine - state.velocitySideways * sine,
+	                 state.velocityForward * sine + state.velocitySideways * cosine, state.angularVelocity, itime});
+}
+
+OdomPose TrackingOdometry::getPose() const {
+	return published.read();
+}
+
+ContactState TrackingOdometry::getContact() const {
+	return contactPublished.read();
+}
+
+void TrackingOdometry::setPose(float ix, float iy, float itheta) {
+	if (!started) { // no task yet, so we're the only writer
+		ekf.setPose(ix, iy, itheta);
+		publish(pros::millis());
+		return;
+	}
+	OdomPose to{};
+	to.x = ix;
+	to.y = iy;
+	to.theta = itheta;
+	reset.write(to);
+	resetPending = true;
+	while (resetPending) pros::delay(1);
+}
+
+void TrackingOdometry::setLogging(bool ilogging) {
+	if (ilogging and !logging) {
+		const EkfNoise &noise = config.noise;
+		std::cout << pros::millis() << ": odom config " << config.cmPerTick << " " << config.leftOffset << " " << config.rightOffset << " " << config.strafeOffset << " "
+		          << config.driveCmPerTick << " " << config.driveOffset << " " << noise.acceleration << " " << noise.angularAcceleration << " " << noise.trackingWheel << " "
+		          << noise.driveWheel << " " << noise.imuHeading << " " << noise.gyro << " " << noise.gate << std::endl;
+	}
+	logging = ilogging;
+}
+
+float TrackingOdometry::benchmark(int iupdates) const {
+	PoseEkf test(config);
+	OdomReading reading{};
+	const std::uint32_t start = pros::millis();
+	for (int i = 0; i < iupdates; i++) {
+		// a gentle arc to the right so none of the terms are zero
+		reading.time += 10;
+		reading.left += 9;
+		reading.right += 7;
+		reading.strafe += i % 3 == 0;
+		reading.driveLeft += 13;
+		reading.driveRight += 10;
+		reading.rotation += 0.2;
+		reading.gyro = 20;
+		reading.accelX = 0.01;
+		reading.accelY = 0.03;
+		test.update(reading);
+	}
+	const std::uint32_t time = pros::millis() - start;
+	static volatile float sink; // so the compiler can't decide the loop did nothing
+	sink = test.getState().x;
+	(void)sink;
+	return time * 1000.0f / iupdates;
+}
@@ -1,6 +1,7 @@
 #include <fstream>
 #include "main.h"
 #include "korvexlib.h"
+#include "loopTimer.hpp"
 
 // chassis
 auto chassis = ChassisControllerBuilder()
@@ -85,6 +86,8 @@ void driveP(int voltageMax) {
   int same0ErrCycles = 0;
   int startTime = pros::millis();
 
+  LoopTimer timer(20, "driveP"); // runs the loop every 20ms on the dot
+
   while(autonomous){
     errorLeft = targetLeft - chassis->getModel()->getSensorVals()[0]; // error is target minus actual value
     errorRight = targetRight - chassis->getModel()->getSensorVals()[1];
@@ -135,6 +138,7 @@ void driveP(int voltageMax) {
 	if ((errorLast < 5 and errorCurrent < 5) or sameErrCycles >= 10) { // allowing for smol error or exit if we stay the same err for .2 second
 		chassis->stop();
 		std::cout << "task complete with error " << errorCurrent << " in " << (pros::millis() - startTime) << "ms" << std::endl;
+		timer.report();
 		return;
 	}
 	
@@ -147,7 +151,7 @@ void driveP(int voltageMax) {
 
 	// nothing goes after this
 	errorLast = errorCurrent;
-    pros::delay(20);
+    timer.wait();
   }
 }
 
@@ -181,6 +185,8 @@ void turnP(int voltageMax) {
   float error;
   int startTime = pros::millis();
 
+  LoopTimer timer(10, "turnP"); // runs the loop every 10ms on the dot
+
   while(autonomous){
     error = targetTurn - imu.get_rotation();
 	errorCurrent = abs(error);
@@ -189,12 +195,12 @@ void turnP(int voltageMax) {
 
 	p = (error * kp);
 	if (abs(error) < 10) { // if we are in range for I to be desireable
-        i = ((i + error) * ki);
+        i = ((i + error * timer.ticks()) * ki);
 	}
 	else
         i = 0;
 	// if ((abs(error) - errorLast) < 0)
-	d = (error - errorLast) * kd;
+	d = (error - errorLast) / timer.ticks() * kd;
 	
 	voltage = p + i + d;
 	voltageCap = voltageCap + acc;  // slew rate
@@ -226,6 +232,7 @@ void turnP(int voltageMax) {
 	if (same0ErrCycles >= 5 or sameErrCycles >= 60) { // allowing for smol error or exit if we stay the same err for .6 second
 		chassis->stop();
 		std::cout << "task complete with error " << errorCurrent << " in " << (pros::millis() - startTime) << "ms" << std::endl;
+		timer.report();
 		return;
 	}
 	
@@ -239,7 +246,7 @@ void turnP(int voltageMax) {
 	// nothing goes after this
 	errorLast = errorCurrent;
 	errorLastInt = errorLast;
-    pros::delay(10);
+    timer.wait();
   }
 }
 
@@ -0,0 +1,71 @@
+#pragma once
+#include <vector>
+#include "okapi/api/control/util/flywheelSimulator.hpp"
+
+// KorvexV2's flywheel on the host: the two blue motors in flywheelController, the v5 velocity loop,
+// the intake pushing balls up and each ball pulling the wheel down as it goes through
+// everything is at the motor shaft so rpm are what flywheelController.getActualVelocity() reads
+
+namespace sim {
+
+// the ball numbers are guesses until someone films a shot, change them here and rerun
+struct FlywheelConfig {
+	double inertia = 0.01; // kg m^2 of wheel and gearing seen at the motor
+	double staticFriction = 0.03; // N m
+	double dynamicFriction = 0.02; // N m
+	double battery = 12.6; // V
+	double ballInertia = 0.0035; // kg m^2, how heavy a ball looks to the motor while it's squeezed through
+	double ballGrip = 0.9; // fraction of the wheel speed the ball leaves with
+	double contactTime = 0.03; // s a ball touches the wheel
+	double feedSpeed = 1200; // deg/s, the intake at 200 rpm
+	double firstBall = 300; // deg of intake travel before the top ball touches the wheel
+	double ballGap = 1500; // deg of intake travel from the top ball to the bottom one
+};
+
+class Flywheel {
+	public:
+	// iballScale is how heavy each ball is compared to ballInertia, one per ball in the intake
+	Flywheel(const FlywheelConfig &iconfig, const std::vector<double> &iballScale);
+
+	// a copy carries on from the same moment, handy to branch a run after spin up
+	Flywheel(const Flywheel &iother);
+	Flywheel &operator=(const Flywheel &) = delete;
+
+	// like flywheelController.moveVelocity, rpm
+	void moveVelocity(double irpm);
+
+	double getActualVelocity() const; // rpm
+
+	// like intakeMotor.move_relative(ideg, 200)
+	void feed(double ideg);
+
+	// advance the sim by 1 ms
+	void step();
+
+	double time() const; // s since the flywheel was made
+
+	// the rpm the wheel was at when each ball touched it and when that was, in the order they went
+	struct Shot {
+		double rpm;
+		double time;
+	};
+	const std::vector<Shot> &shots() const;
+
+	protected:
+	// point the simulator's external torque at this flywheel's balls
+	void bindBalls();
+
+	FlywheelConfig config;
+	okapi::FlywheelSimulator wheel;
+	std::vector<double> ballScale;
+	std::vector<Shot> shotLog;
+	double target = 0; // rpm
+	double integral = 0; // mV
+	double intake = 0; // deg the intake has turned
+	double intakeTarget = 0; // deg
+	double ballTorque = 0; // N m the ball going through takes, while it's touching
+	double contactEnd = 0; // s
+	double now = 0; // s
+};
+
+} // namespace sim
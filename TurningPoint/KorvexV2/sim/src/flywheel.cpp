@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <cmath>
+#include "sim/flywheel.hpp"
+
+namespace sim {
+
+namespace {
+constexpr double dt = 0.001; // s
+constexpr int motors = 2;
+constexpr double stallTorque = 0.35; // N m per blue motor
+constexpr double freeSpeed = 600; // rpm
+
+double toRpm(double iomega) {
+	return iomega * 60 / (2 * M_PI);
+}
+} // namespace
+
+Flywheel::Flywheel(const FlywheelConfig &iconfig, const std::vector<double> &iballScale)
+	: config(iconfig), wheel(iconfig.inertia, 1, iconfig.staticFriction, iconfig.dynamicFriction, dt), ballScale(iballScale) {
+	wheel.setMaxTorque(motors * stallTorque);
+	bindBalls();
+}
+
+Flywheel::Flywheel(const Flywheel &iother)
+	: config(iother.config), wheel(iother.wheel), ballScale(iother.ballScale), shotLog(iother.shotLog), target(iother.target),
+	  integral(iother.integral), intake(iother.intake), intakeTarget(iother.intakeTarget), ballTorque(iother.ballTorque),
+	  contactEnd(iother.contactEnd), now(iother.now) {
+	bindBalls();
+}
+
+// no gravity on a wheel, just whatever ball is going through
+void Flywheel::bindBalls() {
+	wheel.setExternalTorqueFunction([this](double, double, double) { return now < contactEnd ? -ballTorque : 0; });
+}
+
+void Flywheel::moveVelocity(double irpm) {
+	target = std::max(-freeSpeed, std::min(freeSpeed, irpm));
+}
+
+double Flywheel::getActualVelocity() const {
+	return toRpm(wheel.getOmega());
+}
+
+void Flywheel::feed(double ideg) {
+	intakeTarget = intake + ideg;
+}
+
+// same velocity loop as the cedar sim's motors: feedforward, a strong p and a clamped i, in mV
+// the i only moves while the motors aren't maxed out, otherwise every spin up and every shot winds it up
+void Flywheel::step() {
+	const double kf = 12000 / freeSpeed;
+	const double error = target - getActualVelocity();
+	const double maxVoltage = config.battery * 1000;
+	const double request = kf * target + 2 * kf * error + integral;
+	if (std::abs(request) < maxVoltage) integral = std::max(-6000.0, std::min(6000.0, integral + 20 * kf * error * dt));
+	const double voltage = std::max(-maxVoltage, std::min(maxVoltage, request));
+	const double load = voltage / 12000 - getActualVelocity() / freeSpeed;
+	const double torque = motors * stallTorque * std::max(-1.0, std::min(1.0, load));
+
+	// the intake runs at full speed until it gets where it was told, the next ball goes when it reaches the wheel
+	intake += std::max(-config.feedSpeed * dt, std::min(config.feedSpeed * dt, intakeTarget - intake));
+	const std::size_t next = shotLog.size();
+	if (next < ballScale.size() && intake >= config.firstBall + next * config.ballGap) {
+		// the ball takes its share of the wheel's momentum over the contact time
+		const double omega = wheel.getOmega();
+		ballTorque = config.ballInertia * ballScale[next] * config.ballGrip * omega / config.contactTime;
+		contactEnd = now + config.contactTime;
+		shotLog.push_back({toRpm(omega), now});
+	}
+
+	wheel.step(torque);
+	now += dt;
+}
+
+double Flywheel::time() const {
+	return now;
+}
+
+const std::vector<Flywheel::Shot> &Flywheel::shots() const {
+	return shotLog;
+}
+
+} // namespace sim
@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <cmath>
+#include "okapi/api/control/util/flywheelSimulator.hpp"
+
+// host build of okapi's FlywheelSimulator, okapilib.a is arm only
+// a point mass on a link, gravity on the link unless the external torque function says otherwise
+
+namespace okapi {
+
+FlywheelSimulator::FlywheelSimulator(double imass, double ilinkLen, double imuStatic, double imuDynamic, double itimestep)
+	: mass(imass), linkLen(ilinkLen), muStatic(imuStatic), muDynamic(imuDynamic), timestep(itimestep),
+	  I(imass * ilinkLen * ilinkLen),
+	  torqueFunc([](double iangle, double imass, double ilinkLength) { return ilinkLength * std::cos(iangle) * imass * -9.80665; }) {
+}
+
+FlywheelSimulator::~FlywheelSimulator() = default;
+
+double FlywheelSimulator::step() {
+	return stepImpl();
+}
+
+double FlywheelSimulator::step(double itorque) {
+	setTorque(itorque);
+	return stepImpl();
+}
+
+double FlywheelSimulator::stepImpl() {
+	I = mass * linkLen * linkLen;
+	const double torque = inputTorque + torqueFunc(angle, mass, linkLen);
+	if (omega == 0 && std::abs(torque) <= muStatic) accel = 0;
+	else if (omega == 0) accel = (torque - std::copysign(muStatic, torque)) / I;
+	else accel = (torque - std::copysign(muDynamic, omega)) / I;
+
+	// friction can stop it but not spin it the other way
+	const double last = omega;
+	omega += accel * timestep;
+	if (last != 0 && (last > 0) != (omega > 0) && std::abs(torque) <= muDynamic) omega = 0;
+	angle += omega * timestep;
+	return angle;
+}
+
+void FlywheelSimulator::setExternalTorqueFunction(std::function<double(double, double, double)> itorqueFunc) {
+	torqueFunc = itorqueFunc;
+}
+
+void FlywheelSimulator::setTorque(double itorque) {
+	inputTorque = std::max(-maxTorque, std::min(maxTorque, itorque));
+}
+
+void FlywheelSimulator::setMaxTorque(double imaxTorque) {
+	maxTorque = std::abs(imaxTorque);
+}
+
+void FlywheelSimulator::setAngle(double iangle) {
+	angle = iangle;
+}
+
+void FlywheelSimulator::setMass(double imass) {
+	mass = imass;
+}
+
+void FlywheelSimulator::setLinkLength(double ilinkLen) {
+	linkLen = ilinkLen;
+}
+
+void FlywheelSimulator::setStaticFriction(double imuStatic) {
+	muStatic = imuStatic;
+}
+
+void FlywheelSimulator::setDynamicFriction(double imuDynamic) {
+	muDynamic = imuDynamic;
+}
+
+void FlywheelSimulator::setTimestep(double itimestep) {
+	timestep = std::max(minTimestep, itimestep);
+}
+
+double FlywheelSimulator::getAngle() const {
+	return angle;
+}
+
+double FlywheelSimulator::getOmega() const {
+	return omega;
+}
+
+double FlywheelSimulator::getAcceleration() const {
+	return accel;
+}
+
+double FlywheelSimulator::getMaxTorque() const {
+	return maxTorque;
+}
+
+} // namespace okapi
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#include "sim/flywheel.hpp"
+
+// sweeps the double shot from autonomous.cpp over flywheel targets and feed timing
+// usage: flysweep [--trials <n>] [--tolerance <rpm>] [--jobs <n>]
+// the sequence is the one the auton uses for the close flags:
+//   moveVelocity(first), wait until > high flag - 5, feed 1400, wait until <= second (300ms at most),
+//   moveVelocity(second), wait delay, feed 1200
+// a ball hits its flag if the wheel is within tolerance of that flag's FLY_PRESETS rpm when the ball touches it
+// each sequence gets the same trials (battery, ball weight, where the balls sit), reliable means every trial hit both
+
+namespace {
+
+// FLY_PRESETS in opcontrol.cpp, what each flag needs at each shooting position
+struct Position {
+	const char *name;
+	int high, mid; // rpm
+};
+const Position positions[] = {{"close", 580, 430}, {"full", 550, 510}};
+
+struct Sequence {
+	int first, second; // rpm
+	int delay; // ms
+};
+
+struct Outcome {
+	double spinUp = 0; // s from rest until the first ball is fed
+	double doubleShot = 0; // s from feeding the first ball to the second one touching the wheel
+	double rpm[2] = {}; // at each shot
+	bool shot = false; // both balls went
+};
+
+struct Summary {
+	Sequence sequence;
+	int hits = 0;
+	double spinUp = 0, doubleShot = 0; // s, means over the trials
+	double worst[2] = {}; // rpm furthest off each flag
+};
+
+// the same trial number always draws the same robot, so every sequence is tested on the same balls
+sim::Flywheel trialFlywheel(int itrial) {
+	std::mt19937 rng(itrial + 1);
+	std::normal_distribution<double> gaussian;
+	sim::FlywheelConfig config;
+	config.battery = std::uniform_real_distribution<double>(12.2, 12.8)(rng);
+	config.firstBall += 30 * gaussian(rng);
+	config.ballGap += 50 * gaussian(rng);
+	return sim::Flywheel(config, {1 + 0.1 * gaussian(rng), 1 + 0.1 * gaussian(rng)});
+}
+
+// step until icondition or itimeout s go by, checking every 20ms like the auton's loops
+template <typename T> void waitUntil(sim::Flywheel &iflywheel, T icondition, double itimeout) {
+	const double start = iflywheel.time();
+	while (!icondition() && iflywheel.time() - start < itimeout) {
+		for (int i = 0; i < 20; i++) iflywheel.step();
+	}
+}
+
+void wait(sim::Flywheel &iflywheel, double iseconds) {
+	const double end = iflywheel.time() + iseconds;
+	while (iflywheel.time() < end - 1e-9) iflywheel.step();
+}
+
+// spin up from rest until the first ball is fed, this part only depends on the first target so it's shared
+sim::Flywheel spinUp(const Position &iposition, int ifirst, int itrial) {
+	sim::Flywheel flywheel = trialFlywheel(itrial);
+	flywheel.moveVelocity(ifirst);
+	waitUntil(flywheel, [&] { return flywheel.getActualVelocity() > iposition.high - 5; }, 4);
+	return flywheel;
+}
+
+Outcome run(const Sequence &isequence, const sim::Flywheel &ispunUp) {
+	sim::Flywheel flywheel = ispunUp;
+	Outcome outcome;
+	const double fire = outcome.spinUp = flywheel.time();
+	flywheel.feed(1400);
+
+	const double hold = flywheel.time();
+	waitUntil(flywheel, [&] { return flywheel.getActualVelocity() <= isequence.second || flywheel.time() - hold > 0.3; }, 1);
+	flywheel.moveVelocity(isequence.second);
+	wait(flywheel, isequence.delay / 1000.0);
+	flywheel.feed(1200);
+	const double end = flywheel.time() + 2;
+	while (flywheel.shots().size() < 2 && flywheel.time() < end) flywheel.step();
+
+	const auto &shots = flywheel.shots();
+	outcome.shot = shots.size() == 2;
+	for (std::size_t i = 0; i < shots.size(); i++) outcome.rpm[i] = shots[i].rpm;
+	outcome.doubleShot = outcome.shot ? shots[1].time - fire : INFINITY;
+	return outcome;
+}
+
+// ispunUp is spinUp() for every trial at this sequence's first target
+Summary summarize(const Position &iposition, const Sequence &isequence, const std::vector<sim::Flywheel> &ispunUp, int itolerance) {
+	Summary summary;
+	summary.sequence = isequence;
+	const int trials = ispunUp.size();
+	for (int trial = 0; trial < trials; trial++) {
+		const Outcome outcome = run(isequence, ispunUp[trial]);
+		const double off[2] = {std::abs(outcome.rpm[0] - iposition.high), std::abs(outcome.rpm[1] - iposition.mid)};
+		summary.hits += outcome.shot && off[0] <= itolerance && off[1] <= itolerance;
+		summary.spinUp += outcome.spinUp / trials;
+		summary.doubleShot += outcome.doubleShot / trials;
+		for (int i = 0; i < 2; i++) summary.worst[i] = std::max(summary.worst[i], off[i]);
+	}
+	return summary;
+}
+
+// how long after a ball goes through at irpm until the wheel is back within 5 rpm, and how low it dips
+void recovery(int irpm, double &otime, double &odip) {
+	sim::Flywheel flywheel = trialFlywheel(0);
+	flywheel.moveVelocity(irpm);
+	wait(flywheel, 3);
+	flywheel.feed(1400);
+	while (flywheel.shots().empty()) flywheel.step();
+	const double shot = flywheel.time();
+	odip = irpm;
+	wait(flywheel, 0.05);
+	while (std::abs(flywheel.getActualVelocity() - irpm) > 5 && flywheel.time() - shot < 3) {
+		odip = std::min(odip, flywheel.getActualVelocity());
+		flywheel.step();
+	}
+	otime = flywheel.time() - shot;
+}
+
+void printSummary(const char *iname, const Summary &isummary, int itrials) {
+	std::printf("  %-9s %6d %6d %6dms %7.2fs %7.2fs %5.0f%% %6.0f %6.0f\n", iname, isummary.sequence.first,
+	            isummary.sequence.second, isummary.sequence.delay, isummary.spinUp, isummary.doubleShot,
+	            100.0 * isummary.hits / itrials, isummary.worst[0], isummary.worst[1]);
+}
+
+void usage() {
+	std::fprintf(stderr, "usage: flysweep [--trials <n>] [--tolerance <rpm>] [--jobs <n>]\n");
+	std::exit(2);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+	int trials = 30, tolerance = 10;
+	int jobs = std::max(1u, std::thread::hardware_concurrency());
+	for (int i = 1; i < argc; i++) {
+		if (!std::strcmp(argv[i], "--trials") && i + 1 < argc) trials = std::max(1, std::atoi(argv[++i]));
+		else if (!std::strcmp(argv[i], "--tolerance") && i + 1 < argc) tolerance = std::max(1, std::atoi(argv[++i]));
+		else if (!std::strcmp(argv[i], "--jobs") && i + 1 < argc) jobs = std::max(1, std::atoi(argv[++i]));
+		else usage();
+	}
+
+	for (auto &position : positions) {
+		std::printf("%s: high flag %d rpm, mid flag %d rpm, within %d rpm over %d trials\n", position.name, position.high,
+		            position.mid, tolerance, trials);
+		for (int rpm : {position.high, position.mid}) {
+			double time, dip;
+			recovery(rpm, time, dip);
+			std::printf("  a shot at %d dips to %.0f and is back within 5 rpm after %.0fms\n", rpm, dip, time * 1000);
+		}
+
+		std::vector<std::vector<sim::Flywheel>> spunUp; // [first target][trial]
+		std::vector<Sequence> sequences;
+		for (int first = position.high - 10; first <= 600; first += 5) {
+			spunUp.emplace_back();
+			for (int trial = 0; trial < trials; trial++) spunUp.back().push_back(spinUp(position, first, trial));
+			for (int second = position.mid - 100; second <= position.high; second += 10) {
+				for (int delay = 0; delay <= 800; delay += 50) sequences.push_back({first, second, delay});
+			}
+		}
+		auto trialsFor = [&](const Sequence &isequence) -> const std::vector<sim::Flywheel> & {
+			return spunUp[(isequence.first - (position.high - 10)) / 5];
+		};
+		std::vector<Summary> summaries(sequences.size());
+		std::atomic<std::size_t> next{0};
+		std::vector<std::thread> workers;
+		for (int j = 0; j < jobs; j++) {
+			workers.emplace_back([&] {
+				for (std::size_t n = next++; n < sequences.size(); n = next++) {
+					summaries[n] = summarize(position, sequences[n], trialsFor(sequences[n]), tolerance);
+				}
+			});
+		}
+		for (auto &worker : workers) worker.join();
+
+		// most reliable first, then fastest, then the shortest wait
+		std::stable_sort(summaries.begin(), summaries.end(), [](const Summary &a, const Summary &b) {
+			if (a.hits != b.hits) return a.hits > b.hits;
+			if (std::abs(a.doubleShot - b.doubleShot) > 1e-6) return a.doubleShot < b.doubleShot;
+			return a.sequence.delay < b.sequence.delay;
+		});
+		const auto reliable = std::count_if(summaries.begin(), summaries.end(), [&](const Summary &isummary) { return isummary.hits == trials; });
+
+		std::printf("\n  %-9s %6s %6s %8s %8s %8s %6s %6s %6s\n", "", "first", "second", "delay", "spin up", "2 shots", "hits", "off1", "off2");
+		// what the auton does now: the presets with the 400ms wait
+		printSummary("presets", summarize(position, {position.high, position.mid, 400}, trialsFor({position.high, 0, 0}), tolerance), trials);
+		for (std::size_t i = 0; i < std::min<std::size_t>(5, summaries.size()); i++) printSummary(i ? "" : "best", summaries[i], trials);
+		std::printf("  %ld of %zu sequences hit every time", reliable, summaries.size());
+		std::printf(", the second ball can't get there sooner than the intake brings it (%.2fs)\n\n",
+		            (sim::FlywheelConfig().firstBall + sim::FlywheelConfig().ballGap) / sim::FlywheelConfig().feedSpeed);
+	}
+	return 0;
+}